@@ -4,6 +4,7 @@
 #include "status_system.hpp"
 #include "world_init.hpp"
 #include "world_system.hpp"
+#include "profiler.hpp"
 
 AISystem::AISystem()
 {
@@ -25,15 +26,15 @@ void AISystem::step(float elapsed_ms)
 void AISystem::update_enemy_behaviors(float elapsed_ms)
 {
     // Skip if no player exists
-    if (registry.players.entities.empty())
+    if (registry().players.entities.empty())
     {
         return;
     }
 
     // Update each zombie
-    for (Entity entity : registry.enemies.entities)
+    for (Entity entity : registry().enemies.entities)
     {
-        if (registry.motions.has(entity))
+        if (registry().motions.has(entity))
         {
             // Update state if needed (for future use)
             // update_enemy_state(entity);
@@ -57,29 +58,29 @@ void AISystem::update_zombie_movement(Entity entity, float elapsed_ms)
 void AISystem::handle_chase_behavior(Entity entity, float elapsed_ms)
 
 {
-    if (!registry.zombies.has(entity))
+    if (!registry().zombies.has(entity))
     {
         return;
     }
-    Motion &motion = registry.motions.get(entity);
-    vec2 player_pos = registry.motions.get(registry.players.entities[0]).position;
+    Motion &motion = registry().motions.get(entity);
+    vec2 player_pos = registry().motions.get(registry().players.entities[0]).position;
 
     // Calculate direction to player
     vec2 direction = calculate_direction_to_target(motion.position, player_pos);
 
     // If entity has hit effect, reduce chase speed
-    Enemy &enemy = registry.enemies.get(entity);
+    Enemy &enemy = registry().enemies.get(entity);
     float current_speed = enemy.speed;
 
     // Slow effect
-    if (registry.slowEffects.has(entity))
+    if (registry().slowEffects.has(entity))
     {
-        Slow &slow = registry.slowEffects.get(entity);
+        Slow &slow = registry().slowEffects.get(entity);
         slow.timer_ms -= elapsed_ms;
         if (slow.timer_ms > 0)
             current_speed *= slow.value;
         else
-            registry.slowEffects.remove(entity);
+            registry().slowEffects.remove(entity);
     }
 
     // Add to velocity instead of overwriting
@@ -87,7 +88,7 @@ void AISystem::handle_chase_behavior(Entity entity, float elapsed_ms)
 
     // Optional: Add some drag to prevent infinite acceleration
     motion.velocity *= 0.9f; // Dampening factor
-    if (!registry.hitEffects.has(entity))
+    if (!registry().hitEffects.has(entity))
     {
         // Update facing direction based on total velocity
         if (motion.velocity.x < 0 && motion.scale.x > 0)
@@ -103,13 +104,13 @@ void AISystem::handle_chase_behavior(Entity entity, float elapsed_ms)
 
 void AISystem::update_enemy_melee_attack(Entity entity, float elapsed_ms)
 {
-    if (!registry.players.entities.size())
+    if (!registry().players.entities.size())
         return;
 
-    Entity player = registry.players.entities[0];
-    Attack &attack = registry.attacks.get(entity);
-    Motion &enemy_motion = registry.motions.get(entity);
-    Motion &player_motion = registry.motions.get(player);
+    Entity player = registry().players.entities[0];
+    Attack &attack = registry().attacks.get(entity);
+    Motion &enemy_motion = registry().motions.get(entity);
+    Motion &player_motion = registry().motions.get(player);
 
     attack.range = 40.0f; // Set attack range
 
@@ -117,11 +118,11 @@ void AISystem::update_enemy_melee_attack(Entity entity, float elapsed_ms)
     float distance = calculate_distance_to_target(enemy_motion.position, player_motion.position);
 
     // If in range and cooldown ready
-    if (distance <= attack.range && !registry.cooldowns.has(entity))
+    if (distance <= attack.range && !registry().cooldowns.has(entity))
     {
         Mix_PlayChannel(2, injured_sound, 0);
 
-        auto &status_comp = registry.statuses.get(player);
+        auto &status_comp = registry().statuses.get(player);
 
         // Add attack status
         Status attack_status{
@@ -132,7 +133,7 @@ void AISystem::update_enemy_melee_attack(Entity entity, float elapsed_ms)
         status_comp.active_statuses.push_back(attack_status);
 
         // Reset cooldown
-        Cooldown &cooldown = registry.cooldowns.emplace(entity);
+        Cooldown &cooldown = registry().cooldowns.emplace(entity);
         cooldown.timer_ms = COOLDOWN_ENEMY_ATTACK;
     }
 }
@@ -191,12 +192,12 @@ void AISystem::update_skeletons(float elapsed_ms)
     if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::TUTORIAL)
     {
         // For tutorial mode, process them differently
-        for (auto entity : registry.skeletons.entities)
+        for (auto entity : registry().skeletons.entities)
         {
-            if (registry.motions.has(entity))
+            if (registry().motions.has(entity))
             {
                 // Force velocity to zero, but still allow animations
-                Motion &skeleton_motion = registry.motions.get(entity);
+                Motion &skeleton_motion = registry().motions.get(entity);
                 skeleton_motion.velocity = vec2(0.0f, 0.0f);
 
                 if (skeleton_motion.scale.x > 0)
@@ -205,12 +206,12 @@ void AISystem::update_skeletons(float elapsed_ms)
                 }
 
                 // If skeleton is not already in attack animation and is not attacking
-                Skeleton &skeleton = registry.skeletons.get(entity);
+                Skeleton &skeleton = registry().skeletons.get(entity);
                 if (!skeleton.is_attacking && skeleton.current_state != Skeleton::State::ATTACK)
                 {
                     // Play idle animation
-                    if (!registry.animations.has(entity) ||
-                        registry.animations.get(entity).textures != SKELETON_IDLE_ANIMATION)
+                    if (!registry().animations.has(entity) ||
+                        registry().animations.get(entity).textures != SKELETON_IDLE_ANIMATION)
                     {
                         AnimationSystem::update_animation(
                             entity,
@@ -228,15 +229,15 @@ void AISystem::update_skeletons(float elapsed_ms)
         return; // Skip regular skeleton update for tutorial
     }
 
-    for (auto entity : registry.skeletons.entities)
+    for (auto entity : registry().skeletons.entities)
     {
-        if (!registry.motions.has(entity))
+        if (!registry().motions.has(entity))
         {
             continue;
         }
 
-        Skeleton &skeleton = registry.skeletons.get(entity);
-        Motion &skeleton_motion = registry.motions.get(entity);
+        Skeleton &skeleton = registry().skeletons.get(entity);
+        Motion &skeleton_motion = registry().motions.get(entity);
         // Check if skeleton is outside the map boundaries
         bool is_outside_map = (skeleton_motion.position.x < 0 ||
                                skeleton_motion.position.x > MAP_WIDTH_PX ||
@@ -291,9 +292,9 @@ void AISystem::update_skeletons(float elapsed_ms)
                 if (skeleton.attack_timer_ms <= 300 && !skeleton.arrow_fired)
                 {
                     // Fire arrow directly here, not waiting for animation end
-                    if (registry.motions.has(skeleton.target))
+                    if (registry().motions.has(skeleton.target))
                     {
-                        Motion &target_motion = registry.motions.get(skeleton.target);
+                        Motion &target_motion = registry().motions.get(skeleton.target);
                         vec2 direction = target_motion.position - skeleton_motion.position;
 
                         if (direction.x != 0)
@@ -325,17 +326,17 @@ void AISystem::update_skeletons(float elapsed_ms)
         }
 
         // Target search and evaluation
-        Entity nearest_tower = Entity();
+        Entity nearest_tower = Entity::null();
         float closest_tower_dist = std::numeric_limits<float>::max();
 
-        if (!registry.towers.entities.empty())
+        if (!registry().towers.entities.empty())
         {
-            for (auto tower : registry.towers.entities)
+            for (auto tower : registry().towers.entities)
             {
-                if (!registry.motions.has(tower))
+                if (!registry().motions.has(tower))
                     continue;
 
-                vec2 tower_pos = registry.motions.get(tower).position;
+                vec2 tower_pos = registry().motions.get(tower).position;
                 float dist = calculate_distance_to_target(skeleton_motion.position, tower_pos);
 
                 if (dist < closest_tower_dist)
@@ -347,9 +348,9 @@ void AISystem::update_skeletons(float elapsed_ms)
 
             skeleton.target = nearest_tower;
         }
-        else if (!registry.players.entities.empty())
+        else if (!registry().players.entities.empty())
         {
-            skeleton.target = registry.players.entities[0];
+            skeleton.target = registry().players.entities[0];
         }
         else
         {
@@ -360,13 +361,13 @@ void AISystem::update_skeletons(float elapsed_ms)
         }
 
         // Ensure target still has motion component
-        if (!registry.motions.has(skeleton.target))
+        if (!registry().motions.has(skeleton.target))
         {
-            skeleton.target = {};
+            skeleton.target = Entity::null();
             continue;
         }
 
-        Motion &target_motion = registry.motions.get(skeleton.target);
+        Motion &target_motion = registry().motions.get(skeleton.target);
 
         // Calculate distance and direaction to target
         vec2 direction = target_motion.position - skeleton_motion.position;
@@ -414,7 +415,7 @@ void AISystem::update_skeletons(float elapsed_ms)
             }
             // If we're in attack range but between attacks and have no animation,
             // use the walk animation as a fallback (no IDLE state in playing mode)
-            else if (!skeleton.is_attacking && !registry.animations.has(entity))
+            else if (!skeleton.is_attacking && !registry().animations.has(entity))
             {
                 // Use WALK animation between attacks (not IDLE)
                 AnimationSystem::update_animation(
@@ -431,11 +432,11 @@ void AISystem::update_skeletons(float elapsed_ms)
 
         // Handle animation changes when state changes
         if (prev_state != skeleton.current_state ||
-            (skeleton.current_state == Skeleton::State::ATTACK && skeleton.is_attacking && !registry.animations.has(entity)))
+            (skeleton.current_state == Skeleton::State::ATTACK && skeleton.is_attacking && !registry().animations.has(entity)))
         {
             bool currently_attacking = skeleton.is_attacking &&
-                                       registry.animations.has(entity) &&
-                                       registry.animations.get(entity).textures == SKELETON_ATTACK_ANIMATION;
+                                       registry().animations.has(entity) &&
+                                       registry().animations.get(entity).textures == SKELETON_ATTACK_ANIMATION;
             if (!currently_attacking)
             {
                 switch (skeleton.current_state)
@@ -490,31 +491,31 @@ void AISystem::update_skeletons(float elapsed_ms)
 void AISystem::update_orcriders(float elapsed_ms)
 {
     // Skip if no player exists
-    if (registry.players.entities.empty())
+    if (registry().players.entities.empty())
     {
         return;
     }
 
-    Entity player = registry.players.entities[0];
-    if (!registry.motions.has(player))
+    Entity player = registry().players.entities[0];
+    if (!registry().motions.has(player))
     {
         return;
     }
 
-    vec2 player_pos = registry.motions.get(player).position;
+    vec2 player_pos = registry().motions.get(player).position;
 
-    for (auto entity : registry.orcRiders.entities)
+    for (auto entity : registry().orcRiders.entities)
     {
-        if (!registry.motions.has(entity))
+        if (!registry().motions.has(entity))
         {
             continue;
         }
 
         // Skip OrcRiders that are part of a squad - they're handled separately
         bool is_squad_knight = false;
-        for (auto squad_entity : registry.squads.entities)
+        for (auto squad_entity : registry().squads.entities)
         {
-            Squad &squad = registry.squads.get(squad_entity);
+            Squad &squad = registry().squads.get(squad_entity);
             if (squad.is_active)
             {
                 // More robust check for squad knights
@@ -538,8 +539,8 @@ void AISystem::update_orcriders(float elapsed_ms)
         }
 
         // Rest of the normal OrcRider update code
-        OrcRider &orcrider = registry.orcRiders.get(entity);
-        Motion &motion = registry.motions.get(entity);
+        OrcRider &orcrider = registry().orcRiders.get(entity);
+        Motion &motion = registry().motions.get(entity);
 
         // Previous state for detecting state changes
         OrcRider::State prev_state = orcrider.current_state;
@@ -565,13 +566,13 @@ void AISystem::update_orcriders(float elapsed_ms)
                 orcrider.has_hit_player = true;
 
                 // Apply damage to player
-                if (registry.statuses.has(player))
+                if (registry().statuses.has(player))
                 {
                     Status attack_status{
                         "attack",
                         0.0f,
                         static_cast<float>(orcrider.damage)};
-                    registry.statuses.get(player).active_statuses.push_back(attack_status);
+                    registry().statuses.get(player).active_statuses.push_back(attack_status);
 
                     // Play hit sound
                     Mix_PlayChannel(2, injured_sound, 0);
@@ -731,18 +732,19 @@ void AISystem::update_orcriders(float elapsed_ms)
 
 void AISystem::update_squads(float elapsed_ms)
 {
+    PROFILE_SCOPE("update_squads");
     // Skip if no player exists
-    if (registry.players.entities.empty())
+    if (registry().players.entities.empty())
         return;
 
-    Entity player = registry.players.entities[0];
-    if (!registry.motions.has(player))
+    Entity player = registry().players.entities[0];
+    if (!registry().motions.has(player))
         return;
 
     // Process each squad
-    for (auto &squad_entity : registry.squads.entities)
+    for (auto &squad_entity : registry().squads.entities)
     {
-        Squad &squad = registry.squads.get(squad_entity);
+        Squad &squad = registry().squads.get(squad_entity);
 
         if (!squad.is_active)
             continue;
@@ -750,7 +752,7 @@ void AISystem::update_squads(float elapsed_ms)
         // Clean up fallen squad members
         for (auto it = squad.archers.begin(); it != squad.archers.end();)
         {
-            if (!registry.motions.has(*it))
+            if (!registry().motions.has(*it))
                 it = squad.archers.erase(it);
             else
                 ++it;
@@ -758,7 +760,7 @@ void AISystem::update_squads(float elapsed_ms)
 
         for (auto it = squad.orcs.begin(); it != squad.orcs.end();)
         {
-            if (!registry.motions.has(*it))
+            if (!registry().motions.has(*it))
                 it = squad.orcs.erase(it);
             else
                 ++it;
@@ -766,7 +768,7 @@ void AISystem::update_squads(float elapsed_ms)
 
         for (auto it = squad.knights.begin(); it != squad.knights.end();)
         {
-            if (!registry.motions.has(*it))
+            if (!registry().motions.has(*it))
                 it = squad.knights.erase(it);
             else
                 ++it;
@@ -792,7 +794,7 @@ void AISystem::update_squads(float elapsed_ms)
 
 void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, Entity player)
 {
-    vec2 player_pos = registry.motions.get(player).position;
+    vec2 player_pos = registry().motions.get(player).position;
 
     // Store the previous player position if not yet stored
     if (length(squad.last_player_pos) < 0.1f)
@@ -834,11 +836,11 @@ void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, En
     for (size_t i = 0; i < squad.archers.size(); i++)
     {
         Entity archer = squad.archers[i];
-        if (!registry.motions.has(archer) || !registry.skeletons.has(archer))
+        if (!registry().motions.has(archer) || !registry().skeletons.has(archer))
             continue;
 
-        Skeleton &skeleton = registry.skeletons.get(archer);
-        Motion &motion = registry.motions.get(archer);
+        Skeleton &skeleton = registry().skeletons.get(archer);
+        Motion &motion = registry().motions.get(archer);
 
         // Previous state for detecting state changes
         Skeleton::State prev_state = skeleton.current_state;
@@ -926,8 +928,8 @@ void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, En
                 motion.scale.x = (to_target.x > 0) ? abs(motion.scale.x) : -abs(motion.scale.x);
 
             // Ensure walk animation is playing when moving
-            if (!registry.animations.has(archer) ||
-                registry.animations.get(archer).textures != SKELETON_WALK_ANIMATION)
+            if (!registry().animations.has(archer) ||
+                registry().animations.get(archer).textures != SKELETON_WALK_ANIMATION)
             {
                 AnimationSystem::update_animation(
                     archer,
@@ -980,8 +982,8 @@ void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, En
                 skeleton.current_state = Skeleton::State::WALK;
 
                 // Make sure we have the proper walking animation
-                if (!registry.animations.has(archer) ||
-                    registry.animations.get(archer).textures != SKELETON_WALK_ANIMATION)
+                if (!registry().animations.has(archer) ||
+                    registry().animations.get(archer).textures != SKELETON_WALK_ANIMATION)
                 {
                     AnimationSystem::update_animation(
                         archer,
@@ -999,7 +1001,7 @@ void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, En
         // Handle animation changes
         if (prev_state != skeleton.current_state &&
             !(skeleton.current_state == Skeleton::State::ATTACK &&
-              skeleton.is_attacking && registry.animations.has(archer)))
+              skeleton.is_attacking && registry().animations.has(archer)))
         {
             switch (skeleton.current_state)
             {
@@ -1031,7 +1033,7 @@ void AISystem::update_archer_circle_formation(Squad &squad, float elapsed_ms, En
 
 void AISystem::update_orc_protection(Squad &squad, float elapsed_ms, Entity player)
 {
-    vec2 player_pos = registry.motions.get(player).position;
+    vec2 player_pos = registry().motions.get(player).position;
 
     // Each orc protects a specific archer (1:1 relationship)
     for (size_t i = 0; i < squad.orcs.size() && i < squad.archers.size(); i++)
@@ -1039,11 +1041,11 @@ void AISystem::update_orc_protection(Squad &squad, float elapsed_ms, Entity play
         Entity orc = squad.orcs[i];
         Entity archer = squad.archers[i];
 
-        if (!registry.motions.has(orc) || !registry.motions.has(archer))
+        if (!registry().motions.has(orc) || !registry().motions.has(archer))
             continue;
 
-        Motion &orc_motion = registry.motions.get(orc);
-        Motion &archer_motion = registry.motions.get(archer);
+        Motion &orc_motion = registry().motions.get(orc);
+        Motion &archer_motion = registry().motions.get(archer);
 
         // Calculate vector from archer to player
         vec2 archer_to_player = player_pos - archer_motion.position;
@@ -1091,13 +1093,13 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
 
     // Get the first (and only) knight
     Entity knight = squad.knights[0];
-    if (!registry.motions.has(knight) || !registry.orcRiders.has(knight))
+    if (!registry().motions.has(knight) || !registry().orcRiders.has(knight))
         return;
 
-    OrcRider &rider = registry.orcRiders.get(knight);
-    Motion &motion = registry.motions.get(knight);
+    OrcRider &rider = registry().orcRiders.get(knight);
+    Motion &motion = registry().motions.get(knight);
 
-    vec2 player_pos = registry.motions.get(player).position;
+    vec2 player_pos = registry().motions.get(player).position;
 
     // Handle hunting and charging states similar to update_orcriders
     if (rider.is_charging)
@@ -1117,13 +1119,13 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
             rider.has_hit_player = true;
 
             // Apply damage to player
-            if (registry.statuses.has(player))
+            if (registry().statuses.has(player))
             {
                 Status attack_status{
                     "attack",
                     0.0f,
                     static_cast<float>(rider.damage)};
-                registry.statuses.get(player).active_statuses.push_back(attack_status);
+                registry().statuses.get(player).active_statuses.push_back(attack_status);
 
                 // Play hit sound
                 Mix_PlayChannel(2, injured_sound, 0);
@@ -1193,16 +1195,16 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
 
     // Check if player is threatening any squad members (archers or orcs)
     bool player_threatening = false;
-    Entity threatened_ally;
+    Entity threatened_ally = Entity::null();
     float closest_ally_dist = 1000000.0f;
 
     // Check archers first
     for (auto archer : squad.archers)
     {
-        if (!registry.motions.has(archer))
+        if (!registry().motions.has(archer))
             continue;
 
-        vec2 archer_pos = registry.motions.get(archer).position;
+        vec2 archer_pos = registry().motions.get(archer).position;
         float dist = length(player_pos - archer_pos);
 
         if (dist < closest_ally_dist)
@@ -1225,10 +1227,10 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
     {
         for (auto orc : squad.orcs)
         {
-            if (!registry.motions.has(orc) || orc == knight) // Skip self
+            if (!registry().motions.has(orc) || orc == knight) // Skip self
                 continue;
 
-            vec2 orc_pos = registry.motions.get(orc).position;
+            vec2 orc_pos = registry().motions.get(orc).position;
             float dist = length(player_pos - orc_pos);
 
             if (dist < closest_ally_dist)
@@ -1255,7 +1257,7 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
     }
 
     // HUNTING & CHARGING: If player is threatening allies and cooldown is over
-    if (player_threatening && registry.motions.has(threatened_ally) && rider.hunt_timer_ms <= 0)
+    if (player_threatening && registry().motions.has(threatened_ally) && rider.hunt_timer_ms <= 0)
     {
         // Start hunting immediately (same as ordinary OrcRiders)
         rider.current_state = OrcRider::State::HUNT;
@@ -1292,18 +1294,18 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
 
         for (auto archer : squad.archers)
         {
-            if (registry.motions.has(archer))
+            if (registry().motions.has(archer))
             {
-                squad_center += registry.motions.get(archer).position;
+                squad_center += registry().motions.get(archer).position;
                 valid_squad_members++;
             }
         }
 
         for (auto orc : squad.orcs)
         {
-            if (registry.motions.has(orc) && orc != knight) // Don't include self in calculation
+            if (registry().motions.has(orc) && orc != knight) // Don't include self in calculation
             {
-                squad_center += registry.motions.get(orc).position;
+                squad_center += registry().motions.get(orc).position;
                 valid_squad_members++;
             }
         }
@@ -1336,9 +1338,9 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
 
             for (auto archer : squad.archers)
             {
-                if (registry.motions.has(archer))
+                if (registry().motions.has(archer))
                 {
-                    vec2 archer_pos = registry.motions.get(archer).position;
+                    vec2 archer_pos = registry().motions.get(archer).position;
                     vec2 to_archer = motion.position - archer_pos;
                     float dist = length(to_archer);
 
@@ -1352,9 +1354,9 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
 
             for (auto orc : squad.orcs)
             {
-                if (registry.motions.has(orc) && orc != knight)
+                if (registry().motions.has(orc) && orc != knight)
                 {
-                    vec2 orc_pos = registry.motions.get(orc).position;
+                    vec2 orc_pos = registry().motions.get(orc).position;
                     vec2 to_orc = motion.position - orc_pos;
                     float dist = length(to_orc);
 
@@ -1384,8 +1386,8 @@ void AISystem::update_knight_herding(Squad &squad, float elapsed_ms, Entity play
             rider.current_state = OrcRider::State::WALK;
 
             // Ensure walk animation is playing
-            if (!registry.animations.has(knight) ||
-                registry.animations.get(knight).textures != ORCRIDER_WALK_ANIMATION)
+            if (!registry().animations.has(knight) ||
+                registry().animations.get(knight).textures != ORCRIDER_WALK_ANIMATION)
             {
                 AnimationSystem::update_animation(
                     knight,
@@ -1,27 +1,50 @@
 // In status_system.cpp
 #include "animation_system.hpp"
 #include "world_init.hpp"
+#include "world.hpp"
 #include <iostream>
 
-RenderSystem *AnimationSystem::renderer;
-
-void AnimationSystem::init(RenderSystem *renderer_arg)
-{
-    renderer = renderer_arg;
-}
-
 /**
  * Update the texture of each animation component.
  *
+ * Under load (see QualitySettings) looping animations off screen only advance on every n-th
+ * update, by n updates' worth of time; animations that end still run every update, their end
+ * destroys or spawns entities.
+ *
  * @param elapsed_ms The change in time (milliseconds).
  */
 void AnimationSystem::step(float elapsed_ms)
 {
-    for (Entity entity : registry.animations.entities)
+    const unsigned int interval = (unsigned int)world().quality.offscreen_animation_interval;
+    const unsigned int update_count = ++world().animation_updates;
+    bool throttle = interval > 1 && registry().cameras.size() > 0;
+    vec2 view_center = {0.f, 0.f};
+    vec2 view_half_size = {0.f, 0.f};
+    if (throttle)
+    {
+        const Camera &camera = registry().cameras.components[0];
+        view_center = camera.position;
+        view_half_size = vec2(camera.camera_width, camera.camera_height) / 2.f;
+    }
+
+    registry().view<Animation, RenderRequest>().use<Animation>().each([&](Entity entity, Animation &animation, RenderRequest &request)
     {
-        Animation &animation = registry.animations.get(entity);
-        animation.runtime_ms += elapsed_ms;
-        animation.timer_ms += elapsed_ms;
+        float animation_ms = elapsed_ms;
+        if (throttle && animation.loop && !registry().moveWithCameras.has(entity) && registry().motions.has(entity))
+        {
+            const Motion &motion = registry().motions.get(entity);
+            vec2 distance = abs(motion.position - view_center) - abs(motion.scale) / 2.f;
+            if (distance.x > view_half_size.x || distance.y > view_half_size.y)
+            {
+                // entities take turns, so the work is spread over the updates
+                if ((update_count + entity.index()) % interval != 0)
+                    return;
+                animation_ms = elapsed_ms * interval;
+            }
+        }
+
+        animation.runtime_ms += animation_ms;
+        animation.timer_ms += animation_ms;
         if (animation.timer_ms >= animation.transition_ms)
         {
             animation.pose += 1;
@@ -30,16 +53,21 @@ void AnimationSystem::step(float elapsed_ms)
                 if (!animation.loop)
                 {
                     handle_animation_end(entity);
-                    break;
+                    return;
                 }
                 animation.pose = 0;
             }
-            RenderRequest &request = registry.renderRequests.get(entity);
             if (animation.textures != NULL)
+            {
                 request.used_texture = animation.textures[animation.pose];
+                registry().renderRequests.mark_changed(entity);
+            }
             animation.timer_ms = 0;
         }
-    }
+    });
+
+    // sync point: apply the removals recorded by handle_animation_end
+    registry().flush_deferred();
 }
 
 /**
@@ -55,49 +83,49 @@ void AnimationSystem::step(float elapsed_ms)
  */
 void AnimationSystem::update_animation(Entity entity, int duration, const TEXTURE_ASSET_ID *textures, int textures_size, bool loop, bool lock, bool destroy)
 {
-    if (registry.animations.has(entity) && registry.animations.get(entity).lock)
+    if (registry().animations.has(entity) && registry().animations.get(entity).lock)
     {
         //
     }
     else
     {
-        if (registry.animations.has(entity))
+        if (registry().animations.has(entity))
         {
-            registry.animations.remove(entity);
+            registry().animations.remove(entity);
         }
-        Animation &animation = registry.animations.emplace(entity);
+        Animation &animation = registry().animations.emplace(entity);
         animation.transition_ms = duration / textures_size;
         animation.pose_count = textures_size;
         animation.textures = textures;
         animation.loop = loop;
         animation.lock = lock;
         animation.destroy = destroy;
-        RenderRequest &request = registry.renderRequests.get(entity);
+        RenderRequest &request = registry().renderRequests.modify(entity);
         request.used_texture = textures[0];
     }
 }
 
 void AnimationSystem::handle_animation_end(Entity entity)
 {
-    Animation &animation = registry.animations.get(entity);
+    Animation &animation = registry().animations.get(entity);
 
     // std::cout << "Animation ended for entity " << entity << std::endl;
 
-    // Handle zombie spawn
-    if (registry.zombieSpawns.has(entity))
-    {
-        Motion &motion = registry.motions.get(entity);
-        createOrc(renderer, motion.position);
-    }
-
     // If animation was set to destroy entity when done
     if (animation.destroy)
     {
-        registry.remove_all_components_of(entity);
+        registry().deferred.destroy(entity);
     }
     else if (!animation.loop)
     {
         // If not looping and not destroying, remove the animation component
-        registry.animations.remove(entity);
+        registry().deferred.remove(registry().animations, entity);
+    }
+
+    // Handle zombie spawn (last, creating the orc grows the containers and moves the components above)
+    if (registry().zombieSpawns.has(entity))
+    {
+        Motion &motion = registry().motions.get(entity);
+        createOrc(world().renderer, motion.position);
     }
 }
\ No newline at end of file
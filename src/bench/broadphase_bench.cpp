@@ -0,0 +1,111 @@
+// Entry point of broadphase_bench: times PhysicsSystem's body collisions (see broadphase.hpp) on a
+// crowd far larger than the game's, to check the sweep-and-prune keeps up with it.
+//
+//   broadphase_bench [--bodies N] [--steps N] [--seed N]
+//
+// Places N enemies (default 5000) of the game's size at random in a square with room for about
+// four times as many, each walking in a random direction and turning back at the edges, and runs
+// the body collisions of N physics steps (default 600, ten seconds of game time) on them. Prints
+// the time of the first step, which sorts every body from scratch, and the distribution of the
+// others, with how many pairs the sweep found and how many of them collided.
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// internal
+#include "broadphase.hpp"
+#include "motion_kernels.hpp"
+#include "random.hpp"
+#include "telemetry.hpp"
+#include "world.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+int main(int argc, char *argv[])
+{
+	int body_count = 5000;
+	int steps = 600;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--bodies") && has_value)
+			body_count = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--steps") && has_value)
+			steps = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--bodies N] [--steps N] [--seed N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	World world;
+	World::Scope scope(world);
+	Rng random(seed);
+	const float side = std::sqrt((float)body_count) * 2 * ENEMY_WIDTH;
+	for (int i = 0; i < body_count; i++)
+	{
+		Entity entity;
+		registry().enemies.emplace(entity);
+		Motion &motion = registry().motions.emplace(entity);
+		motion.position = {random.uniform(0, side), random.uniform(0, side)};
+		float angle = random.uniform(0, 2 * M_PI);
+		motion.velocity = vec2(std::cos(angle), std::sin(angle)) * random.uniform(40, 80);
+		motion.scale = {ENEMY_WIDTH, ENEMY_HEIGHT};
+	}
+
+	const float step_ms = 1000.f / 60.f;
+	BodyCollisions body_collisions;
+	LatencyHistogram step_times;
+	double first_step_ms = 0;
+	uint64_t pairs = 0;
+	uint64_t collisions = 0;
+	uint64_t swaps = 0;
+	ComponentContainer<Motion> &motions = registry().motions;
+	for (int step = 0; step < steps; step++)
+	{
+		integrate_motions(motions.components.data(), motions.size(), step_ms / 1000.f);
+		for (Motion &motion : motions.components)
+		{
+			if ((motion.position.x < 0 && motion.velocity.x < 0) || (motion.position.x > side && motion.velocity.x > 0))
+				motion.velocity.x = -motion.velocity.x;
+			if ((motion.position.y < 0 && motion.velocity.y < 0) || (motion.position.y > side && motion.velocity.y > 0))
+				motion.velocity.y = -motion.velocity.y;
+		}
+
+		auto start = Clock::now();
+		body_collisions.step(step_ms);
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (step == 0)
+		{
+			first_step_ms = ms;
+			continue;
+		}
+		step_times.record(ms);
+		pairs += body_collisions.get_broadphase().get_pairs().size();
+		collisions += body_collisions.get_collision_count();
+		swaps += body_collisions.get_broadphase().get_last_swaps();
+	}
+
+	uint64_t measured = std::max<uint64_t>(1, step_times.count());
+	std::cout << std::fixed << std::setprecision(0) << "broadphase_bench: " << body_count << " bodies, " << steps
+			  << " steps" << std::endl;
+	std::cout << "first step (sorting from scratch): " << first_step_ms * 1000 << " us" << std::endl;
+	std::cout << "per step: p50 " << step_times.percentile_ms(50) * 1000 << " us, p95 " << step_times.percentile_ms(95) * 1000
+			  << " us, p99 " << step_times.percentile_ms(99) * 1000 << " us, max " << step_times.max_ms() * 1000
+			  << " us, mean " << step_times.mean_ms() * 1000 << " us" << std::endl;
+	std::cout << std::setprecision(1) << "per step: " << (double)pairs / measured << " pairs, "
+			  << (double)collisions / measured << " collisions, " << (double)swaps / measured << " insertion sort moves"
+			  << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+// Entry point of container_bench: times ComponentContainer::get and has (see tinyECS/tiny_ecs.hpp)
+// against the hash map index the containers used before the paged sparse set.
+//
+//   container_bench [--entities N] [--rounds N] [--seed N]
+//
+// Gives every other one of N entities (default 20000) a Motion, in both containers, then looks up
+// all N entities in a random order, N rounds (default 200) over: has() on every entity, get() on
+// the ones that have a component, and the has() + get() pair the systems use. Prints the mean time
+// per lookup of each and the speedup of the sparse set.
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// internal
+#include "random.hpp"
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+	// The lookups of the container before the sparse set: one hash for has(), two for get()
+	struct HashedContainer
+	{
+		std::unordered_map<unsigned int, unsigned int> map_entity_componentID;
+		std::vector<Motion> components;
+
+		void insert(Entity e, Motion c)
+		{
+			map_entity_componentID[e.id()] = (unsigned int)components.size();
+			components.push_back(c);
+		}
+		bool has(Entity e) { return map_entity_componentID.count(e.id()) > 0; }
+		Motion &get(Entity e)
+		{
+			if (!has(e))
+				std::abort();
+			return components[map_entity_componentID[e.id()]];
+		}
+	};
+
+	struct Timings
+	{
+		double has_ns = 0;
+		double get_ns = 0;
+		double has_get_ns = 0;
+	};
+
+	// Runs the three lookup patterns over lookups, rounds times, in nanoseconds per lookup.
+	// checksum keeps the compiler from dropping the lookups
+	template <typename Container>
+	Timings time_lookups(Container &container, const std::vector<Entity> &lookups,
+						 const std::vector<Entity> &present, int rounds, float &checksum)
+	{
+		Timings timings;
+		auto start = Clock::now();
+		size_t found = 0;
+		for (int round = 0; round < rounds; round++)
+			for (Entity e : lookups)
+				found += container.has(e);
+		timings.has_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double)rounds * lookups.size());
+		checksum += (float)found;
+
+		start = Clock::now();
+		for (int round = 0; round < rounds; round++)
+			for (Entity e : present)
+				checksum += container.get(e).position.x;
+		timings.get_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double)rounds * present.size());
+
+		start = Clock::now();
+		for (int round = 0; round < rounds; round++)
+			for (Entity e : lookups)
+				if (container.has(e))
+					checksum += container.get(e).position.y;
+		timings.has_get_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double)rounds * lookups.size());
+		return timings;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int entity_count = 20000;
+	int rounds = 200;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--entities") && has_value)
+			entity_count = std::max(2, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--rounds") && has_value)
+			rounds = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--entities N] [--rounds N] [--seed N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	Rng random(seed);
+	ComponentContainer<Motion> sparse_set;
+	HashedContainer hashed;
+	std::vector<Entity> lookups;
+	std::vector<Entity> present;
+	// index 0 is the null entity
+	for (int i = 1; i <= entity_count; i++)
+	{
+		Entity e(i);
+		lookups.push_back(e);
+		if (i % 2 == 0)
+			continue;
+		Motion motion;
+		motion.position = {random.uniform(0, 1000), random.uniform(0, 1000)};
+		sparse_set.insert(e, motion);
+		hashed.insert(e, motion);
+		present.push_back(e);
+	}
+	// the systems look entities up in the order of some other container, not in slot order
+	for (size_t i = lookups.size(); i-- > 1;)
+		std::swap(lookups[i], lookups[random.below((uint32_t)i + 1)]);
+	for (size_t i = present.size(); i-- > 1;)
+		std::swap(present[i], present[random.below((uint32_t)i + 1)]);
+
+	float checksum = 0;
+	Timings hash_times = time_lookups(hashed, lookups, present, rounds, checksum);
+	Timings sparse_times = time_lookups(sparse_set, lookups, present, rounds, checksum);
+
+	std::cout << std::fixed << std::setprecision(2) << "container_bench: " << entity_count << " entities, "
+			  << present.size() << " with a component, " << rounds << " rounds (checksum " << checksum << ")" << std::endl;
+	std::cout << "            hash map    sparse set   speedup" << std::endl;
+	auto print_row = [](const char *name, double hash_ns, double sparse_ns) {
+		std::cout << std::left << std::setw(10) << name << std::right << std::setw(8) << hash_ns << " ns" << std::setw(11)
+				  << sparse_ns << " ns" << std::setw(9) << hash_ns / sparse_ns << "x" << std::endl;
+	};
+	print_row("has", hash_times.has_ns, sparse_times.has_ns);
+	print_row("get", hash_times.get_ns, sparse_times.get_ns);
+	print_row("has+get", hash_times.has_get_ns, sparse_times.has_get_ns);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+// Entry point of motion_bench: times the motion kernels (see motion_kernels.hpp) the way
+// PhysicsSystem::step runs them, on the whole registry().motions container.
+//
+//   motion_bench [--bodies N] [--rounds N] [--seed N]
+//
+// Creates N projectiles (default 20000) spread over and around the map, then times, over N rounds
+// (default 200):
+//   integrate   integrate_motions over every Motion
+//   bounds      the out of bounds test of every projectile, as the view over them visits it
+// Prints the median time of one pass of each.
+//
+// The bounds test used to gather the positions into arrays for a SIMD kernel. With the gather
+// counted, that was no faster than testing each Motion in place, so the kernel is gone.
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// internal
+#include "motion_kernels.hpp"
+#include "random.hpp"
+#include "telemetry.hpp"
+#include "world.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+	// Median time of rounds calls of pass, in microseconds
+	template <typename Pass>
+	double time_pass(int rounds, Pass pass)
+	{
+		LatencyHistogram times;
+		for (int round = 0; round < rounds; round++)
+		{
+			auto start = Clock::now();
+			pass();
+			times.record(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+		return times.percentile_ms(50) * 1000;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int body_count = 20000;
+	int rounds = 200;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--bodies") && has_value)
+			body_count = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--rounds") && has_value)
+			rounds = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--bodies N] [--rounds N] [--seed N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	World world;
+	World::Scope scope(world);
+	Rng random(seed);
+	for (int i = 0; i < body_count; i++)
+	{
+		Entity entity;
+		registry().projectiles.emplace(entity);
+		Motion &motion = registry().motions.emplace(entity);
+		motion.position = {random.uniform(-1000, MAP_WIDTH_PX + 1000), random.uniform(-1000, MAP_HEIGHT_PX + 1000)};
+		motion.velocity = {random.uniform(-300, 300), random.uniform(-300, 300)};
+	}
+
+	// the bounds of PhysicsSystem::out_of_bounds
+	const vec2 bounds_min = {-500.f, -500.f};
+	const vec2 bounds_max = {(float)(MAP_WIDTH_PX + 500), (float)(MAP_HEIGHT_PX + 500)};
+	ComponentContainer<Motion> &motions = registry().motions;
+	size_t outside = 0;
+
+	// a zero step keeps the positions, and with them the bounds results, the same every round
+	double integrate_us = time_pass(rounds, [&]() { integrate_motions(motions.components.data(), motions.size(), 0.f); });
+	double bounds_us = time_pass(rounds, [&]() {
+		outside = 0;
+		registry().view<Projectile, Motion>().each([&](Entity, Projectile &, Motion &motion) {
+			const vec2 p = motion.position;
+			outside += p.x < bounds_min.x || p.x > bounds_max.x || p.y < bounds_min.y || p.y > bounds_max.y;
+		});
+	});
+
+	std::cout << std::fixed << std::setprecision(1) << "motion_bench: " << body_count << " bodies, " << rounds
+			  << " rounds, " << motion_kernels_isa() << " kernels" << std::endl;
+	std::cout << "integrate: " << std::setw(9) << integrate_us << " us" << std::endl;
+	std::cout << "bounds:    " << std::setw(9) << bounds_us << " us  (" << outside << " outside)" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+// Entry point of view_bench: times registry views (see tinyECS/view.hpp) against the loops they
+// replaced, one container iterated with has() / get() on the others.
+//
+//   view_bench [--entities N] [--rounds N] [--seed N]
+//
+// Creates N entities (default 20000) with a Motion and a RenderRequest; one in ten is also an
+// Enemy and one in twenty moves with the camera. Then times, over N rounds (default 200), two
+// joins the systems make, each as the loop the systems used before and as a view:
+//   enemies   every Enemy with its Motion (TowerSystem::find_nearest_enemy, the projectile hits)
+//   render    every RenderRequest with a Motion and no MoveWithCamera, in render request order
+//             (the world pass of RenderSystem::step_and_draw)
+// The enemy loop is timed twice, led by the enemies as the systems wrote it and led by the motions.
+// Prints the median time of one pass of each, and the number of entities it visited.
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// internal
+#include "random.hpp"
+#include "telemetry.hpp"
+#include "world.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+	// Median time of rounds calls of pass, in microseconds. pass returns the number of entities it
+	// visited and adds to checksum, so the compiler keeps the loads
+	template <typename Pass>
+	double time_pass(int rounds, size_t &visited, Pass pass)
+	{
+		LatencyHistogram times;
+		for (int round = 0; round < rounds; round++)
+		{
+			auto start = Clock::now();
+			visited = pass();
+			times.record(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+		return times.percentile_ms(50) * 1000;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int entity_count = 20000;
+	int rounds = 200;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--entities") && has_value)
+			entity_count = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--rounds") && has_value)
+			rounds = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--entities N] [--rounds N] [--seed N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	World world;
+	World::Scope scope(world);
+	Rng random(seed);
+	for (int i = 0; i < entity_count; i++)
+	{
+		Entity entity;
+		Motion &motion = registry().motions.emplace(entity);
+		motion.position = {random.uniform(0, 1000), random.uniform(0, 1000)};
+		registry().renderRequests.emplace(entity);
+		if (random.chance(0.1f))
+			registry().enemies.emplace(entity);
+		if (random.chance(0.05f))
+			registry().moveWithCameras.emplace(entity);
+	}
+
+	float checksum = 0;
+	size_t visited = 0;
+	std::cout << std::fixed << std::setprecision(1) << "view_bench: " << entity_count << " entities, "
+			  << registry().enemies.size() << " enemies, " << registry().moveWithCameras.size()
+			  << " moving with the camera, " << rounds << " rounds" << std::endl;
+	auto print_row = [&](const char *name, double us) {
+		std::cout << std::left << std::setw(40) << name << std::right << std::setw(9) << us << " us  ("
+				  << visited << " visited, " << us * 1000 / std::max<size_t>(1, visited) << " ns each)" << std::endl;
+	};
+
+	print_row("enemies: loop over enemies", time_pass(rounds, visited, [&]() {
+		size_t count = 0;
+		for (Entity entity : registry().enemies.entities)
+		{
+			if (!registry().motions.has(entity))
+				continue;
+			checksum += registry().motions.get(entity).position.x;
+			count++;
+		}
+		return count;
+	}));
+	print_row("enemies: loop over motions", time_pass(rounds, visited, [&]() {
+		size_t count = 0;
+		for (Entity entity : registry().motions.entities)
+		{
+			if (!registry().enemies.has(entity))
+				continue;
+			checksum += registry().motions.get(entity).position.x;
+			count++;
+		}
+		return count;
+	}));
+	print_row("enemies: view<Enemy, Motion>", time_pass(rounds, visited, [&]() {
+		size_t count = 0;
+		registry().view<Enemy, Motion>().each([&](Entity, Enemy &, Motion &motion) {
+			checksum += motion.position.x;
+			count++;
+		});
+		return count;
+	}));
+
+	print_row("render: loop over render requests", time_pass(rounds, visited, [&]() {
+		size_t count = 0;
+		for (Entity entity : registry().renderRequests.entities)
+		{
+			if (registry().motions.has(entity) && !registry().moveWithCameras.has(entity))
+			{
+				checksum += registry().motions.get(entity).position.y;
+				count++;
+			}
+		}
+		return count;
+	}));
+	print_row("render: view, exclude<MoveWithCamera>", time_pass(rounds, visited, [&]() {
+		size_t count = 0;
+		registry().view<RenderRequest, Motion>(exclude<MoveWithCamera>).use<RenderRequest>().each([&](Entity, RenderRequest &, Motion &motion) {
+			checksum += motion.position.y;
+			count++;
+		});
+		return count;
+	}));
+
+	std::cout << "(checksum " << checksum << ")" << std::endl;
+	return EXIT_SUCCESS;
+}
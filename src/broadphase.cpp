@@ -0,0 +1,385 @@
+// internal
+#include "broadphase.hpp"
+#include "physics_system.hpp"
+#include "profiler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+size_t SweepAndPrune::PairIndex::slot_of(uint64_t key) const
+{
+	size_t mask = keys.size() - 1;
+	for (size_t i = home(key);; i = (i + 1) & mask)
+	{
+		if (keys[i] == key || keys[i] == EMPTY)
+			return i;
+	}
+}
+
+uint32_t *SweepAndPrune::PairIndex::find(uint64_t key)
+{
+	if (keys.empty())
+		return nullptr;
+	size_t i = slot_of(key);
+	return keys[i] == key ? &values[i] : nullptr;
+}
+
+void SweepAndPrune::PairIndex::insert(uint64_t key, uint32_t value)
+{
+	// at most half full, so probes stay short
+	if ((count + 1) * 2 > keys.size())
+		grow();
+	size_t i = slot_of(key);
+	if (keys[i] == EMPTY)
+		count++;
+	keys[i] = key;
+	values[i] = value;
+}
+
+void SweepAndPrune::PairIndex::erase(uint64_t key)
+{
+	if (keys.empty())
+		return;
+	size_t mask = keys.size() - 1;
+	size_t hole = slot_of(key);
+	if (keys[hole] != key)
+		return;
+	// shift back the entries of the run after the hole that may not stay past it
+	for (size_t i = (hole + 1) & mask; keys[i] != EMPTY; i = (i + 1) & mask)
+	{
+		size_t wanted = home(keys[i]);
+		bool stays = hole < i ? (wanted > hole && wanted <= i) : (wanted > hole || wanted <= i);
+		if (!stays)
+		{
+			keys[hole] = keys[i];
+			values[hole] = values[i];
+			hole = i;
+		}
+	}
+	keys[hole] = EMPTY;
+	count--;
+}
+
+void SweepAndPrune::PairIndex::clear()
+{
+	std::fill(keys.begin(), keys.end(), EMPTY);
+	count = 0;
+}
+
+void SweepAndPrune::PairIndex::grow()
+{
+	std::vector<uint64_t> old_keys = std::move(keys);
+	std::vector<uint32_t> old_values = std::move(values);
+	keys.assign(std::max<size_t>(1024, old_keys.size() * 2), EMPTY);
+	values.assign(keys.size(), 0);
+	for (size_t i = 0; i < old_keys.size(); i++)
+	{
+		if (old_keys[i] != EMPTY)
+		{
+			size_t slot = slot_of(old_keys[i]);
+			keys[slot] = old_keys[i];
+			values[slot] = old_values[i];
+		}
+	}
+}
+
+void SweepAndPrune::add_pair(uint32_t a, uint32_t b)
+{
+	uint64_t key = key_of(a, b);
+	if (pair_index.find(key))
+		return;
+	pair_index.insert(key, (uint32_t)pairs.size());
+	pairs.push_back({a, b});
+	pair_keys.push_back(key);
+}
+
+void SweepAndPrune::remove_pair(uint32_t a, uint32_t b)
+{
+	uint64_t key = key_of(a, b);
+	uint32_t *place = pair_index.find(key);
+	if (!place)
+		return;
+	// the last pair takes its place
+	uint32_t i = *place;
+	pair_index.erase(key);
+	if (i + 1 < pairs.size())
+	{
+		pairs[i] = pairs.back();
+		pair_keys[i] = pair_keys.back();
+		*pair_index.find(pair_keys[i]) = i;
+	}
+	pairs.pop_back();
+	pair_keys.pop_back();
+}
+
+void SweepAndPrune::remove_dead_pairs()
+{
+	for (size_t i = pairs.size(); i-- > 0;)
+	{
+		uint32_t a = (uint32_t)(pair_keys[i] >> 32);
+		uint32_t b = (uint32_t)pair_keys[i];
+		if (bodies[a].entity.is_null() || bodies[b].entity.is_null())
+			remove_pair(a, b);
+	}
+}
+
+void SweepAndPrune::sort_axis(Axis &axis, int a)
+{
+	float *values = axis.values.data();
+	uint32_t *body_ends = axis.body_ends.data();
+	size_t count = axis.size();
+	// the new values first, in a pass of their own that needs no branches. When none changed, the edges
+	// are still in order
+	bool moved = false;
+	for (size_t i = 0; i < count; i++)
+	{
+		float value = value_of(body_ends[i], a);
+		moved |= value != values[i];
+		values[i] = value;
+	}
+	if (!moved)
+		return;
+
+	// the edges that passed one of the other kind: a min moving before a max starts an overlap on this
+	// axis (entering), a max moving before a min ends one (leaving). Both are written down and one kept,
+	// since which it is follows no pattern a branch could predict
+	size_t entering_count = 0;
+	size_t leaving_count = 0;
+	for (size_t i = 1; i < count; i++)
+	{
+		// most edges are still past the one before them
+		if (values[i - 1] < values[i])
+			continue;
+		float value = values[i];
+		uint32_t body_end = body_ends[i];
+		size_t j = i;
+		while (j > 0 && after(values[j - 1], body_ends[j - 1], value, body_end))
+		{
+			uint32_t passed = body_ends[j - 1];
+			if (std::max(entering_count, leaving_count) == entering.size())
+			{
+				entering.resize(entering.size() * 2 + 64);
+				leaving.resize(entering.size());
+			}
+			Crossing crossing = {body_of(body_end), body_of(passed)};
+			uint32_t crossed = (body_end ^ passed) & 1;
+			entering[entering_count] = crossing;
+			leaving[leaving_count] = crossing;
+			entering_count += crossed & ~body_end;
+			leaving_count += crossed & body_end;
+			values[j] = values[j - 1];
+			body_ends[j] = passed;
+			j--;
+		}
+		values[j] = value;
+		body_ends[j] = body_end;
+		last_swaps += i - j;
+	}
+
+	// the boxes now overlap on this axis, maybe on both
+	for (size_t i = 0; i < entering_count; i++)
+	{
+		if (entering[i].body != entering[i].other && overlaps(entering[i].body, entering[i].other))
+			add_pair(entering[i].body, entering[i].other);
+	}
+	// they no longer do. Most such boxes were apart on the other axis all along; a pair is only there if
+	// its boxes overlapped on both axes at the last update, or do now, so the others are not looked up
+	int other_axis = 1 - a;
+	for (size_t i = 0; i < leaving_count; i++)
+	{
+		uint32_t body = leaving[i].body;
+		uint32_t other = leaving[i].other;
+		if (overlaps_on(old_boxes[body], old_boxes[other], other_axis) || overlaps_on(boxes[body], boxes[other], other_axis))
+			remove_pair(body, other);
+	}
+}
+
+void SweepAndPrune::rebuild()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		Axis &axis = axes[i];
+		std::sort(axis.body_ends.begin(), axis.body_ends.end(), [&](uint32_t a, uint32_t b)
+		{
+			// a total order, so the result does not depend on the sort
+			float a_value = value_of(a, i);
+			float b_value = value_of(b, i);
+			return after(b_value, b, a_value, a) || (!after(a_value, a, b_value, b) && a < b);
+		});
+		for (size_t j = 0; j < axis.size(); j++)
+			axis.values[j] = value_of(axis.body_ends[j], i);
+	}
+	pairs.clear();
+	pair_keys.clear();
+	pair_index.clear();
+	// along x, every box that starts while another is open overlaps it there
+	active.clear();
+	for (uint32_t body_end : axes[0].body_ends)
+	{
+		uint32_t body = body_of(body_end);
+		if (is_max(body_end))
+		{
+			active.erase(std::find(active.begin(), active.end(), body));
+			continue;
+		}
+		for (uint32_t other : active)
+		{
+			if (overlaps(body, other))
+				add_pair(other, body);
+		}
+		active.push_back(body);
+	}
+}
+
+void SweepAndPrune::update(const std::vector<Entity> &entities, ComponentContainer<Motion> &motions)
+{
+	epoch++;
+	added.clear();
+	for (Entity entity : entities)
+	{
+		const Motion *motion = motions.try_get(entity);
+		if (!motion)
+			continue;
+		unsigned int index = entity.index();
+		if (index >= slot_of_index.size())
+			slot_of_index.resize(index + 1, 0);
+		uint32_t slot = slot_of_index[index];
+		if (slot == 0 || bodies[slot - 1].entity.id() != entity.id())
+		{
+			// a new body (maybe for an index whose old entity is gone, its body is dropped below)
+			if (free_bodies.empty())
+			{
+				bodies.push_back(Body());
+				boxes.push_back({});
+				old_boxes.push_back({});
+				slot = (uint32_t)bodies.size();
+			}
+			else
+			{
+				slot = free_bodies.back() + 1;
+				free_bodies.pop_back();
+			}
+			bodies[slot - 1].entity = entity;
+			slot_of_index[index] = slot;
+			added.push_back(slot - 1);
+		}
+		bodies[slot - 1].seen = epoch;
+		bodies[slot - 1].motion_slot = (uint32_t)(motion - motions.components.data());
+	}
+
+	// drop the bodies that were not in entities, refresh the others
+	bool removed = false;
+	body_count = 0;
+	for (uint32_t slot = 0; slot < bodies.size(); slot++)
+	{
+		Body &body = bodies[slot];
+		if (body.entity.is_null())
+			continue;
+		if (body.seen != epoch)
+		{
+			uint32_t &index_slot = slot_of_index[body.entity.index()];
+			if (index_slot == slot + 1)
+				index_slot = 0;
+			body.entity = Entity::null();
+			free_bodies.push_back(slot);
+			removed = true;
+			continue;
+		}
+		const Motion &motion = motions.components[body.motion_slot];
+		vec2 position = motion.position;
+		float radius = length(abs(motion.scale) / 2.f);
+		// a NaN would break the order of the axes; park such a body where it overlaps nothing else
+		if (std::isnan(position.x + position.y + radius))
+		{
+			position = vec2(INFINITY);
+			radius = 0.f;
+		}
+		// a new body's old box is that of the slot's last body: at worst a pair is looked up for nothing
+		old_boxes[slot] = boxes[slot];
+		boxes[slot] = {{{position.x - radius, position.y - radius}, {position.x + radius, position.y + radius}}};
+		body_count++;
+	}
+	if (removed)
+	{
+		remove_dead_pairs();
+		for (Axis &axis : axes)
+		{
+			size_t kept = 0;
+			for (size_t i = 0; i < axis.size(); i++)
+			{
+				if (bodies[body_of(axis.body_ends[i])].entity.is_null())
+					continue;
+				axis.values[kept] = axis.values[i];
+				axis.body_ends[kept] = axis.body_ends[i];
+				kept++;
+			}
+			axis.values.resize(kept);
+			axis.body_ends.resize(kept);
+		}
+	}
+
+	// new bodies go after every other edge, where they overlap nothing, and are sorted in from
+	// there; unless there are so many that sorting everything again is cheaper
+	for (uint32_t slot : added)
+	{
+		for (Axis &axis : axes)
+		{
+			// a NaN differs from any value, so the sort cannot take the axis for unchanged
+			axis.push_back(NAN, slot << 1);
+			axis.push_back(NAN, slot << 1 | 1);
+		}
+	}
+	last_swaps = 0;
+	if (added.size() * 4 > body_count)
+	{
+		rebuild();
+		return;
+	}
+	for (int a = 0; a < 2; a++)
+		sort_axis(axes[a], a);
+}
+
+void BodyCollisions::step(float elapsed_ms)
+{
+	PROFILE_SCOPE("body_collisions");
+	ComponentContainer<Motion> &motions = registry().motions;
+	bodies.clear();
+	bodies.insert(bodies.end(), registry().enemies.entities.begin(), registry().enemies.entities.end());
+	bodies.insert(bodies.end(), registry().players.entities.begin(), registry().players.entities.end());
+	broadphase.update(bodies, motions);
+
+	// the collisions of this step only
+	registry().collisions.clear();
+	collision_count = 0;
+	float correction = std::min(1.f, SEPARATION_RATE * elapsed_ms / 1000.f);
+	for (SweepAndPrune::Pair pair : broadphase.get_pairs())
+	{
+		// nothing was added to or removed from the motions since the update
+		uint32_t slot_a = broadphase.get_motion_slot(pair.a);
+		uint32_t slot_b = broadphase.get_motion_slot(pair.b);
+		Motion &motion_a = motions.components[slot_a];
+		Motion &motion_b = motions.components[slot_b];
+		if (!PhysicsSystem::collides(motion_a, motion_b))
+			continue;
+		Entity a = broadphase.get_entity(pair.a);
+		Entity b = broadphase.get_entity(pair.b);
+		registry().collisions.emplace_with_duplicates(a, b);
+		collision_count++;
+		if (!registry().enemies.has(a) || !registry().enemies.has(b))
+			continue;
+
+		// push both apart along the line between them, towards the distance collides stops at
+		vec2 delta = motion_b.position - motion_a.position;
+		float distance = sqrt(dot(delta, delta));
+		float radius_a = length(abs(motion_a.scale) / 2.f);
+		float radius_b = length(abs(motion_b.scale) / 2.f);
+		// on top of each other: any direction will do, as long as it is the same every run
+		vec2 direction = distance > 0 ? delta / distance : vec2(1.f, 0.f);
+		vec2 push = direction * ((max(radius_a, radius_b) - distance) * correction / 2.f);
+		motion_a.position -= push;
+		motion_b.position += push;
+		motions.mark_changed_at(slot_a);
+		motions.mark_changed_at(slot_b);
+	}
+}
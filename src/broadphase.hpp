@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common.hpp"
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+// Sweep-and-prune over the bounding circles PhysicsSystem::collides uses, as boxes. Each axis keeps
+// the edges of every box sorted from one update to the next, along with the pairs whose boxes
+// overlap. Things move little in a step, so an insertion sort puts the edges back in order in about
+// one pass, and a pair can only start or stop overlapping where an edge passes another: the pairs
+// are brought up to date from those swaps, not found again. Many bodies added at once (the first
+// update, a large wave) are sorted from scratch and swept instead.
+class SweepAndPrune
+{
+public:
+	// two bodies, by slot: see get_entity() and get_motion_slot()
+	struct Pair
+	{
+		uint32_t a;
+		uint32_t b;
+	};
+
+	// Makes the bodies those of entities that have a Motion, with the boxes they have now, and
+	// brings the pairs up to date
+	void update(const std::vector<Entity> &entities, ComponentContainer<Motion> &motions);
+
+	// The bodies whose boxes overlap as of the last update, each pair once. The order only depends
+	// on the updates so far
+	const std::vector<Pair> &get_pairs() const { return pairs; }
+	Entity get_entity(uint32_t body) const { return bodies[body].entity; }
+	// where the body's Motion was in the container given to the last update, as long as that holds
+	// the same components in the same order
+	uint32_t get_motion_slot(uint32_t body) const { return bodies[body].motion_slot; }
+	size_t size() const { return body_count; }
+	// places the edges were moved by to sort them in the last update, a measure of how far from
+	// sorted they were (0 when it sorted from scratch)
+	uint64_t get_last_swaps() const { return last_swaps; }
+
+private:
+	struct Body
+	{
+		Entity entity = Entity::null(); // null for a free slot
+		uint32_t seen = 0;				// the last update it was in
+		uint32_t motion_slot = 0;		// as of the last update
+	};
+
+	// a body's box, apart from the rest of it so that the sort reads less memory
+	struct Box
+	{
+		float corners[2][2]; // min, max; each x, y
+	};
+
+	// The edges of the boxes on one axis, in order, as two arrays so that the sort reads the values
+	// alone until one is out of place
+	struct Axis
+	{
+		std::vector<float> values;
+		std::vector<uint32_t> body_ends; // body slot << 1, | 1 for the max edge
+
+		size_t size() const { return values.size(); }
+		void push_back(float value, uint32_t body_end)
+		{
+			values.push_back(value);
+			body_ends.push_back(body_end);
+		}
+	};
+
+	static uint32_t body_of(uint32_t body_end) { return body_end >> 1; }
+	static bool is_max(uint32_t body_end) { return body_end & 1; }
+	// whether an edge sorts after another; a min sorts before a max of the same value, so that boxes
+	// that touch count as overlapping, as in overlaps()
+	static bool after(float value, uint32_t body_end, float other_value, uint32_t other_body_end)
+	{
+		return value > other_value || (value == other_value && is_max(body_end) && !is_max(other_body_end));
+	}
+
+	// Open addressing table from a pair's key to its place in pairs
+	class PairIndex
+	{
+	public:
+		// the place of key, or nullptr
+		uint32_t *find(uint64_t key);
+		void insert(uint64_t key, uint32_t value);
+		void erase(uint64_t key);
+		void clear();
+
+	private:
+		static constexpr uint64_t EMPTY = ~0ull;
+		std::vector<uint64_t> keys;
+		std::vector<uint32_t> values;
+		size_t count = 0;
+
+		size_t home(uint64_t key) const { return (size_t)((key * 0x9e3779b97f4a7c15ull) >> 32) & (keys.size() - 1); }
+		size_t slot_of(uint64_t key) const;
+		void grow();
+	};
+
+	std::vector<Body> bodies;
+	std::vector<Box> boxes;		// of bodies
+	std::vector<Box> old_boxes; // as of the update before
+	std::vector<uint32_t> free_bodies;
+	size_t body_count = 0;
+	Axis axes[2]; // x, y
+	// the slot + 1 of the body of the entity of each index, 0 for none
+	std::vector<uint32_t> slot_of_index;
+	uint32_t epoch = 0;
+
+	std::vector<Pair> pairs;
+	std::vector<uint64_t> pair_keys; // of pairs
+	PairIndex pair_index;
+
+	std::vector<uint32_t> added;  // update scratch: the bodies new to it
+	std::vector<uint32_t> active; // sweep scratch
+	// sort scratch: the bodies of an edge and of one of the other kind it moved before
+	struct Crossing
+	{
+		uint32_t body;
+		uint32_t other;
+	};
+	std::vector<Crossing> entering;
+	std::vector<Crossing> leaving;
+	uint64_t last_swaps = 0;
+
+	static uint64_t key_of(uint32_t a, uint32_t b)
+	{
+		return a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a;
+	}
+	static bool overlaps_on(const Box &a, const Box &b, int axis)
+	{
+		return a.corners[0][axis] <= b.corners[1][axis] && b.corners[0][axis] <= a.corners[1][axis];
+	}
+	float value_of(uint32_t body_end, int axis) const
+	{
+		// indexed rather than picked, min and max edges come in no order a branch could predict
+		return boxes[body_of(body_end)].corners[body_end & 1][axis];
+	}
+	bool overlaps(uint32_t a, uint32_t b) const
+	{
+		return overlaps_on(boxes[a], boxes[b], 0) && overlaps_on(boxes[a], boxes[b], 1);
+	}
+	void add_pair(uint32_t a, uint32_t b);
+	void remove_pair(uint32_t a, uint32_t b);
+	// Drops the pairs of bodies that were removed
+	void remove_dead_pairs();
+	// Sorts axis by insertion, adding and removing the pairs whose edges pass each other
+	void sort_axis(Axis &axis, int a);
+	// Sorts the axes from scratch and finds every pair again
+	void rebuild();
+};
+
+// The overlapping bodies among the enemies and the player, every physics step. Records a Collision
+// for each pair PhysicsSystem::collides accepts, and pushes overlapping enemies apart a little at a
+// time, so crowds spread out instead of stacking on one spot.
+class BodyCollisions
+{
+public:
+	// share of the overlap between two enemies undone per second
+	static constexpr float SEPARATION_RATE = 8.f;
+
+	void step(float elapsed_ms);
+
+	const SweepAndPrune &get_broadphase() const { return broadphase; }
+	// how many of the last step's pairs collided
+	size_t get_collision_count() const { return collision_count; }
+
+private:
+	SweepAndPrune broadphase;
+	std::vector<Entity> bodies; // reused every step
+	size_t collision_count = 0;
+};
@@ -0,0 +1,118 @@
+// internal
+#include "frame_governor.hpp"
+#include "system_scheduler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "../ext/json.hpp"
+using json = nlohmann::json;
+
+namespace
+{
+	// what each level sheds, cheapest-looking losses first
+	const QualitySettings LEVELS[] = {
+		{1.f, true, 1},	   // full quality
+		{0.5f, false, 1},  // half the particles, steady electricity
+		{0.25f, false, 2}, // a quarter of the particles, off-screen animations at half rate
+		{0.1f, false, 4},  // a tenth of the particles, off-screen animations at quarter rate
+	};
+	const int LEVEL_COUNT = sizeof(LEVELS) / sizeof(LEVELS[0]);
+}
+
+GovernorConfig GovernorConfig::load(const std::string &path)
+{
+	GovernorConfig config;
+	std::ifstream file(path);
+	if (!file)
+		return config;
+	try
+	{
+		json values;
+		file >> values;
+		config.enabled = values.value("enabled", config.enabled);
+		config.budget_ms = values.value("budget_ms", config.budget_ms);
+		config.degrade_at = values.value("degrade_at", config.degrade_at);
+		config.restore_at = values.value("restore_at", config.restore_at);
+		config.window_frames = values.value("window_frames", config.window_frames);
+		config.restore_delay_ms = values.value("restore_delay_ms", config.restore_delay_ms);
+		config.max_level = values.value("max_level", config.max_level);
+	}
+	catch (const json::exception &e)
+	{
+		std::cerr << "ERROR: ignoring " << path << ": " << e.what() << std::endl;
+		return GovernorConfig();
+	}
+	config.window_frames = std::max(1, config.window_frames);
+	config.max_level = std::clamp(config.max_level, 0, LEVEL_COUNT - 1);
+	return config;
+}
+
+FrameGovernor::FrameGovernor(const GovernorConfig &config, World &world)
+	: config(config), world(world)
+{
+	world.quality = LEVELS[0];
+}
+
+void FrameGovernor::end_frame(double simulation_ms, double frame_ms, const SystemScheduler &scheduler)
+{
+	if (!config.enabled)
+		return;
+	window.record(simulation_ms);
+	window_frame_ms += frame_ms;
+	if (window.count() < (uint64_t)config.window_frames)
+		return;
+
+	double p95_ms = window.percentile_ms(95);
+	double window_length_ms = window_frame_ms;
+	window.reset();
+	window_frame_ms = 0;
+	if (p95_ms > config.budget_ms * config.degrade_at)
+	{
+		headroom_ms = 0;
+		if (level < config.max_level)
+		{
+			std::cout << std::fixed << std::setprecision(2) << "frame governor: simulation p95 " << p95_ms
+					  << " ms over the last " << config.window_frames << " frames, budget " << config.budget_ms
+					  << " ms" << std::defaultfloat << std::endl;
+			set_level(level + 1, scheduler);
+		}
+	}
+	else if (p95_ms < config.budget_ms * config.restore_at && level > 0)
+	{
+		headroom_ms += window_length_ms;
+		if (headroom_ms >= config.restore_delay_ms)
+		{
+			std::cout << std::fixed << std::setprecision(2) << "frame governor: simulation p95 " << p95_ms
+					  << " ms, under " << config.budget_ms * config.restore_at << " ms for " << headroom_ms / 1000
+					  << " s" << std::defaultfloat << std::endl;
+			headroom_ms = 0;
+			set_level(level - 1, scheduler);
+		}
+	}
+	else
+	{
+		headroom_ms = 0;
+	}
+}
+
+void FrameGovernor::set_level(int new_level, const SystemScheduler &scheduler)
+{
+	const QualitySettings &settings = LEVELS[new_level];
+	std::cout << "frame governor: quality level " << level << " -> " << new_level << " (particles "
+			  << std::lround(settings.particle_spawn_rate * 100) << "%, electricity jitter " << (settings.electricity_jitter ? "on" : "off")
+			  << ", off-screen animations every " << settings.offscreen_animation_interval << " updates)";
+	// the systems the last step waited on
+	const auto &path = scheduler.report().critical_path;
+	for (size_t i = 0; i < path.size(); i++)
+		std::cout << (i == 0 ? "; critical path " : " > ") << path[i];
+	std::cout << std::endl;
+
+	level = new_level;
+	world.quality = settings;
+	changes++;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+
+#include "telemetry.hpp"
+#include "world.hpp"
+
+class SystemScheduler;
+
+// Thresholds of the governor. Defaults below; data/governor.json may override any of them, e.g.
+//   { "budget_ms": 6.0, "restore_delay_ms": 5000 }
+struct GovernorConfig
+{
+	bool enabled = true;
+	// simulation time per frame the game should stay under, the rest of the frame is drawing
+	float budget_ms = 8.f;
+	// p95 of the simulation time over a window, as a fraction of the budget: above degrade_at
+	// the quality drops a level, below restore_at (for restore_delay_ms) it comes back one
+	float degrade_at = 1.f;
+	float restore_at = 0.6f;
+	int window_frames = 30;
+	float restore_delay_ms = 3000.f;
+	int max_level = 3;
+
+	// The defaults overridden by the keys found in path; the defaults if there is no such file
+	static GovernorConfig load(const std::string &path);
+};
+
+// Watches how long each frame's simulation steps take and sheds cosmetic work when they exceed the
+// budget: fewer particles, no electricity jitter, then slower off-screen animations (see the levels
+// in frame_governor.cpp). Quality comes back one level at a time once there is headroom again.
+// Every change is logged with the numbers that caused it. It sets the quality of the one world it
+// governs, so call end_frame only while no step of that world runs.
+class FrameGovernor
+{
+public:
+	FrameGovernor(const GovernorConfig &config, World &world);
+
+	// Takes the simulation time of one played frame, and its length, and adjusts quality
+	void end_frame(double simulation_ms, double frame_ms, const SystemScheduler &scheduler);
+
+	int get_level() const { return level; }
+	int get_changes() const { return changes; }
+
+private:
+	GovernorConfig config;
+	World &world;
+	LatencyHistogram window;
+	double window_frame_ms = 0; // length of the frames in window
+	int level = 0;
+	int changes = 0;
+	double headroom_ms = 0; // how long the windows have stayed under restore_at
+
+	void set_level(int new_level, const SystemScheduler &scheduler);
+};
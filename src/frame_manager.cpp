@@ -1,12 +1,8 @@
 #include "frame_manager.hpp"
 #include <iostream>
 
-std::vector<FrameManager*> FrameManager::frame_managers;
-unsigned int FrameManager::frame = 0;
-
 FrameManager::FrameManager(int frameInterval)
 {
-	frame_managers.push_back(this);
 	this->frameInterval = frameInterval;
 	time = 0;
 }
@@ -14,9 +10,7 @@ FrameManager::FrameManager(int frameInterval)
 void FrameManager::tick(float elapsed_ms)
 {
 	frame++;
-	for (FrameManager* frame_manager : frame_managers) {
-		frame_manager->time += elapsed_ms;
-	}
+	time += elapsed_ms;
 }
 
 bool FrameManager::can_update()
@@ -30,3 +24,31 @@ float FrameManager::get_time()
 	time = 0;
 	return elapsed_time;
 }
+
+SimulationClock::SimulationClock(float step_ms, int max_steps_per_frame)
+	: step_ms(step_ms), max_accumulated_ms(step_ms * max_steps_per_frame)
+{
+}
+
+void SimulationClock::advance(float elapsed_ms)
+{
+	accumulator += elapsed_ms;
+	if (accumulator > max_accumulated_ms)
+	{
+		dropped_ms += accumulator - max_accumulated_ms;
+		accumulator = max_accumulated_ms;
+	}
+}
+
+bool SimulationClock::step()
+{
+	if (accumulator < step_ms)
+		return false;
+	accumulator -= step_ms;
+	return true;
+}
+
+void SimulationClock::hold()
+{
+	accumulator = 0;
+}
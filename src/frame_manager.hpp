@@ -2,15 +2,45 @@
 
 #include <vector>
 
+// The simulation runs in fixed steps of SIMULATION_STEP_MS, whatever the frame rate. A frame that
+// took longer runs several steps (at most MAX_SIMULATION_STEPS_PER_FRAME, the rest of the time is
+// dropped so a slow frame cannot snowball into ever slower ones), a faster frame may run none.
+const float SIMULATION_STEP_MS = 1000.f / 60.f;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 5;
+
+class SimulationClock {
+public:
+    SimulationClock(float step_ms, int max_steps_per_frame);
+    // Adds the real time of a frame to the accumulator, clamped to max_steps_per_frame steps
+    void advance(float elapsed_ms);
+    // Consumes one step from the accumulator if a full one is available
+    bool step();
+    // Drops the accumulated time, e.g. while the game is paused
+    void hold();
+    float get_step_ms() const { return step_ms; }
+    // How far the accumulator is into the next step, in [0, 1): where rendering sits between the
+    // state before and after the last step
+    float get_alpha() const { return accumulator / step_ms; }
+    // Real time that was dropped by the clamp, in ms
+    float get_dropped_ms() const { return dropped_ms; }
+private:
+    float step_ms;
+    float max_accumulated_ms;
+    float accumulator = 0;
+    float dropped_ms = 0;
+};
+
+// Runs a system on every frameInterval-th simulation step, handing it the simulated time since its
+// last run (frameInterval steps of SIMULATION_STEP_MS once the clock runs steadily)
 class FrameManager {
 public:
-    static void tick(float elapsed_ms);
     FrameManager(int frameInterval);
+    // Advances the manager by one simulation step of elapsed_ms
+    void tick(float elapsed_ms);
     bool can_update();
     float get_time();
 private:
-    static std::vector<FrameManager*> frame_managers;
-    static unsigned int frame;
+    unsigned int frame = 0;
     int frameInterval;
     float time;
 };
@@ -0,0 +1,442 @@
+// Entry point of farmer_defense_headless: the full game simulation with no window, no OpenGL and
+// no audio, stepping as fast as the CPU allows. For benchmarks, balance runs and CI machines
+// without a display.
+//
+//   farmer_defense_headless [--days N] [--steps N] [--script FILE] [--trace FILE] [--no-intro] [--no-auto-level-up]
+//                           [--seed N] [--worlds N] [--record FILE] [--replay FILE] [--telemetry FILE]
+//
+// It starts a new game (clicking through the splash screen and the intro), runs until day N is
+// over, the game is lost or N steps have run, and prints a summary with the per-system timings.
+// --trace records a profile of the whole run into a Chrome trace_event file (see profiler.hpp).
+// Runs are deterministic for a given --seed (default 1). --record writes the run's input to a replay
+// file (see replay.hpp); --replay plays one back, from the game or from this runner, to its end
+// and takes no other input. --telemetry writes the distribution of step times, overall and per
+// system, to a JSON file (see telemetry.hpp); each step counts as a frame.
+// --worlds N plays N games at once, in separate worlds on separate threads, with seeds --seed,
+// --seed + 1, ..., and prints how each ended.
+// A script feeds input at given simulation steps, one event per line ('#' starts a comment):
+//
+//   <step> key <name> press|release     key names as in GLFW_KEY_<name> (W, SPACE, ...) or a key code
+//   <step> move <x> <y>                 cursor position in window coordinates
+//   <step> mouse left|right press|release
+//   <step> click <x> <y>                move, then press and release the left button
+
+// stdlib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// internal
+#include "null_platform.hpp"
+#include "profiler.hpp"
+#include "random.hpp"
+#include "scripted_player.hpp"
+#include "simulation.hpp"
+#include "telemetry.hpp"
+#include "tinyECS/memory.hpp"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+	struct ScriptEvent
+	{
+		enum class Type
+		{
+			KEY,
+			MOVE,
+			MOUSE,
+			CLICK
+		};
+
+		unsigned int step;
+		Type type;
+		int code = 0;	// key or mouse button
+		int action = 0; // GLFW_PRESS or GLFW_RELEASE
+		double x = 0;
+		double y = 0;
+	};
+
+	int parse_key(const std::string &name)
+	{
+		if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z')
+			return GLFW_KEY_A + (name[0] - 'A');
+		if (name.size() == 1 && name[0] >= '0' && name[0] <= '9')
+			return GLFW_KEY_0 + (name[0] - '0');
+		const std::pair<const char *, int> named_keys[] = {
+			{"SPACE", GLFW_KEY_SPACE},
+			{"ESCAPE", GLFW_KEY_ESCAPE},
+			{"ENTER", GLFW_KEY_ENTER},
+			{"TAB", GLFW_KEY_TAB},
+			{"LEFT_SHIFT", GLFW_KEY_LEFT_SHIFT},
+			{"RIGHT_SHIFT", GLFW_KEY_RIGHT_SHIFT},
+			{"UP", GLFW_KEY_UP},
+			{"DOWN", GLFW_KEY_DOWN},
+			{"LEFT", GLFW_KEY_LEFT},
+			{"RIGHT", GLFW_KEY_RIGHT},
+		};
+		for (const auto &named_key : named_keys)
+		{
+			if (name == named_key.first)
+				return named_key.second;
+		}
+		char *end = nullptr;
+		long code = std::strtol(name.c_str(), &end, 10);
+		return (end && *end == '\0' && code >= 0 && code <= GLFW_KEY_LAST) ? (int)code : -1;
+	}
+
+	int parse_action(const std::string &name)
+	{
+		if (name == "press")
+			return GLFW_PRESS;
+		if (name == "release")
+			return GLFW_RELEASE;
+		return -1;
+	}
+
+	// Reads a script, sorted by step; false (with a message) on the first malformed line
+	bool load_script(const std::string &path, std::vector<ScriptEvent> &events)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			std::cerr << "ERROR: cannot open script " << path << std::endl;
+			return false;
+		}
+		std::string line;
+		for (int line_number = 1; std::getline(file, line); line_number++)
+		{
+			line = line.substr(0, line.find('#'));
+			std::istringstream in(line);
+			ScriptEvent event;
+			std::string type;
+			if (!(in >> event.step))
+			{
+				if (line.find_first_not_of(" \t\r") == std::string::npos)
+					continue;
+				std::cerr << "ERROR: " << path << ":" << line_number << ": expected a step number" << std::endl;
+				return false;
+			}
+			in >> type;
+			bool valid = false;
+			if (type == "key")
+			{
+				std::string key, action;
+				in >> key >> action;
+				event.type = ScriptEvent::Type::KEY;
+				event.code = parse_key(key);
+				event.action = parse_action(action);
+				valid = event.code >= 0 && event.action >= 0;
+			}
+			else if (type == "move" || type == "click")
+			{
+				event.type = type == "move" ? ScriptEvent::Type::MOVE : ScriptEvent::Type::CLICK;
+				valid = bool(in >> event.x >> event.y);
+			}
+			else if (type == "mouse")
+			{
+				std::string button, action;
+				in >> button >> action;
+				event.type = ScriptEvent::Type::MOUSE;
+				event.code = button == "left" ? GLFW_MOUSE_BUTTON_LEFT : button == "right" ? GLFW_MOUSE_BUTTON_RIGHT : -1;
+				event.action = parse_action(action);
+				valid = event.code >= 0 && event.action >= 0;
+			}
+			if (!valid)
+			{
+				std::cerr << "ERROR: " << path << ":" << line_number << ": cannot parse '" << line << "'" << std::endl;
+				return false;
+			}
+			events.push_back(event);
+		}
+		std::stable_sort(events.begin(), events.end(),
+						 [](const ScriptEvent &a, const ScriptEvent &b) { return a.step < b.step; });
+		return true;
+	}
+
+	void dispatch(const ScriptEvent &event)
+	{
+		switch (event.type)
+		{
+		case ScriptEvent::Type::KEY:
+			headless_key_event(event.code, event.action);
+			break;
+		case ScriptEvent::Type::MOVE:
+			headless_cursor_event(event.x, event.y);
+			break;
+		case ScriptEvent::Type::MOUSE:
+			headless_mouse_button_event(event.code, event.action);
+			break;
+		case ScriptEvent::Type::CLICK:
+			click(vec2(event.x, event.y));
+			break;
+		}
+	}
+
+	struct Options
+	{
+		int days = 3;
+		unsigned long max_steps = 60 * 60 * 60; // an hour of game time
+		bool intro = true;
+		bool auto_level_up = true;
+		// print a line whenever a day starts
+		bool log_days = true;
+		std::vector<ScriptEvent> script;
+	};
+
+	struct GameResult
+	{
+		unsigned long steps = 0;
+		unsigned long simulated_steps = 0;
+		double wall_ms = 0;
+	};
+
+	// Plays the game of simulation (bound to the calling thread) from the splash screen until
+	// options say it is over; false if it could not get past the intro
+	bool run_game(Simulation &simulation, const Options &options, FrameTelemetry &telemetry, GameResult &result)
+	{
+		WorldSystem &world_system = simulation.world_system;
+		World &world = simulation.world;
+
+		// start a new game: the start button, then the intro cutscene
+		if (options.intro)
+		{
+			click_button([](BUTTON_ID type) { return type == BUTTON_ID::START; });
+			if (!skip_cutscene())
+			{
+				std::cerr << "ERROR: the intro cutscene did not end" << std::endl;
+				return false;
+			}
+		}
+
+		auto start = Clock::now();
+		unsigned long step = 0;
+		size_t next_event = 0;
+		int last_day = world.current_day;
+		auto running = [&]()
+		{
+			if (simulation.is_replaying())
+				return !simulation.replay_finished();
+			return step < options.max_steps && !world_system.is_over() && !world.game_is_over &&
+				   world.current_day <= options.days;
+		};
+		while (running())
+		{
+			frame_arena.reset();
+			for (; next_event < options.script.size() && options.script[next_event].step <= step; next_event++)
+				dispatch(options.script[next_event]);
+
+			GAME_SCREEN_ID game_screen = world.game_screen;
+			// a replay steps on every iteration, see Simulation::replay_input
+			bool play = simulation.is_replaying();
+			if (!play)
+			{
+				if (game_screen == GAME_SCREEN_ID::CG)
+					skip_cutscene();
+				else if (game_screen == GAME_SCREEN_ID::LEVEL_UP && options.auto_level_up)
+					pick_level_up_seed();
+				else
+					play = game_screen != GAME_SCREEN_ID::PAUSE && game_screen != GAME_SCREEN_ID::LEVEL_UP;
+			}
+			if (play)
+			{
+				auto step_start = Clock::now();
+				simulation.step(SIMULATION_STEP_MS);
+				telemetry.record_frame(std::chrono::duration<double, std::milli>(Clock::now() - step_start).count());
+				result.simulated_steps++;
+			}
+			world.registry.advance_tick();
+			step++;
+
+			if (world.current_day != last_day)
+			{
+				last_day = world.current_day;
+				if (options.log_days)
+					std::cout << "step " << step << ": day " << last_day << ", enemies killed " << world_system.points
+							  << ", level " << world_system.level << std::endl;
+			}
+		}
+		result.steps = step;
+		result.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		return true;
+	}
+
+	// The state a game ended in, in one line
+	void print_outcome(std::ostream &out, Simulation &simulation)
+	{
+		World &world = simulation.world;
+		out << "day: " << world.current_day << ", enemies killed: " << simulation.world_system.points
+			<< ", level: " << simulation.world_system.level << ", enemies alive: " << world.registry.enemies.size()
+			<< (world.game_is_over ? ", game over" : "");
+	}
+
+	// Plays count games at once, each in its own World on its own thread with seeds first_seed,
+	// first_seed + 1, ...; every simulation steps its systems on that one thread
+	int play_worlds(int count, unsigned int first_seed, const Options &options)
+	{
+		std::vector<std::ostringstream> outcomes(count);
+		std::vector<GameResult> results(count);
+		std::vector<char> succeeded(count, 0);
+		auto start = Clock::now();
+		std::vector<std::thread> threads;
+		for (int i = 0; i < count; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				World world;
+				World::Scope world_scope(world);
+				world.random.seed(first_seed + i);
+				Simulation simulation(world, 0);
+				RenderSystem renderer_system;
+				GLFWwindow *window = simulation.world_system.create_window();
+				simulation.start_and_load_sounds();
+				renderer_system.init(window);
+				simulation.init(&renderer_system);
+
+				FrameTelemetry telemetry;
+				succeeded[i] = run_game(simulation, options, telemetry, results[i]);
+				print_outcome(outcomes[i], simulation);
+			});
+		}
+		for (std::thread &thread : threads)
+			thread.join();
+		double wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		unsigned long simulated_steps = 0;
+		for (int i = 0; i < count; i++)
+		{
+			std::cout << "world " << i << " (seed " << first_seed + i << "): " << outcomes[i].str() << ", "
+					  << results[i].simulated_steps << " steps in " << results[i].wall_ms << " ms" << std::endl;
+			simulated_steps += results[i].simulated_steps;
+		}
+		std::cout << count << " worlds, wall time: " << wall_ms << " ms, "
+				  << (wall_ms > 0 ? simulated_steps / (wall_ms / 1000) : 0) << " steps/s in total" << std::endl;
+		return std::count(succeeded.begin(), succeeded.end(), 0) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Options options;
+	std::string script_path;
+	std::string trace_path;
+	unsigned int seed = 1;
+	int worlds = 1;
+	std::string record_path;
+	std::string replay_path;
+	std::string telemetry_path;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--days") && has_value)
+			options.days = std::atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--steps") && has_value)
+			options.max_steps = std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--script") && has_value)
+			script_path = argv[++i];
+		else if (!strcmp(argv[i], "--trace") && has_value)
+			trace_path = argv[++i];
+		else if (!strcmp(argv[i], "--no-intro"))
+			options.intro = false;
+		else if (!strcmp(argv[i], "--no-auto-level-up"))
+			options.auto_level_up = false;
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--worlds") && has_value)
+			worlds = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--record") && has_value)
+			record_path = argv[++i];
+		else if (!strcmp(argv[i], "--replay") && has_value)
+			replay_path = argv[++i];
+		else if (!strcmp(argv[i], "--telemetry") && has_value)
+			telemetry_path = argv[++i];
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--days N] [--steps N] [--script FILE] [--trace FILE] [--no-intro] [--no-auto-level-up]"
+					  << " [--seed N] [--worlds N] [--record FILE] [--replay FILE] [--telemetry FILE]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!script_path.empty() && !load_script(script_path, options.script))
+		return EXIT_FAILURE;
+
+	if (worlds > 1)
+	{
+		if (!record_path.empty() || !replay_path.empty() || !trace_path.empty() || !telemetry_path.empty())
+		{
+			std::cerr << "ERROR: --record, --replay, --trace and --telemetry take a single world" << std::endl;
+			return EXIT_FAILURE;
+		}
+		options.log_days = false;
+		return play_worlds(worlds, seed, options);
+	}
+
+	// a replay brings its own seed and input, and ends where its session did
+	ReplayRecorder replay_recorder;
+	ReplayPlayer replay_player;
+	if (!replay_path.empty())
+	{
+		if (!replay_player.open(replay_path))
+			return EXIT_FAILURE;
+		seed = replay_player.get_seed();
+		options.script.clear();
+		options.intro = false;
+	}
+
+	World world;
+	World::Scope world_scope(world);
+	world.random.seed(seed);
+
+	Simulation simulation(world);
+	WorldSystem &world_system = simulation.world_system;
+	RenderSystem renderer_system;
+
+	// the null platform's window, input reaches the game through its callbacks
+	GLFWwindow *window = world_system.create_window();
+	simulation.start_and_load_sounds();
+	renderer_system.init(window);
+	simulation.init(&renderer_system);
+
+	if (!replay_path.empty())
+		simulation.replay_input(&replay_player);
+	else if (!record_path.empty())
+	{
+		if (!replay_recorder.open(record_path, seed))
+			return EXIT_FAILURE;
+		simulation.record_input(&replay_recorder);
+	}
+
+	if (!trace_path.empty())
+		Profiler::start();
+	FrameTelemetry telemetry;
+	GameResult result;
+	if (!run_game(simulation, options, telemetry, result))
+		return EXIT_FAILURE;
+	if (replay_recorder.is_open())
+		replay_recorder.close(simulation.get_tick());
+	if (!trace_path.empty())
+	{
+		Profiler::stop();
+		Profiler::write_chrome_trace(trace_path);
+	}
+
+	std::cout << "steps: " << result.steps << " (" << result.simulated_steps << " simulated, "
+			  << result.simulated_steps * SIMULATION_STEP_MS / 1000.f << " s of game time)" << std::endl;
+	std::cout << "wall time: " << result.wall_ms << " ms, "
+			  << (result.wall_ms > 0 ? result.simulated_steps / (result.wall_ms / 1000) : 0) << " steps/s" << std::endl;
+	print_outcome(std::cout, simulation);
+	std::cout << std::endl;
+	telemetry.print_summary(std::cout);
+	simulation.print_report(std::cout);
+	if (!telemetry_path.empty())
+		telemetry.write_json(telemetry_path, simulation.get_scheduler());
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,33 @@
+// internal
+#include "render_system.hpp"
+#include "tinyECS/registry.hpp"
+
+// The headless build has no GL context, so it links these in place of render_system_init.cpp and
+// render_system.cpp. Gameplay only needs the renderer for the CPU side of the meshes, which the
+// collision code reads (collides_mesh), and the screen state entity it owns.
+
+bool RenderSystem::init(GLFWwindow *window_arg)
+{
+	this->window = window_arg;
+	registry().screenStates.emplace(screen_state_entity);
+	initializeGlMeshes();
+	return true;
+}
+
+void RenderSystem::initializeGlMeshes()
+{
+	for (uint i = 0; i < mesh_paths.size(); i++)
+	{
+		GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
+		std::string name = mesh_paths[i].second;
+		Mesh::loadFromOBJFile(name,
+							  meshes[(int)geom_index].vertices,
+							  meshes[(int)geom_index].vertex_indices,
+							  meshes[(int)geom_index].original_size);
+		meshes[(int)geom_index].build_collision_data();
+	}
+}
+
+RenderSystem::~RenderSystem()
+{
+}
@@ -0,0 +1,113 @@
+// internal
+#include "null_platform.hpp"
+#include "common.hpp"
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+namespace
+{
+	// one window per thread, so games driven from different threads each get their own input.
+	// GLFWwindow is opaque so any address works as its handle
+	struct NullWindow
+	{
+		void *user_pointer = nullptr;
+		bool should_close = false;
+		GLFWkeyfun key_callback = nullptr;
+		GLFWcursorposfun cursor_callback = nullptr;
+		GLFWmousebuttonfun mouse_button_callback = nullptr;
+		int keys[GLFW_KEY_LAST + 1] = {};
+	};
+	thread_local NullWindow null_window;
+
+	GLFWwindow *window_handle()
+	{
+		return reinterpret_cast<GLFWwindow *>(&null_window);
+	}
+
+	// sounds load "successfully" so the game takes its normal paths, and play nowhere
+	Mix_Chunk null_chunk = {};
+	char null_music;
+
+	GLenum null_gl_get_error()
+	{
+		return GL_NO_ERROR;
+	}
+}
+
+void headless_key_event(int key, int action)
+{
+	if (key < 0 || key > GLFW_KEY_LAST)
+		return;
+	null_window.keys[key] = action == GLFW_RELEASE ? GLFW_RELEASE : GLFW_PRESS;
+	if (null_window.key_callback)
+		null_window.key_callback(window_handle(), key, 0, action, 0);
+}
+
+void headless_cursor_event(double x, double y)
+{
+	if (null_window.cursor_callback)
+		null_window.cursor_callback(window_handle(), x, y);
+}
+
+void headless_mouse_button_event(int button, int action)
+{
+	if (null_window.mouse_button_callback)
+		null_window.mouse_button_callback(window_handle(), button, action, 0);
+}
+
+// OpenGL: only the error query is reached outside the renderer (gl_has_errors)
+PFNGLGETERRORPROC gl3wGetError = null_gl_get_error;
+
+// GLFW
+GLFWerrorfun glfwSetErrorCallback(GLFWerrorfun) { return nullptr; }
+int glfwInit() { return GLFW_TRUE; }
+void glfwWindowHint(int, int) {}
+GLFWwindow *glfwCreateWindow(int, int, const char *, GLFWmonitor *, GLFWwindow *) { return window_handle(); }
+void glfwDestroyWindow(GLFWwindow *) {}
+int glfwWindowShouldClose(GLFWwindow *) { return null_window.should_close; }
+void glfwSetWindowShouldClose(GLFWwindow *, int value) { null_window.should_close = value != GLFW_FALSE; }
+void glfwSetWindowUserPointer(GLFWwindow *, void *pointer) { null_window.user_pointer = pointer; }
+void *glfwGetWindowUserPointer(GLFWwindow *) { return null_window.user_pointer; }
+void glfwGetWindowSize(GLFWwindow *, int *width, int *height)
+{
+	if (width)
+		*width = WINDOW_WIDTH_PX;
+	if (height)
+		*height = WINDOW_HEIGHT_PX;
+}
+int glfwGetKey(GLFWwindow *, int key) { return key >= 0 && key <= GLFW_KEY_LAST ? null_window.keys[key] : GLFW_RELEASE; }
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow *, GLFWkeyfun callback)
+{
+	GLFWkeyfun previous = null_window.key_callback;
+	null_window.key_callback = callback;
+	return previous;
+}
+GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow *, GLFWcursorposfun callback)
+{
+	GLFWcursorposfun previous = null_window.cursor_callback;
+	null_window.cursor_callback = callback;
+	return previous;
+}
+GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow *, GLFWmousebuttonfun callback)
+{
+	GLFWmousebuttonfun previous = null_window.mouse_button_callback;
+	null_window.mouse_button_callback = callback;
+	return previous;
+}
+
+// SDL and SDL_mixer
+int SDL_Init(Uint32) { return 0; }
+SDL_RWops *SDL_RWFromFile(const char *, const char *) { return nullptr; }
+int Mix_OpenAudio(int, Uint16, int, int) { return 0; }
+void Mix_CloseAudio() {}
+Mix_Chunk *Mix_LoadWAV_RW(SDL_RWops *, int) { return &null_chunk; }
+Mix_Music *Mix_LoadMUS(const char *) { return reinterpret_cast<Mix_Music *>(&null_music); }
+void Mix_FreeChunk(Mix_Chunk *) {}
+void Mix_FreeMusic(Mix_Music *) {}
+int Mix_PlayChannelTimed(int channel, Mix_Chunk *, int, int) { return channel < 0 ? 0 : channel; }
+int Mix_FadeInMusic(Mix_Music *, int, int) { return 0; }
+int Mix_VolumeMusic(int) { return MIX_MAX_VOLUME; }
+int Mix_HaltChannel(int) { return 0; }
+int Mix_HaltMusic() { return 0; }
@@ -0,0 +1,15 @@
+#pragma once
+
+// The headless build links this instead of GLFW, SDL2, SDL_mixer and OpenGL: every entry point the
+// gameplay code calls exists, but there is no window, no GL context and no audio device. Input is
+// injected with the functions below, which reach WorldSystem through the same callbacks a GLFW
+// window would call. Each thread has its own window, and its events go to the game of that thread.
+
+// Presses (GLFW_PRESS) or releases (GLFW_RELEASE) key; glfwGetKey reports it until the next change
+void headless_key_event(int key, int action);
+
+// Moves the cursor to (x, y) in window coordinates
+void headless_cursor_event(double x, double y);
+
+// Presses or releases a mouse button (GLFW_MOUSE_BUTTON_LEFT, ...)
+void headless_mouse_button_event(int button, int action);
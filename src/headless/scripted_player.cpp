@@ -0,0 +1,21 @@
+// internal
+#include "scripted_player.hpp"
+
+void click(vec2 position)
+{
+	headless_cursor_event(position.x, position.y);
+	headless_mouse_button_event(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS);
+	headless_mouse_button_event(GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE);
+}
+
+bool skip_cutscene()
+{
+	for (int i = 0; i < 32 && WorldSystem::get_game_screen() == GAME_SCREEN_ID::CG; i++)
+		click(vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2));
+	return WorldSystem::get_game_screen() != GAME_SCREEN_ID::CG;
+}
+
+bool pick_level_up_seed()
+{
+	return click_button([](BUTTON_ID type) { return type >= BUTTON_ID::LEVEL_UP_SEED1 && type <= BUTTON_ID::LEVEL_UP_SEED8; });
+}
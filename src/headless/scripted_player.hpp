@@ -0,0 +1,32 @@
+#pragma once
+
+// internal
+#include "null_platform.hpp"
+#include "world_system.hpp"
+
+// What a player would click, for the runners that play the game on their own (headless_main.cpp,
+// wave_sim/). Goes through the null platform's input, so the game handles it as a real click.
+
+// Moves the cursor to position, then presses and releases the left button
+void click(vec2 position);
+
+// Clicks the first button for which accept(type) holds; false if there is none
+template <typename Accept>
+bool click_button(Accept accept)
+{
+	for (const CustomButton &button : registry().buttons.components)
+	{
+		if (accept(button.type))
+		{
+			click(button.position);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Clicks through a cutscene; false if it does not end
+bool skip_cutscene();
+
+// Takes the first seed offered on the level-up screen; false if there is none
+bool pick_level_up_seed();
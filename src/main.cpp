@@ -4,47 +4,78 @@
 // stdlib
 #include <chrono>
 #include <iostream>
+#include <random>
 #include <sstream>
 
 // internal
-#include "ai_system.hpp"
-#include "physics_system.hpp"
 #include "render_system.hpp"
-#include "world_system.hpp"
-#include "status_system.hpp"
-#include "player_system.hpp"
-#include "animation_system.hpp"
-#include "tower_system.hpp"
-#include "movement_system.hpp"
-#include "screen_system.hpp"
-#include "death_system.hpp"
+#include "simulation.hpp"
 // fonts
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <map>
-#include "particle_system.hpp"
-#include "seed_system.hpp"
+#include "frame_governor.hpp"
 #include "frame_manager.hpp"
+#include "profiler.hpp"
+#include "random.hpp"
+#include "replay.hpp"
+#include "telemetry.hpp"
+#include "tinyECS/memory.hpp"
+#include "tinyECS/registry_monitor.hpp"
+#include "world.hpp"
 
 using Clock = std::chrono::high_resolution_clock;
 
-// Entry point
-int main()
+// Entry point.
+//   --profile      records a profile from launch to exit, written to data/profile_trace.json
+//                  (F9 records one in game)
+//   --record FILE  records the session's input to FILE (default data/last_session.replay)
+//   --replay FILE  plays a recorded session back instead of taking input, then exits
+int main(int argc, char *argv[])
 {
+	bool profile = false;
+	std::string record_path = data_path() + "/last_session.replay";
+	std::string replay_path;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--profile")
+			profile = true;
+		else if (arg == "--record" && i + 1 < argc)
+			record_path = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc)
+			replay_path = argv[++i];
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--profile] [--record FILE] [--replay FILE]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (profile)
+		Profiler::start();
+
+	// the game, bound to this thread for the whole session
+	World world;
+	World::Scope world_scope(world);
+
+	// the systems draw their randomness from the session seed, so it is set before they exist
+	ReplayRecorder replay_recorder;
+	ReplayPlayer replay_player;
+	if (!replay_path.empty())
+	{
+		if (!replay_player.open(replay_path))
+			return EXIT_FAILURE;
+		world.random.seed(replay_player.get_seed());
+	}
+	else
+	{
+		world.random.seed(std::random_device()());
+	}
+
 	// global systems
-	AISystem ai_system;
-	WorldSystem world_system;
+	Simulation simulation(world);
+	WorldSystem &world_system = simulation.world_system;
 	RenderSystem renderer_system;
-	PhysicsSystem physics_system;
-	StatusSystem status_system;
-	AnimationSystem animation_system;
-	TowerSystem tower_system;
-	SeedSystem seed_system;
-	MovementSystem movement_system;
-	ParticleSystem particle_system;
-	PlayerSystem player_system;
-	ScreenSystem screen_system;
-	DeathSystem death_system;
 
 	// initialize window
 	GLFWwindow *window = world_system.create_window();
@@ -56,61 +87,57 @@ int main()
 		return EXIT_FAILURE;
 	}
 
-	if (!world_system.start_and_load_sounds())
-	{
-		std::cerr << "ERROR: Failed to start or load sounds in world_system." << std::endl;
-	}
-
-	if (!ai_system.start_and_load_sounds())
-	{
-		std::cerr << "ERROR: Failed to start or load sounds in ai_system." << std::endl;
-	}
-
-	if (!status_system.start_and_load_sounds())
-	{
-		std::cerr << "ERROR: Failed to start or load sounds in status_system." << std::endl;
-	}
-
-	if (!physics_system.start_and_load_sounds())
-	{
-		std::cerr << "ERROR: Failed to start or load sounds in status_system." << std::endl;
-	}
+	simulation.start_and_load_sounds();
 
 	// initialize the main systems
 	renderer_system.init(window);
-	world_system.init(&renderer_system);
-	animation_system.init(&renderer_system);
-	particle_system.init(&renderer_system);
-	seed_system.init(&renderer_system);
+	simulation.init(&renderer_system);
 
-	// variable timestep loop
+	// fixed timestep loop: the simulation advances in steps of SIMULATION_STEP_MS, rendering once per frame
 	auto t = Clock::now();
-
-	float fps_sum = 0;
-	int record_times = 0;
-	int max_fps = 0;
-	int min_fps = 50000; // impossible number technically, lazy implementation sorry!
-
-	// frame intervals
-	FrameManager fm_world = FrameManager(1);
-	FrameManager fm_ai = FrameManager(1);
-	FrameManager fm_physics = FrameManager(1);
-	FrameManager fm_status = FrameManager(1);
-	FrameManager fm_tower = FrameManager(5);
-	FrameManager fm_movement = FrameManager(2);
-	FrameManager fm_animation = FrameManager(2);
-	FrameManager fm_particle = FrameManager(10);
-	FrameManager fm_seed = FrameManager(5);
-	FrameManager fm_render = FrameManager(5);
-	FrameManager fm_player = FrameManager(5);
-	FrameManager fm_screen = FrameManager(2);
-	FrameManager fm_death = FrameManager(2);
+	SimulationClock simulation_clock(SIMULATION_STEP_MS, MAX_SIMULATION_STEPS_PER_FRAME);
+
+	if (!replay_path.empty())
+		simulation.replay_input(&replay_player);
+	else if (replay_recorder.open(record_path, world.random.get_seed()))
+		simulation.record_input(&replay_recorder);
+
+	// frame times while the game is played, summarized on screen, in the console when play stops and
+	// in data/telemetry.json at exit
+	FrameTelemetry telemetry;
+	uint64_t frames_summarized = 0;
+	renderer_system.stats_line = telemetry.get_stats_line();
+
+	// sheds cosmetic work while the simulation runs over its frame budget. Off during a replay,
+	// which should cost what the recorded session did at full quality
+	GovernorConfig governor_config = GovernorConfig::load(data_path() + "/governor.json");
+	governor_config.enabled = governor_config.enabled && !simulation.is_replaying();
+	FrameGovernor governor(governor_config, world);
+
+	// heap allocations made by the systems each tick, reported every second when they are counted
+	// (build with FARMER_DEFENSE_COUNT_ALLOCS); a warmed-up game should report zero
+	uint64_t tick_allocations_sum = 0;
+	uint64_t tick_allocations_max = 0;
+	int ticks_counted = 0;
+	float allocation_report_ms = 0;
+
+	// per-container memory use and occupancy, written to data/registry_stats.csv / .json every
+	// 5 seconds when built with FARMER_DEFENSE_REGISTRY_STATS
+	RegistryMonitor registry_monitor(world.registry);
+#if defined(FARMER_DEFENSE_REGISTRY_STATS)
+	registry_monitor.dump_to(data_path() + "/registry_stats", 5000);
+#endif
 
 	while (!world_system.is_over())
 	{
 		GAME_SCREEN_ID game_screen = world_system.get_game_screen();
 		// processes system messages, if this wasn't present the window would become unresponsive
 		glfwPollEvents();
+		if (simulation.replay_finished())
+		{
+			std::cout << "Replay finished after " << simulation.get_tick() << " steps" << std::endl;
+			break;
+		}
 
 		// calculate elapsed times in milliseconds from the previous iteration
 		auto now = Clock::now();
@@ -118,74 +145,99 @@ int main()
 			(float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
 		t = now;
 
-		// CK: be mindful of the order of your systems and rearrange this list only if necessary
-		//when level up, we want the screen to be frozen
-		if (game_screen != GAME_SCREEN_ID::PAUSE && game_screen != GAME_SCREEN_ID::LEVEL_UP) {
-			if (fm_world.can_update()) world_system.step(fm_world.get_time());
-			if (!WorldSystem::game_is_over && game_screen != GAME_SCREEN_ID::SPLASH && game_screen != GAME_SCREEN_ID::CG ) {
-				//M2: FPS
-				FrameManager::tick(elapsed_ms); //moved here so when doing cg the game will pause
-				float current_fps = (1/(elapsed_ms/1000));
-				if (record_times > 2)
-				{ // ignore the first 2, outliers wow.. maximum 5000 and minimum 10-ish fps, crazy
-					max_fps = max_fps < current_fps ? current_fps : max_fps;
-					min_fps = min_fps > current_fps ? current_fps : min_fps;
-					fps_sum += (1 / (elapsed_ms / 1000));
-				}
-				record_times++;
-
-				if (fm_ai.can_update())
-					ai_system.step(fm_ai.get_time());
-				if (fm_physics.can_update())
-					physics_system.step(fm_physics.get_time());
-				if (fm_status.can_update())
-					status_system.step(fm_status.get_time(), world_system);
-				if (fm_seed.can_update())
-					seed_system.step(fm_seed.get_time());
-
-				if (world_system.get_game_screen() == GAME_SCREEN_ID::CG)
-					continue;
-
-				if (fm_player.can_update())
-					player_system.step(fm_player.get_time());
-				if (fm_tower.can_update())
-					tower_system.step(fm_tower.get_time());
-				if (fm_movement.can_update())
-					movement_system.step(fm_movement.get_time(), game_screen);
-				if (fm_animation.can_update())
-					animation_system.step(fm_animation.get_time());
-				if (fm_particle.can_update())
-					particle_system.step(fm_particle.get_time());
-				if (fm_screen.can_update())
-					screen_system.step(fm_screen.get_time());
-				if (fm_death.can_update())
-					death_system.step(fm_death.get_time(), world_system);
+		// nothing holds on to last frame's scratch memory
+		frame_arena.reset();
+
+		//when level up, we want the screen to be frozen (a replay steps through it, see Simulation::replay_input)
+		if (simulation.is_replaying() || (game_screen != GAME_SCREEN_ID::PAUSE && game_screen != GAME_SCREEN_ID::LEVEL_UP)) {
+			bool playing = !world.game_is_over && game_screen != GAME_SCREEN_ID::SPLASH && game_screen != GAME_SCREEN_ID::CG;
+			if (playing) {
+				telemetry.record_frame(elapsed_ms);
+			}
+			else if (frames_summarized != telemetry.get_session().count())
+			{
+				// play stopped (game over, menu or cutscene): print once until it resumes
+				telemetry.print_summary(std::cout);
+				simulation.print_report(std::cout);
+				frames_summarized = telemetry.get_session().count();
 			}
-			else
+
+			auto simulation_start = Clock::now();
+			simulation_clock.advance(elapsed_ms);
+			while (simulation_clock.step())
 			{
-				// M2: FPS. make sure we only print once, lazy implementation
-				if (record_times != 0)
+				renderer_system.interpolation.capture();
+				uint64_t heap_allocations_before = memory_stats().heap_allocations;
+
+				bool keep_stepping = simulation.step(simulation_clock.get_step_ms());
+
+				if (memory_counts_heap_allocations())
 				{
-					std::cout << "maximum FPS: " << max_fps << std::endl;
-					std::cout << "minimum FPS: " << min_fps << std::endl;
-					std::cout << "average FPS: " << (fps_sum / record_times - 2) << std::endl;
-					max_fps = 50000;
-					min_fps = 0;
-					fps_sum = 0;
-					record_times = 0;
-					record_times = 0;
+					uint64_t tick_allocations = memory_stats().heap_allocations - heap_allocations_before;
+					tick_allocations_sum += tick_allocations;
+					tick_allocations_max = std::max(tick_allocations_max, tick_allocations);
+					ticks_counted++;
 				}
+
+				if (!keep_stepping)
+				{
+					simulation_clock.hold();
+					break;
+				}
+			}
+			renderer_system.interpolation.alpha = simulation_clock.get_alpha();
+
+			if (playing)
+			{
+				double simulation_ms = std::chrono::duration<double, std::milli>(Clock::now() - simulation_start).count();
+				governor.end_frame(simulation_ms, elapsed_ms, simulation.get_scheduler());
 			}
 		}
+		else
+		{
+			// frozen: draw the current state and do not catch up on the paused time later
+			simulation_clock.hold();
+			renderer_system.interpolation.alpha = 1.f;
+		}
+
+		if (memory_counts_heap_allocations())
+		{
+			allocation_report_ms += elapsed_ms;
+			if (allocation_report_ms >= 1000 && ticks_counted > 0)
+			{
+				MemoryStats stats = memory_stats();
+				std::cout << "heap allocations per tick: avg " << (double)tick_allocations_sum / ticks_counted
+						  << ", max " << tick_allocations_max << " (pool blocks fresh " << stats.pool_fresh_blocks
+						  << ", reused " << stats.pool_reused_blocks << "; frame arena peak " << stats.arena_high_water
+						  << " B)" << std::endl;
+				tick_allocations_sum = 0;
+				tick_allocations_max = 0;
+				ticks_counted = 0;
+				allocation_report_ms = 0;
+			}
+		}
+
+		// the changes of the next frame get a new tick
+		world.registry.advance_tick();
+		registry_monitor.step(elapsed_ms);
 
 		// DO NOT DELETE, OTHERWISE TEXT WON'T RENDER
 		glm::mat4 trans = glm::mat4(1.0f);
 		renderer_system.renderText("hello", 100, 100, 1, {1, 1, 0}, trans);
-    
-		if (fm_render.can_update() ||
-		WorldSystem::game_is_over || game_screen == GAME_SCREEN_ID::CG || game_screen == GAME_SCREEN_ID::PAUSE || game_screen == GAME_SCREEN_ID::SPLASH || game_screen == GAME_SCREEN_ID::LEVEL_UP) 
-			renderer_system.step_and_draw(fm_render.get_time());
-    
+
+		// one draw per frame (the swap waits for vsync), in between the last two simulation steps
+		renderer_system.step_and_draw(elapsed_ms);
+	}
+
+	if (replay_recorder.is_open())
+		replay_recorder.close(simulation.get_tick());
+	telemetry.print_summary(std::cout);
+	telemetry.write_json(data_path() + "/telemetry.json", simulation.get_scheduler());
+
+	if (profile)
+	{
+		Profiler::stop();
+		Profiler::write_chrome_trace(data_path() + "/profile_trace.json");
 	}
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,61 @@
+// internal
+#include "motion_interpolation.hpp"
+#include "tinyECS/registry.hpp"
+
+#include <cmath>
+
+void MotionInterpolation::capture()
+{
+	ComponentContainer<Motion> &motions = registry().motions;
+	for (size_t i = 0; i < motions.size(); i++)
+	{
+		unsigned int index = motions.entities[i].index();
+		if (index >= ids.size())
+		{
+			ids.resize(index + 1, 0);
+			positions.resize(index + 1);
+			angles.resize(index + 1);
+		}
+		ids[index] = motions.entities[i].id();
+		positions[index] = motions.components[i].position;
+		angles[index] = motions.components[i].angle;
+	}
+	has_camera = registry().cameras.size() > 0;
+	if (has_camera)
+		camera = registry().cameras.components[0].position;
+}
+
+int MotionInterpolation::captured(Entity e) const
+{
+	unsigned int index = e.index();
+	if (index >= ids.size() || ids[index] != e.id())
+		return -1;
+	return (int)index;
+}
+
+vec2 MotionInterpolation::position(Entity e, const Motion &motion) const
+{
+	int index = captured(e);
+	if (index < 0)
+		return motion.position;
+	return mix(positions[index], motion.position, alpha);
+}
+
+float MotionInterpolation::angle(Entity e, const Motion &motion) const
+{
+	int index = captured(e);
+	if (index < 0)
+		return motion.angle;
+	// a large jump is a turn to a new heading (or a wrap around 360), not a rotation to animate
+	float previous = angles[index];
+	if (std::abs(motion.angle - previous) > 90.f)
+		return motion.angle;
+	return mix(previous, motion.angle, alpha);
+}
+
+vec2 MotionInterpolation::camera_position(const Camera &camera_now) const
+{
+	if (!has_camera)
+		return camera_now.position;
+	return mix(camera, camera_now.position, alpha);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "common.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+#include "tinyECS/components.hpp"
+
+// The simulation advances in fixed steps while frames are drawn whenever the display is ready, so a
+// frame usually falls between two steps. capture() records every Motion (and the camera) before a
+// step; the renderer then draws each entity at alpha between that state and the current one,
+// instead of at the state of the last step, which would stutter whenever a frame saw zero or two steps.
+class MotionInterpolation
+{
+public:
+	// Records the state before a simulation step
+	void capture();
+
+	// Position of a step between the captured and the current state, set each frame by the main loop
+	float alpha = 1.f;
+
+	// Where to draw entity e, whose current Motion is motion. Entities created during the last step
+	// have no captured state and are drawn where they are.
+	vec2 position(Entity e, const Motion &motion) const;
+	float angle(Entity e, const Motion &motion) const;
+	vec2 camera_position(const Camera &camera) const;
+
+private:
+	// captured state, indexed by Entity::index(); ids tells whether the entry belongs to e
+	std::vector<unsigned int> ids;
+	std::vector<vec2> positions;
+	std::vector<float> angles;
+	bool has_camera = false;
+	vec2 camera = {0.f, 0.f};
+
+	// index into the captured arrays if e was captured, -1 otherwise
+	int captured(Entity e) const;
+};
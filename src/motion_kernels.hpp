@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+#include "tinyECS/components.hpp"
+
+// Bulk kernels over Motion data. Motion itself stays an array of structs (the rest of the game holds
+// Motion& into registry().motions); collision checks gather the bounding circles into a CircleBatch,
+// whose separate arrays the kernels process 4 (SSE2) or 8 (AVX2) at a time.
+// Every kernel has a scalar fallback and gives the same result on every path.
+
+// Bounding circles of a set of entities, as PhysicsSystem::collides sees them, in
+// structure-of-arrays layout
+struct CircleBatch
+{
+	std::vector<Entity> entities;
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> radius_squared;
+	std::vector<uint64_t> hits; // per-entity kernel output, one bit each
+	std::vector<float> toi;		// per-entity output of batch_circles_sweep
+
+	void clear();
+	void push(Entity entity, const Motion &motion);
+	size_t size() const { return entities.size(); }
+	bool hit(size_t i) const { return (hits[i >> 6] >> (i & 63)) & 1; }
+};
+
+// The squared radius of the circle PhysicsSystem::collides puts around a motion, half the diagonal of
+// its scale
+inline float bounding_radius_squared(const Motion &motion)
+{
+	const vec2 half = abs(motion.scale) / 2.f;
+	return dot(half, half);
+}
+
+// PhysicsSystem::collides on two circles: whether the centres are closer than the larger radius.
+// The kernels below compute exactly this, in this order
+inline bool circles_collide(vec2 a, float a_radius_squared, vec2 b, float b_radius_squared)
+{
+	const vec2 dp = a - b;
+	return dot(dp, dp) < max(a_radius_squared, b_radius_squared);
+}
+
+// position += velocity * step_seconds for count motions
+void integrate_motions(Motion *motions, size_t count, float step_seconds);
+
+// Sets bit i of hits (bit i & 63 of word i / 64, (count + 63) / 64 words) to
+// circles_collide(center, center_radius_squared, (x[i], y[i]), radius_squared[i]). Returns the number
+// of bits set
+size_t circles_overlap(vec2 center, float center_radius_squared, const float *x, const float *y,
+					   const float *radius_squared, size_t count, uint64_t *hits);
+
+// Runs circles_overlap for query against a batch, writing batch.hits; the same as calling
+// PhysicsSystem::collides(query, motion) for each motion of the batch
+size_t batch_circles_overlap(CircleBatch &batch, const Motion &query);
+
+// When a circle moving in a straight line from `from` to `to` first collides with another, as
+// circles_collide would say of it at that point: t in [0, 1] along the way, 0 if they overlap at
+// from already, INFINITY if they never do
+float circle_sweep_toi(vec2 from, vec2 to, float from_radius_squared, vec2 center, float radius_squared);
+
+// batch_circles_overlap for query swept from `from` to where it is now, so that nothing fast skips
+// over a body between two steps. Writes batch.toi, the circle_sweep_toi of each body (at most 1 for
+// those batch_circles_overlap reports, which stay hits whatever the rounding), and batch.hits, the
+// bodies it is finite for. Returns how many those are
+size_t batch_circles_sweep(CircleBatch &batch, const Motion &query, vec2 from);
+
+// Name of the instruction set the kernels were compiled for ("avx2", "sse2" or "scalar")
+const char *motion_kernels_isa();
@@ -1,8 +1,9 @@
 #include "particle_system.hpp"
 #include "render_system.hpp"
+#include "world.hpp"
 #include <algorithm>
 
-ParticleSystem::ParticleSystem() : gen(rd()), dist(0.0f, 1.0f)
+ParticleSystem::ParticleSystem()
 {
 }
 
@@ -18,24 +19,28 @@ void ParticleSystem::step(float elapsed_ms)
 
     // Then update all particles
     updateParticles(elapsed_ms);
+
+    // sync point: destroy the expired generators and particles recorded above
+    registry().flush_deferred();
 }
 
 void ParticleSystem::updateParticleGenerators(float elapsed_ms)
 {
-    for (Entity entity : registry.particleGenerators.entities)
+    const QualitySettings &quality = world().quality;
+    for (Entity entity : registry().particleGenerators.entities)
     {
-        ParticleGenerator &generator = registry.particleGenerators.get(entity);
+        ParticleGenerator &generator = registry().particleGenerators.get(entity);
 
         if (!generator.isActive)
             continue;
         // Follow player if needed (for level_up effect)
-        if (generator.follow_entity != Entity() &&
-            registry.motions.has(generator.follow_entity) &&
-            registry.motions.has(entity))
+        if (!generator.follow_entity.is_null() &&
+            registry().motions.has(generator.follow_entity) &&
+            registry().motions.has(entity))
         {
             // Update generator position to follow the entity
-            Motion &follow_motion = registry.motions.get(generator.follow_entity);
-            registry.motions.get(entity).position = follow_motion.position;
+            Motion &follow_motion = registry().motions.get(generator.follow_entity);
+            registry().motions.modify(entity).position = follow_motion.position;
         }
         // Check if the generator has expired
         if (generator.duration_ms > 0)
@@ -43,15 +48,16 @@ void ParticleSystem::updateParticleGenerators(float elapsed_ms)
             generator.duration_ms -= elapsed_ms;
             if (generator.duration_ms <= 0)
             {
-                registry.remove_all_components_of(entity);
-                break;
+                registry().deferred.destroy(entity);
+                continue;
             }
         }
 
-        // Check if we need to spawn more particles
+        // Check if we need to spawn more particles (less often when the frame governor sheds particles)
         generator.timer += elapsed_ms;
 
-        if (generator.timer >= generator.spawnInterval * 1000.0f) // Convert to ms
+        if (quality.particle_spawn_rate > 0.0f &&
+            generator.timer >= generator.spawnInterval * 1000.0f / quality.particle_spawn_rate) // Convert to ms
         {
             generator.timer = 0.0f;
 
@@ -60,9 +66,9 @@ void ParticleSystem::updateParticleGenerators(float elapsed_ms)
             {
                 // Get position from the entity's motion
                 vec2 position = {0.0f, 0.0f};
-                if (registry.motions.has(entity))
+                if (registry().motions.has(entity))
                 {
-                    position = registry.motions.get(entity).position;
+                    position = registry().motions.get(entity).position;
                 }
 
                 // Create a new particle
@@ -80,8 +86,8 @@ void ParticleSystem::updateParticleGenerators(float elapsed_ms)
                 generator.particles.end(),
                 [](Entity e)
                 {
-                    return !registry.particles.has(e) ||
-                           registry.particles.get(e).Life <= 0.0f;
+                    return !registry().particles.has(e) ||
+                           registry().particles.get(e).Life <= 0.0f;
                 }),
             generator.particles.end());
     }
@@ -89,11 +95,14 @@ void ParticleSystem::updateParticleGenerators(float elapsed_ms)
 
 void ParticleSystem::updateParticles(float elapsed_ms)
 {
+    const QualitySettings &quality = world().quality;
     float delta_s = elapsed_ms / 1000.0f;
 
-    for (Entity entity : registry.particles.entities)
+    auto &particle_registry = registry().particles;
+    for (uint i = 0; i < particle_registry.size(); i++)
     {
-        Particle &particle = registry.particles.get(entity);
+        Particle &particle = particle_registry.components[i];
+        Entity entity = particle_registry.entities[i];
 
         // Update life
         particle.Life -= delta_s;
@@ -101,18 +110,18 @@ void ParticleSystem::updateParticles(float elapsed_ms)
         // Remove dead particles
         if (particle.Life <= 0.0f)
         {
-            registry.remove_all_components_of(entity);
+            registry().deferred.destroy(entity);
             continue;
         }
 
         // Determine particle type from its generator
         std::string particle_type = "default";
-        Entity generator_entity;
+        Entity generator_entity = Entity::null();
 
         // Find the generator that created this particle
-        for (Entity gen_entity : registry.particleGenerators.entities)
+        for (Entity gen_entity : registry().particleGenerators.entities)
         {
-            ParticleGenerator &generator = registry.particleGenerators.get(gen_entity);
+            ParticleGenerator &generator = registry().particleGenerators.get(gen_entity);
 
             // Use a standard loop instead of std::find to avoid potential operator== issues
             bool found = false;
@@ -136,8 +145,8 @@ void ParticleSystem::updateParticles(float elapsed_ms)
         // Special handling for electricity particles
         if (particle_type == "electricity_line")
         {
-            // Flickering effect
-            if (randomFloat(0.0f, 1.0f) < 0.3f) // 30% chance per frame to flicker
+            // Flickering effect, skipped along with the jitter and spin below under load
+            if (quality.electricity_jitter && randomFloat(0.0f, 1.0f) < 0.3f) // 30% chance per frame to flicker
             {
                 // Randomly adjust brightness for flickering
                 float brightness = randomFloat(0.8f, 1.2f);
@@ -161,16 +170,19 @@ void ParticleSystem::updateParticles(float elapsed_ms)
             particle.Color.a = 0.7f + 0.3f * (particle.Life / particle.MaxLife);
 
             // Add jitter to velocity for more chaotic movement
-            particle.Velocity.x += randomFloat(-80.0f, 80.0f) * delta_s;
-            particle.Velocity.y += randomFloat(-80.0f, 80.0f) * delta_s;
+            if (quality.electricity_jitter)
+            {
+                particle.Velocity.x += randomFloat(-80.0f, 80.0f) * delta_s;
+                particle.Velocity.y += randomFloat(-80.0f, 80.0f) * delta_s;
+            }
 
             // Update position with jittery velocity
             particle.Position += particle.Velocity * delta_s;
 
             // Update motion component for rendering - electricity particles are larger
-            if (registry.motions.has(entity))
+            if (registry().motions.has(entity))
             {
-                Motion &motion = registry.motions.get(entity);
+                Motion &motion = registry().motions.modify(entity);
                 motion.position = particle.Position;
 
                 // Vary size for electricity with pulsing effect
@@ -178,7 +190,8 @@ void ParticleSystem::updateParticles(float elapsed_ms)
                 motion.scale = vec2(size_factor);
 
                 // Randomly rotate for more dynamic appearance
-                motion.angle += randomFloat(-10.0f, 10.0f);
+                if (quality.electricity_jitter)
+                    motion.angle += randomFloat(-10.0f, 10.0f);
             }
         }
         else
@@ -192,9 +205,9 @@ void ParticleSystem::updateParticles(float elapsed_ms)
             particle.Color.a = life_ratio;
 
             // Update motion component for rendering
-            if (registry.motions.has(entity))
+            if (registry().motions.has(entity))
             {
-                Motion &motion = registry.motions.get(entity);
+                Motion &motion = registry().motions.modify(entity);
                 motion.position = particle.Position;
                 motion.scale = vec2(10.0f * life_ratio);
             }
@@ -203,9 +216,9 @@ void ParticleSystem::updateParticles(float elapsed_ms)
             if (particle_type == "fire")
             {
                 // Fire particles grow slightly as they rise and fade
-                if (registry.motions.has(entity))
+                if (registry().motions.has(entity))
                 {
-                    registry.motions.get(entity).scale = vec2(10.0f + 5.0f * (1.0f - life_ratio));
+                    registry().motions.modify(entity).scale = vec2(10.0f + 5.0f * (1.0f - life_ratio));
                 }
 
                 // Slow down as they rise
@@ -224,9 +237,9 @@ void ParticleSystem::updateParticles(float elapsed_ms)
             {
                 // Pulsing effect for level-up particles
                 float pulse = (sin(particle.Life * 8.0f) * 0.2f) + 0.8f;
-                if (registry.motions.has(entity))
+                if (registry().motions.has(entity))
                 {
-                    registry.motions.get(entity).scale = vec2(10.0f * life_ratio * pulse);
+                    registry().motions.modify(entity).scale = vec2(10.0f * life_ratio * pulse);
                 }
 
                 // Increase brightness at pulse peaks
@@ -240,9 +253,9 @@ void ParticleSystem::updateParticles(float elapsed_ms)
         }
 
         // Update color component if it exists
-        if (registry.colors.has(entity))
+        if (registry().colors.has(entity))
         {
-            registry.colors.get(entity) = vec3(particle.Color);
+            registry().colors.get(entity) = vec3(particle.Color);
         }
     }
 }
@@ -252,7 +265,7 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
     Entity entity = Entity();
 
     // Create particle component
-    Particle &particle = registry.particles.emplace(entity);
+    Particle &particle = registry().particles.emplace(entity);
     particle.Position = position;
 
     // Randomize velocity based on type
@@ -261,13 +274,13 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         // Get sprite dimensions from the generator entity
         vec2 sprite_size = {50.0f, 50.0f}; // Default size in case motion isn't available
 
-        for (Entity gen_entity : registry.particleGenerators.entities)
+        for (Entity gen_entity : registry().particleGenerators.entities)
         {
-            if (registry.particleGenerators.has(gen_entity) &&
-                &registry.particleGenerators.get(gen_entity) == &generator &&
-                registry.motions.has(gen_entity))
+            if (registry().particleGenerators.has(gen_entity) &&
+                &registry().particleGenerators.get(gen_entity) == &generator &&
+                registry().motions.has(gen_entity))
             {
-                sprite_size = registry.motions.get(gen_entity).scale;
+                sprite_size = registry().motions.get(gen_entity).scale;
                 break;
             }
         }
@@ -308,13 +321,13 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
     {
         // Get sprite dimensions from the generator entity
         vec2 sprite_size = {50.0f, 50.0f}; // Default size in case motion isn't available
-        for (Entity gen_entity : registry.particleGenerators.entities)
+        for (Entity gen_entity : registry().particleGenerators.entities)
         {
-            if (registry.particleGenerators.has(gen_entity) &&
-                &registry.particleGenerators.get(gen_entity) == &generator &&
-                registry.motions.has(gen_entity))
+            if (registry().particleGenerators.has(gen_entity) &&
+                &registry().particleGenerators.get(gen_entity) == &generator &&
+                registry().motions.has(gen_entity))
             {
-                sprite_size = registry.motions.get(gen_entity).scale;
+                sprite_size = registry().motions.get(gen_entity).scale;
                 break;
             }
         }
@@ -358,13 +371,13 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
     {
         // Get sprite dimensions from the generator entity
         vec2 sprite_size = {50.0f, 50.0f}; // Default size
-        for (Entity gen_entity : registry.particleGenerators.entities)
+        for (Entity gen_entity : registry().particleGenerators.entities)
         {
-            if (registry.particleGenerators.has(gen_entity) &&
-                &registry.particleGenerators.get(gen_entity) == &generator &&
-                registry.motions.has(gen_entity))
+            if (registry().particleGenerators.has(gen_entity) &&
+                &registry().particleGenerators.get(gen_entity) == &generator &&
+                registry().motions.has(gen_entity))
             {
-                sprite_size = registry.motions.get(gen_entity).scale;
+                sprite_size = registry().motions.get(gen_entity).scale;
                 break;
             }
         }
@@ -406,13 +419,13 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         // Get sprite dimensions from the generator entity
         vec2 sprite_size = { 50.0f, 50.0f }; // Default size in case motion isn't available
 
-        for (Entity gen_entity : registry.particleGenerators.entities)
+        for (Entity gen_entity : registry().particleGenerators.entities)
         {
-            if (registry.particleGenerators.has(gen_entity) &&
-                &registry.particleGenerators.get(gen_entity) == &generator &&
-                registry.motions.has(gen_entity))
+            if (registry().particleGenerators.has(gen_entity) &&
+                &registry().particleGenerators.get(gen_entity) == &generator &&
+                registry().motions.has(gen_entity))
             {
-                sprite_size = registry.motions.get(gen_entity).scale;
+                sprite_size = registry().motions.get(gen_entity).scale;
                 break;
             }
         }
@@ -449,10 +462,10 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         vec2 end_pos = position; // Default initialization
 
         // Find generator entity
-        Entity generator_entity = Entity();
-        for (Entity e : registry.particleGenerators.entities)
+        Entity generator_entity = Entity::null();
+        for (Entity e : registry().particleGenerators.entities)
         {
-            if (&registry.particleGenerators.get(e) == &generator)
+            if (&registry().particleGenerators.get(e) == &generator)
             {
                 generator_entity = e;
                 break;
@@ -460,10 +473,10 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         }
 
         // OPTIMIZATION: Skip if too far from the player
-        if (registry.players.entities.size() > 0)
+        if (registry().players.entities.size() > 0)
         {
-            Entity player = registry.players.entities[0];
-            float dist_to_player = length(registry.motions.get(player).position - position);
+            Entity player = registry().players.entities[0];
+            float dist_to_player = length(registry().motions.get(player).position - position);
             if (dist_to_player > generator.max_visible_distance)
             {
                 return entity; // Early return, don't create particle if too far
@@ -471,13 +484,13 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         }
 
         // Find the end position (optimization: only when needed)
-        if (registry.motions.has(generator_entity))
+        if (registry().motions.has(generator_entity))
         {
-            for (int i = 0; i < registry.motions.size(); i++)
+            for (int i = 0; i < registry().motions.size(); i++)
             {
-                if (registry.motions.entities[i] == generator_entity && i > 0)
+                if (registry().motions.entities[i] == generator_entity && i > 0)
                 {
-                    end_pos = registry.motions.components[i].position;
+                    end_pos = registry().motions.components[i].position;
                     break;
                 }
             }
@@ -491,7 +504,7 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
 
         // Find which segment this particle belongs to - fewer segments for better performance
         const int NUM_MAIN_SEGMENTS = 15; // Reduced from 30
-        int segment_id = registry.particleGenerators.get(generator_entity).particles.size() % NUM_MAIN_SEGMENTS;
+        int segment_id = registry().particleGenerators.get(generator_entity).particles.size() % NUM_MAIN_SEGMENTS;
         float t = segment_id / (float)NUM_MAIN_SEGMENTS;
 
         // OPTIMIZATION: Use pre-computed curve control points from ElectricityData
@@ -499,9 +512,9 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         vec2 p3 = end_pos;
         vec2 p1, p2;
 
-        if (registry.customData.has(generator_entity))
+        if (registry().customData.has(generator_entity))
         {
-            ElectricityData &elec_data = registry.customData.get(generator_entity);
+            ElectricityData &elec_data = registry().customData.get(generator_entity);
             p1 = elec_data.curve_ctrl1;
             p2 = elec_data.curve_ctrl2;
 
@@ -528,7 +541,7 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         particle.Position = uuu * p0 + 3 * uu * t * p1 + 3 * u * tt * p2 + ttt * p3;
 
         // Add small jitter for natural look - but less computationally intensive
-        float jitter = sin(t * 25.0f + registry.particleGenerators.get(generator_entity).timer / 100.0f) * 8.0f;
+        float jitter = sin(t * 25.0f + registry().particleGenerators.get(generator_entity).timer / 100.0f) * 8.0f;
         particle.Position += perpendicular * jitter;
 
         // Calculate tangent in a simplified way
@@ -558,7 +571,7 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
 
                 // Create branch particle
                 Entity branch_particle = Entity();
-                Particle &b_particle = registry.particles.emplace(branch_particle);
+                Particle &b_particle = registry().particles.emplace(branch_particle);
                 b_particle.Position = branch_pos;
 
                 // Simple color calculation for branches
@@ -577,7 +590,7 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
                 b_particle.MaxLife = b_particle.Life;
 
                 // Add motion for rendering
-                Motion &b_motion = registry.motions.emplace(branch_particle);
+                Motion &b_motion = registry().motions.emplace(branch_particle);
                 b_motion.position = b_particle.Position;
                 b_motion.scale = vec2(15.0f); // Slightly larger for better visibility with fewer particles
                 b_motion.angle = atan2(branch_dir.y, branch_dir.x) * 180.0f / M_PI;
@@ -587,10 +600,10 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
                 render_request.used_texture = TEXTURE_ASSET_ID::PARTICLE;
                 render_request.used_effect = EFFECT_ASSET_ID::PARTICLE;
                 render_request.used_geometry = GEOMETRY_BUFFER_ID::SPRITE;
-                registry.renderRequests.insert(branch_particle, render_request);
+                registry().renderRequests.insert(branch_particle, render_request);
 
                 // Add to generator's particles list
-                ParticleGenerator &actual_generator = registry.particleGenerators.get(generator_entity);
+                ParticleGenerator &actual_generator = registry().particleGenerators.get(generator_entity);
                 actual_generator.particles.push_back(branch_particle);
             }
         }
@@ -612,9 +625,9 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
         particle.MaxLife = particle.Life;
 
         // Set up motion component for rendering with fewer updates
-        if (registry.motions.has(entity))
+        if (registry().motions.has(entity))
         {
-            Motion &motion = registry.motions.get(entity);
+            Motion &motion = registry().motions.modify(entity);
             motion.position = particle.Position;
             motion.scale = vec2(20.0f, 8.0f); // Wider for better connectivity with fewer particles
             motion.angle = atan2(tangent.y, tangent.x) * 180.0f / M_PI;
@@ -633,18 +646,18 @@ Entity ParticleSystem::createParticle(const ParticleGenerator &generator, vec2 p
     particle.Life = particle.MaxLife;
 
     // Add motion for rendering
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = particle.Position;
     motion.scale = vec2(10.0f); // Default size
 
     // Add render request using your existing textures and effects
     // Note: You'll need to add PARTICLE to your TEXTURE_ASSET_ID and EFFECT_ASSET_ID enums
-    registry.renderRequests.insert(
+    registry().renderRequests.insert(
         entity,
         {TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::PARTICLE, GEOMETRY_BUFFER_ID::SPRITE});
 
     // Add color for rendering (if your renderer uses this)
-    registry.colors.emplace(entity) = vec3(particle.Color);
+    registry().colors.emplace(entity) = vec3(particle.Color);
 
     return entity;
 }
@@ -654,11 +667,11 @@ Entity ParticleSystem::createBloodEffect(vec2 position, vec2 sprite_size)
     Entity entity = Entity();
 
     // Add motion component
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = position;
 
     // Add generator component
-    ParticleGenerator &generator = registry.particleGenerators.emplace(entity);
+    ParticleGenerator &generator = registry().particleGenerators.emplace(entity);
     generator.type = "blood_sprite"; // New type for whole-sprite blood
     generator.amount = 60;           // More particles needed
     generator.spawnInterval = 0.01f; // Burst quickly
@@ -677,11 +690,11 @@ Entity ParticleSystem::createFireEffect(vec2 position)
     Entity entity = Entity();
 
     // Add motion component
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = position;
 
     // Add generator component
-    ParticleGenerator &generator = registry.particleGenerators.emplace(entity);
+    ParticleGenerator &generator = registry().particleGenerators.emplace(entity);
     generator.type = "fire";
     generator.amount = 100;
     generator.spawnInterval = 0.05f; // Continuous fire
@@ -697,12 +710,12 @@ Entity ParticleSystem::createSeedGrowthEffect(vec2 position, vec2 sprite_size)
     Entity entity = Entity();
 
     // Add motion component
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = position;
     motion.scale = sprite_size; // Store size for proper coverage
 
     // Add generator component
-    ParticleGenerator &generator = registry.particleGenerators.emplace(entity);
+    ParticleGenerator &generator = registry().particleGenerators.emplace(entity);
     generator.type = "seed_growth";
     generator.amount = 80;           // More particles for better coverage
     generator.spawnInterval = 0.03f; // Faster emission rate
@@ -718,12 +731,12 @@ Entity ParticleSystem::createLevelUpEffect(vec2 position, vec2 sprite_size)
     Entity entity = Entity();
 
     // Add motion component
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = position;
     motion.scale = sprite_size; // Store size for aura calculation
 
     // Add generator component
-    ParticleGenerator &generator = registry.particleGenerators.emplace(entity);
+    ParticleGenerator &generator = registry().particleGenerators.emplace(entity);
     generator.type = "level_up";
     generator.amount = 120;
     generator.spawnInterval = 0.005f;
@@ -732,7 +745,7 @@ Entity ParticleSystem::createLevelUpEffect(vec2 position, vec2 sprite_size)
     generator.duration_ms = 1500.0f;
 
     // Store the player entity for following
-    generator.follow_entity = registry.players.entities[0];
+    generator.follow_entity = registry().players.entities[0];
 
     return entity;
 }
@@ -741,11 +754,11 @@ Entity ParticleSystem::createAOEEffect(vec2 position, vec2 sprite_size, int dura
 {
     Entity entity = Entity();
 
-    Motion& motion = registry.motions.emplace(entity);
+    Motion& motion = registry().motions.emplace(entity);
     motion.position = position;
     motion.scale = sprite_size;
 
-    ParticleGenerator& generator = registry.particleGenerators.emplace(entity);
+    ParticleGenerator& generator = registry().particleGenerators.emplace(entity);
     generator.type = type;
     generator.amount = type == "heal" ? 15 : 5;
     generator.spawnInterval = 0.1f;
@@ -762,13 +775,13 @@ Entity ParticleSystem::createElectricityEffect(vec2 start_point, vec2 end_point,
     Entity controller = Entity();
 
     // Add motion component for the controller entity
-    Motion &motion = registry.motions.emplace(controller);
+    Motion &motion = registry().motions.emplace(controller);
     motion.position = start_point;
     motion.scale = vec2(length(end_point - start_point), width);
     motion.angle = atan2(end_point.y - start_point.y, end_point.x - start_point.x) * 180.0f / M_PI;
 
     // Add generator component with OPTIMIZED particle count
-    ParticleGenerator &generator = registry.particleGenerators.emplace(controller);
+    ParticleGenerator &generator = registry().particleGenerators.emplace(controller);
     generator.type = "electricity_line";
     generator.amount = 100;           // Reduced from previous values for better performance
     generator.spawnInterval = 0.002f; // Slightly slower spawning to reduce CPU load
@@ -782,7 +795,7 @@ Entity ParticleSystem::createElectricityEffect(vec2 start_point, vec2 end_point,
     // Store the endpoint in a duplicate motion component for reference
     Motion endpoint_motion;
     endpoint_motion.position = end_point;
-    registry.motions.emplace_with_duplicates(controller, endpoint_motion);
+    registry().motions.emplace_with_duplicates(controller, endpoint_motion);
 
     // Pre-generate curve control points to avoid recalculating for each particle
     vec2 path = end_point - start_point;
@@ -791,8 +804,8 @@ Entity ParticleSystem::createElectricityEffect(vec2 start_point, vec2 end_point,
     vec2 perpendicular = vec2(-path_dir.y, path_dir.x);
 
     // Store curve data for later use
-    ElectricityData &elec_data = registry.customData.emplace(controller);
-    elec_data.noise_seed = (float)rand() / RAND_MAX * 1000.0f;
+    ElectricityData &elec_data = registry().customData.emplace(controller);
+    elec_data.noise_seed = rng(RandomStream::PARTICLES).uniform(0.0f, 1000.0f);
     elec_data.curve_ctrl1 = start_point + path * 0.33f + perpendicular * (sin(elec_data.noise_seed) * 30.0f);
     elec_data.curve_ctrl2 = start_point + path * 0.66f + perpendicular * (sin(elec_data.noise_seed * 1.5f) * 30.0f);
 
@@ -801,14 +814,19 @@ Entity ParticleSystem::createElectricityEffect(vec2 start_point, vec2 end_point,
 
 float ParticleSystem::randomFloat(float min, float max)
 {
-    return min + dist(gen) * (max - min);
+    if (random_next == RANDOM_BATCH)
+    {
+        rng(RandomStream::PARTICLES).fill_uniform(random_batch, RANDOM_BATCH);
+        random_next = 0;
+    }
+    return min + random_batch[random_next++] * (max - min);
 }
 
 void ParticleSystem::stopEffect(Entity generator_entity)
 {
-    if (registry.particleGenerators.has(generator_entity))
+    if (registry().particleGenerators.has(generator_entity))
     {
-        ParticleGenerator &generator = registry.particleGenerators.get(generator_entity);
+        ParticleGenerator &generator = registry().particleGenerators.get(generator_entity);
         generator.isActive = false;
     }
 }
\ No newline at end of file
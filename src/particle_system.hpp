@@ -1,8 +1,8 @@
 #pragma once
 
 #include "common.hpp"
+#include "random.hpp"
 #include "tinyECS/registry.hpp"
-#include <random>
 
 class RenderSystem;
 
@@ -26,10 +26,10 @@ public:
     static Entity createElectricityEffect(vec2 start_point, vec2 end_point, float width = 50.0f, float duration_ms = 500.0f);
 
 private:
-    // Random number generator
-    std::random_device rd;
-    std::mt19937 gen;
-    std::uniform_real_distribution<float> dist;
+    // Uniform floats drawn from the particle stream a batch at a time, randomFloat hands them out
+    static constexpr size_t RANDOM_BATCH = 64;
+    float random_batch[RANDOM_BATCH];
+    size_t random_next = RANDOM_BATCH;
 
     // Keep reference to renderer
     RenderSystem *renderer;
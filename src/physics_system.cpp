@@ -2,6 +2,8 @@
 #include "physics_system.hpp"
 #include "world_system.hpp"
 #include "world_init.hpp"
+#include "motion_kernels.hpp"
+#include "profiler.hpp"
 #include <iostream>
 
 PhysicsSystem::PhysicsSystem()
@@ -55,34 +57,27 @@ vec2 get_bounding_box(const Motion &motion)
 
 // This is a SUPER APPROXIMATE check that puts a circle around the bounding boxes and sees
 // if the center point of either object is inside the other's bounding-box-circle. You can
-// surely implement a more accurate detection
+// surely implement a more accurate detection. Checks of many bodies against one use the batched
+// kernel (batch_circles_overlap in motion_kernels.hpp), which gives the same answers
 bool PhysicsSystem::collides(const Motion &motion1, const Motion &motion2)
 {
-	vec2 dp = motion1.position - motion2.position;
-	float dist_squared = dot(dp, dp);
-	const vec2 other_bonding_box = get_bounding_box(motion1) / 2.f;
-	const float other_r_squared = dot(other_bonding_box, other_bonding_box);
-	const vec2 my_bonding_box = get_bounding_box(motion2) / 2.f;
-	const float my_r_squared = dot(my_bonding_box, my_bonding_box);
-	const float r_squared = max(other_r_squared, my_r_squared);
-	if (dist_squared < r_squared)
-		return true;
-	return false;
+	return circles_collide(motion1.position, bounding_radius_squared(motion1), motion2.position,
+						   bounding_radius_squared(motion2));
 }
 
 // Check if exactly one of the entities has a mesh
 bool only_one_mesh(Entity a, Entity b, Mesh*& mesh_1, Motion*& motion_1, Motion*& motion_2)
 {
-	if (registry.meshPtrs.has(a) && !registry.meshPtrs.has(b)) {
-		mesh_1 = registry.meshPtrs.get(a);
-		motion_1 = &registry.motions.get(a);
-		motion_2 = &registry.motions.get(b);
+	if (registry().meshPtrs.has(a) && !registry().meshPtrs.has(b)) {
+		mesh_1 = registry().meshPtrs.get(a);
+		motion_1 = &registry().motions.get(a);
+		motion_2 = &registry().motions.get(b);
 		return true;
 	}
-	if (!registry.meshPtrs.has(a) && registry.meshPtrs.has(b)) {
-		mesh_1 = registry.meshPtrs.get(b);
-		motion_1 = &registry.motions.get(b);
-		motion_2 = &registry.motions.get(a);
+	if (!registry().meshPtrs.has(a) && registry().meshPtrs.has(b)) {
+		mesh_1 = registry().meshPtrs.get(b);
+		motion_1 = &registry().motions.get(b);
+		motion_2 = &registry().motions.get(a);
 		return true;
 	}
 	return false;
@@ -95,7 +90,7 @@ float cross_product(vec2 a, vec2 b, vec2 c)
 }
 
 // Perform a box-point collision test
-bool collides_box_point(vec2& box_min, vec2& box_max, vec2& point)
+bool collides_box_point(const vec2& box_min, const vec2& box_max, const vec2& point)
 {
 	return (
 		box_min.x <= point.x && point.x <= box_max.x &&
@@ -104,7 +99,7 @@ bool collides_box_point(vec2& box_min, vec2& box_max, vec2& point)
 }
 
 // Perform a triangle-point collision test
-bool collides_triangle_point(std::vector<vec2>& triangle, vec2 point)
+bool collides_triangle_point(const vec2 *triangle, vec2 point)
 {
 	float cross_1 = cross_product(triangle[0], triangle[1], point);
 	float cross_2 = cross_product(triangle[1], triangle[2], point);
@@ -116,10 +111,10 @@ bool collides_triangle_point(std::vector<vec2>& triangle, vec2 point)
 }
 
 // Perform a triangle-AABB collision test
-bool collides_triangle_box(std::vector<vec2>& triangle, vec2& box_min, vec2& box_max)
+bool collides_triangle_box(const vec2 *triangle, vec2& box_min, vec2& box_max)
 {
 	// check if the triangle is inside the box
-	for (int i = 0; i < triangle.size(); i++) {
+	for (int i = 0; i < 3; i++) {
 		if (collides_box_point(box_min, box_max, triangle[i])) return true;
 	}
 
@@ -132,6 +127,29 @@ bool collides_triangle_box(std::vector<vec2>& triangle, vec2& box_min, vec2& box
 	return false;
 }
 
+// Whether a box placed by motion (at position + scale * corner, so flipped by a negative scale) may
+// touch the box around the points of span [span_min, span_max]. Never wrong about a point in the
+// local box: position + scale * x is monotonic in x, rounding included
+static bool placed_box_overlaps(const Motion &motion, vec2 local_min, vec2 local_max, vec2 span_min, vec2 span_max)
+{
+	vec2 a = motion.position + motion.scale * local_min;
+	vec2 b = motion.position + motion.scale * local_max;
+	// written so that NaNs never reject
+	return !(max(a.x, b.x) < span_min.x || min(a.x, b.x) > span_max.x ||
+			 max(a.y, b.y) < span_min.y || min(a.y, b.y) > span_max.y);
+}
+
+// Tests the count triangles of mesh from corner first on, placed by motion, against the box
+static bool collides_triangles_box(const Mesh &mesh, const Motion &motion, uint32_t first, uint32_t count, vec2 &box_min, vec2 &box_max)
+{
+	for (uint32_t i = first; i < first + count * 3; i += 3) {
+		vec2 triangle[3];
+		for (int corner = 0; corner < 3; corner++)
+			triangle[corner] = motion.position + motion.scale * mesh.triangles[i + corner];
+		if (collides_triangle_box(triangle, box_min, box_max)) return true;
+	}
+	return false;
+}
 
 // Perform a mesh-circle collision test (ignore other collisions)
 bool collides_mesh(Entity a, Entity b)
@@ -142,12 +160,39 @@ bool collides_mesh(Entity a, Entity b)
 	if (only_one_mesh(a, b, mesh_1, motion_1, motion_2)) {
 		vec2 box_min = vec2(motion_2->position.x - motion_2->scale.x / 2, motion_2->position.y - motion_2->scale.y / 2);
 		vec2 box_max = vec2(motion_2->position.x + motion_2->scale.x / 2, motion_2->position.y + motion_2->scale.y / 2);
-		for (int i = 0; i < mesh_1->vertex_indices.size(); i += 3) {
-			std::vector<vec2> triangle;
-			triangle.push_back(motion_1->position + motion_1->scale * vec2(mesh_1->vertices[mesh_1->vertex_indices[i]].position));
-			triangle.push_back(motion_1->position + motion_1->scale * vec2(mesh_1->vertices[mesh_1->vertex_indices[i + 1]].position));
-			triangle.push_back(motion_1->position + motion_1->scale * vec2(mesh_1->vertices[mesh_1->vertex_indices[i + 2]].position));
-			if (collides_triangle_box(triangle, box_min, box_max)) return true;
+		const Mesh &mesh = *mesh_1;
+		const Motion &motion = *motion_1;
+		// a hit needs a corner of the triangles in the box or a corner of the box in a triangle, both
+		// of which lie within the box the box's corners span
+		vec2 span_min = min(box_min, box_max);
+		vec2 span_max = max(box_min, box_max);
+
+		// most tests end at the bounds: the circle around the mesh, padded by more than rounding
+		// can move a corner, then its box
+		vec2 center = motion.position + motion.scale * mesh.bounding_center;
+		float radius = mesh.bounding_radius * max(abs(motion.scale.x), abs(motion.scale.y));
+		radius += 1e-3f * radius + 1e-5f * (abs(center.x) + abs(center.y)) + 1e-3f;
+		vec2 offset = center - clamp(center, span_min, span_max);
+		if (dot(offset, offset) > radius * radius) return false;
+		if (!placed_box_overlaps(motion, mesh.local_min, mesh.local_max, span_min, span_max)) return false;
+
+		if (mesh.bvh.empty())
+			return collides_triangles_box(mesh, motion, 0, (uint32_t)(mesh.triangles.size() / 3), box_min, box_max);
+		// depth-first through the nodes whose box reaches the span; the tree is balanced, so its
+		// depth is about log2 of the triangles
+		uint32_t stack[64];
+		int depth = 0;
+		stack[depth++] = 0;
+		while (depth > 0) {
+			const Mesh::BVHNode &node = mesh.bvh[stack[--depth]];
+			if (!placed_box_overlaps(motion, node.min, node.max, span_min, span_max)) continue;
+			if (node.count > 0) {
+				if (collides_triangles_box(mesh, motion, node.first, node.count, box_min, box_max)) return true;
+			}
+			else {
+				stack[depth++] = node.first + 1;
+				stack[depth++] = node.first;
+			}
 		}
 		return false;
 	}
@@ -158,232 +203,266 @@ bool collides_mesh(Entity a, Entity b)
 
 void PhysicsSystem::step(float elapsed_ms)
 {
-	if (!registry.screenStates.get(registry.screenStates.entities[0]).game_over && WorldSystem::get_game_screen() != GAME_SCREEN_ID::LEVEL_UP)
+	if (!registry().screenStates.get(registry().screenStates.entities[0]).game_over && WorldSystem::get_game_screen() != GAME_SCREEN_ID::LEVEL_UP)
 	{
 
 		// Move each entity that has motion (players, and even towers [they have 0 for velocity])
 		// based on how much time has passed, this is to (partially) avoid
 		// having entities move at different speed based on the machine.
-		auto &motion_registry = registry.motions;
-
-		for (uint i = 0; i < motion_registry.size(); i++)
+		auto &motion_registry = registry().motions;
+		integrate_motions(motion_registry.components.data(), motion_registry.size(), elapsed_ms / 1000.f);
+		for (size_t i = 0; i < motion_registry.size(); i++)
 		{
-
-			Motion &motion = motion_registry.components[i];
-			Entity entity = motion_registry.entities[i];
-			float step_seconds = elapsed_ms / 1000.f;
-			motion.position.x += step_seconds * motion.velocity.x;
-			motion.position.y += step_seconds * motion.velocity.y;
+			const vec2 velocity = motion_registry.components[i].velocity;
+			if (velocity.x != 0 || velocity.y != 0)
+				motion_registry.mark_changed_at(i);
 		}
+		// record what touches, and spread out the enemies that ended up on top of each other
+		body_collisions.step(elapsed_ms);
+		world().enemy_grid.build(registry().enemies.entities, motion_registry);
 
-		handle_projectile_collisions();
+		handle_projectile_collisions(elapsed_ms);
 		handle_arrows(elapsed_ms);
-		// // check for collisions between all moving entities
-		// ComponentContainer<Motion> &motion_container = registry.motions;
-		// for(uint i = 0; i < motion_container.components.size(); i++)
-		// {
-		// 	Motion& motion_i = motion_container.components[i];
-		// 	Entity entity_i = motion_container.entities[i];
-
-		// 	// note starting j at i+1 to compare all (i,j) pairs only once (and to not compare with itself)
-		// 	for(uint j = i+1; j < motion_container.components.size(); j++)
-		// 	{
-		// 		Motion& motion_j = motion_container.components[j];
-		// 		if (collides(motion_i, motion_j))
-		// 		{
-		// 			Entity entity_j = motion_container.entities[j];
-		// 			// Create a collisions event
-		// 			// We are abusing the ECS system a bit in that we potentially insert muliple collisions for the same entity
-		// 			// CK: why the duplication, except to allow searching by entity_id
-		// 			registry.collisions.emplace_with_duplicates(entity_i, entity_j);
-		// 			// registry.collisions.emplace_with_duplicates(entity_j, entity_i);
-		// 		}
-		// 	}
-		// }
+		// sync point: destroy the projectiles, arrows and towers recorded above
+		registry().flush_deferred();
+	}
+	else
+	{
+		// nothing moved, but enemies may have come or gone
+		world().enemy_grid.build(registry().enemies.entities, registry().motions);
 	}
 }
 
-void PhysicsSystem::handle_projectile_collisions()
+// No hit, from first_hit
+static constexpr size_t NO_HIT = SIZE_MAX;
+
+// The hit of a swept batch with the smallest time of impact that accept(entity) agrees to, the
+// first in the batch on a tie, or NO_HIT
+template <typename Accept>
+static size_t first_hit(const CircleBatch &batch, Accept &&accept)
 {
-	for (Entity projectile : registry.projectiles.entities)
+	size_t first = NO_HIT;
+	for (size_t i = 0; i < batch.size(); i++)
 	{
-		Motion &proj_motion = registry.motions.get(projectile);
-		Projectile &proj = registry.projectiles.get(projectile);
-
-		// Check collision with enemies
-		for (Entity enemy : registry.enemies.entities)
-		{
-			Motion &enemy_motion = registry.motions.get(enemy);
-
-			if (collides(proj_motion, enemy_motion) && collides_mesh(projectile, enemy))
-			{
-				// Get or create status component
-				StatusComponent *status_comp;
-				if (registry.statuses.has(enemy))
-				{
-					status_comp = &registry.statuses.get(enemy);
-				}
-				else
-				{
-					status_comp = &registry.statuses.emplace(enemy);
-				}
-
-				// Add attack status
-				Status attack_status{
-					"attack",
-					0.0f,
-					proj.damage};
-				status_comp->active_statuses.push_back(attack_status);
+		if (batch.hit(i) && (first == NO_HIT || batch.toi[i] < batch.toi[first]) && accept(batch.entities[i]))
+			first = i;
+	}
+	return first;
+}
 
-				// Add hit effect
-				registry.hitEffects.emplace_with_duplicates(enemy);
+static size_t first_hit(const CircleBatch &batch)
+{
+	return first_hit(batch, [](Entity) { return true; });
+}
 
-				// Remove projectile
-				if (!proj.invincible) {
-					registry.remove_all_components_of(projectile);
-				}
-				break;
-			}
-		}
+// The entities of grid that a circle of radius moving from `from` to `to` may have touched: those
+// around a rectangle along the way, reaching radius past both ends for the round caps
+static void query_swept(const SpatialGrid &grid, vec2 from, vec2 to, float radius, std::vector<Entity> &out)
+{
+	vec2 way = to - from;
+	float distance = length(way);
+	if (!(distance > 0))
+	{
+		grid.query_radius(to, radius, out);
+		return;
 	}
+	vec2 direction = way / distance;
+	grid.query_oriented_rect(from - direction * radius, direction, distance + 2 * radius, radius, out);
+}
 
-	// Check projectiles is out of window bounds
-	for (Entity projectile : registry.projectiles.entities)
+void PhysicsSystem::handle_projectile_collisions(float elapsed_ms)
+{
+	PROFILE_SCOPE("handle_projectile_collisions");
+	const SpatialGrid &enemy_grid = world().enemy_grid;
+	registry().view<Projectile, Motion>().each([&](Entity projectile, Projectile &proj, Motion &proj_motion)
 	{
-		if (!registry.motions.has(projectile))
+		// Check collision with the enemies along the way the projectile came this step, hitting the
+		// first one it reached (the first in the order of registry().enemies on a tie), so that fast
+		// projectiles cannot pass through an enemy between two steps
+		vec2 from = proj_motion.position - proj_motion.velocity * (elapsed_ms / 1000.f);
+		nearby.clear();
+		query_swept(enemy_grid, from, proj_motion.position, length(get_bounding_box(proj_motion) / 2.f), nearby);
+		order_like(registry().enemies, nearby, nearby_order);
+		circle_batch.clear();
+		for (Entity enemy : nearby)
 		{
-			continue;
+			if (const Motion *enemy_motion = registry().motions.try_get(enemy))
+				circle_batch.push(enemy, *enemy_motion);
 		}
-
-		Motion &motion = registry.motions.get(projectile);
-
-		// Check if projectile is out of window bounds
-		if (motion.position.x < -500 ||
-			motion.position.x > MAP_WIDTH_PX + 500 ||
-			motion.position.y < -500 ||
-			motion.position.y > MAP_HEIGHT_PX + 500)
+		if (batch_circles_sweep(circle_batch, proj_motion, from) == 0)
+			return;
+		size_t first = first_hit(circle_batch, [&](Entity enemy) { return collides_mesh(projectile, enemy); });
+		if (first == NO_HIT)
+			return;
+		Entity enemy = circle_batch.entities[first];
+
+		// Get or create status component
+		StatusComponent *status_comp;
+		if (registry().statuses.has(enemy))
 		{
-			// Remove projectile if it's out of bounds
-			registry.remove_all_components_of(projectile);
-			continue;
+			status_comp = &registry().statuses.get(enemy);
 		}
-	}
+		else
+		{
+			status_comp = &registry().statuses.emplace(enemy);
+		}
+
+		// Add attack status
+		Status attack_status{
+			"attack",
+			0.0f,
+			proj.damage};
+		status_comp->active_statuses.push_back(attack_status);
+		if (registry().plantAnimations.has(proj.source))
+			world().stats.add_damage(registry().plantAnimations.get(proj.source).id, proj.damage);
+
+		// Add hit effect
+		registry().hitEffects.emplace_with_duplicates(enemy);
+
+		// Remove projectile
+		if (!proj.invincible) {
+			registry().deferred.destroy(projectile);
+		}
+	});
+
+	// Check projectiles is out of window bounds
+	registry().view<Projectile, Motion>().each([&](Entity projectile, Projectile &, Motion &motion)
+	{
+		if (out_of_bounds(motion))
+			registry().deferred.destroy(projectile);
+	});
+}
+
+bool PhysicsSystem::out_of_bounds(const Motion &motion)
+{
+	// projectiles and arrows further than 500px outside the map are removed
+	return motion.position.x < -500 ||
+		   motion.position.x > MAP_WIDTH_PX + 500 ||
+		   motion.position.y < -500 ||
+		   motion.position.y > MAP_HEIGHT_PX + 500;
 }
 
 void PhysicsSystem::handle_arrows(float elapsed_ms)
 {
-	for (auto entity : registry.arrows.entities)
+	// the bodies skeleton arrows can hit, which stay put while the arrows are checked
+	player_batch.clear();
+	for (Entity player : registry().players.entities)
 	{
-		Arrow &arrow = registry.arrows.get(entity);
+		if (const Motion *player_motion = registry().motions.try_get(player))
+			player_batch.push(player, *player_motion);
+	}
+	tower_batch.clear();
+	for (Entity tower : registry().towers.entities)
+	{
+		if (const Motion *tower_motion = registry().motions.try_get(tower))
+			tower_batch.push(tower, *tower_motion);
+	}
+
+	auto &arrow_registry = registry().arrows;
+	for (uint i = 0; i < arrow_registry.size(); i++)
+	{
+		Arrow &arrow = arrow_registry.components[i];
+		Entity entity = arrow_registry.entities[i];
 
 		// Update lifetime
 		arrow.lifetime_ms -= elapsed_ms;
 		if (arrow.lifetime_ms <= 0)
 		{
-			registry.remove_all_components_of(entity);
+			registry().deferred.destroy(entity);
 			continue;
 		}
 
 		// Skip if no motion component
-		if (!registry.motions.has(entity))
+		if (!registry().motions.has(entity))
 		{
 			continue;
 		}
 
-		Motion &motion = registry.motions.get(entity);
+		Motion &motion = registry().motions.get(entity);
 		Entity source = arrow.source;
+		bool hit = false;
 
-		// If arrow was fired by skeleton, check collision with player and towers
-		if (registry.skeletons.has(source))
+		// If arrow was fired by skeleton, check collision with player and towers along the way it
+		// came this step, hitting whichever it reached first (the player on a tie)
+		if (registry().skeletons.has(source))
 		{
+			vec2 from = motion.position - motion.velocity * (elapsed_ms / 1000.f);
+			size_t player_hit = batch_circles_sweep(player_batch, motion, from) ? first_hit(player_batch) : NO_HIT;
+			size_t tower_hit = batch_circles_sweep(tower_batch, motion, from) ? first_hit(tower_batch) : NO_HIT;
+			if (player_hit != NO_HIT && tower_hit != NO_HIT && tower_batch.toi[tower_hit] < player_batch.toi[player_hit])
+				player_hit = NO_HIT;
+
 			// Check collision with player
-			for (auto player : registry.players.entities)
+			if (player_hit != NO_HIT)
 			{
-				if (!registry.motions.has(player))
-					continue;
+				Entity player = player_batch.entities[player_hit];
 
-				Motion &player_motion = registry.motions.get(player);
-				if (collides(motion, player_motion))
-				{
-					// play the hit sound
-					Mix_PlayChannel(2, injured_sound, 0);
-
-					// Get or create status component for player
-					StatusComponent *status_comp;
-					if (registry.statuses.has(player))
-					{
-						status_comp = &registry.statuses.get(player);
-					}
-					else
-					{
-						status_comp = &registry.statuses.emplace(player);
-					}
+				// play the hit sound
+				Mix_PlayChannel(2, injured_sound, 0);
 
-					// Add attack status to apply damage
-					Status attack_status{
-						"attack",
-						0.0f,
-						arrow.damage};
-						status_comp->active_statuses.push_back(attack_status);
-						
+				// Get or create status component for player
+				StatusComponent *status_comp;
+				if (registry().statuses.has(player))
+				{
+					status_comp = &registry().statuses.get(player);
+				}
+				else
+				{
+					status_comp = &registry().statuses.emplace(player);
+				}
 
-					// Add hit effect for visual feedback
-					registry.hitEffects.emplace_with_duplicates(player);
+				// Add attack status to apply damage
+				Status attack_status{
+					"attack",
+					0.0f,
+					arrow.damage};
+					status_comp->active_statuses.push_back(attack_status);
+					
 
-					// Apply screen shake if screen state exists
-					if (registry.screenStates.entities.size() > 0)
-					{
-						auto &screen = registry.screenStates.get(registry.screenStates.entities[0]);
-						screen.shake_duration_ms = 200.0f;
-						screen.shake_intensity = 5.0f;
-					}
+				// Add hit effect for visual feedback
+				registry().hitEffects.emplace_with_duplicates(player);
 
-					// Remove arrow after hitting
-					registry.remove_all_components_of(entity);
-					break;
+				// Apply screen shake if screen state exists
+				if (registry().screenStates.entities.size() > 0)
+				{
+					auto &screen = registry().screenStates.get(registry().screenStates.entities[0]);
+					screen.shake_duration_ms = 200.0f;
+					screen.shake_intensity = 5.0f;
 				}
+
+				// Remove arrow after hitting
+				registry().deferred.destroy(entity);
+				hit = true;
 			}
 
 			// Check collision with towers
-			for (auto tower : registry.towers.entities)
+			else if (tower_hit != NO_HIT)
 			{
-				if (!registry.motions.has(tower))
-					continue;
+				Entity tower = tower_batch.entities[tower_hit];
 
-				Motion &tower_motion = registry.motions.get(tower);
-				if (collides(motion, tower_motion))
+				// Deal damage to tower
+				if (registry().towers.has(tower))
 				{
-					// Deal damage to tower
-					if (registry.towers.has(tower))
-					{
-						registry.towers.get(tower).health -= arrow.damage;
+					registry().towers.modify(tower).health -= arrow.damage;
 
-						// Add hit effect for visual feedback
-						registry.hitEffects.emplace_with_duplicates(tower);
+					// Add hit effect for visual feedback
+					registry().hitEffects.emplace_with_duplicates(tower);
 
-						// Check if tower is destroyed
-						if (registry.towers.get(tower).health <= 0)
-						{
-							registry.remove_all_components_of(tower);
-						}
+					// Check if tower is destroyed
+					if (registry().towers.get(tower).health <= 0)
+					{
+						registry().deferred.destroy(tower);
 					}
-
-					// Remove arrow after hitting
-					registry.remove_all_components_of(entity);
-					break;
 				}
+
+				// Remove arrow after hitting
+				registry().deferred.destroy(entity);
+				hit = true;
 			}
 		}
 
 		// Check if arrow is out of window bounds
-		if (motion.position.x < -500 ||
-			motion.position.x > MAP_WIDTH_PX + 500 ||
-			motion.position.y < 0 - 500 ||
-			motion.position.y > MAP_HEIGHT_PX + 500)
-		{
-			// Remove arrow if it's out of bounds
-			registry.remove_all_components_of(entity);
-			continue;
-		}
+		if (!hit && out_of_bounds(motion))
+			registry().deferred.destroy(entity);
 	}
 }
@@ -4,6 +4,9 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "motion_kernels.hpp"
+#include "broadphase.hpp"
+#include "spatial_grid.hpp"
 
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
@@ -23,8 +26,16 @@ public:
 	static bool collides(const Motion &motion1, const Motion &motion2);
 
 private:
-	void handle_projectile_collisions();
+	void handle_projectile_collisions(float elapsed_ms);
 	void handle_arrows(float elapsed_ms);
+	static bool out_of_bounds(const Motion &motion);
+
+	std::vector<Entity> nearby; // enemies found in the grid, reused every query
+	std::vector<OrderKey> nearby_order;
+	CircleBatch circle_batch;	// nearby's bounding circles
+	CircleBatch player_batch;	// the players and towers, for the arrows
+	CircleBatch tower_batch;
+	BodyCollisions body_collisions;
 
 	Mix_Chunk *injured_sound;
 };
\ No newline at end of file
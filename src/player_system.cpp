@@ -6,9 +6,9 @@
 
 void PlayerSystem::step(float elapsed_ms)
 {
-    Entity player = registry.players.entities[0];
-    State& state = registry.states.get(player);
-    Motion& motion = registry.motions.get(player);
+    Entity player = registry().players.entities[0];
+    State& state = registry().states.get(player);
+    Motion& motion = registry().motions.get(player);
 
     if (state.state == STATE::IDLE) {
         if (motion.velocity != vec2(0, 0))
@@ -19,7 +19,7 @@ void PlayerSystem::step(float elapsed_ms)
             update_state(STATE::IDLE);
     }
     else if (state.state == STATE::ATTACK) {
-        if (!registry.animations.has(player))
+        if (!registry().animations.has(player))
             update_state(STATE::IDLE);
     }
 }
@@ -31,8 +31,8 @@ void PlayerSystem::step(float elapsed_ms)
 */
 void PlayerSystem::update_state(STATE state_new)
 {
-    Entity player = registry.players.entities[0];
-    State& state = registry.states.get(player);
+    Entity player = registry().players.entities[0];
+    State& state = registry().states.get(player);
 
     if (state.state != state_new) {
         state.state = state_new;
@@ -51,7 +51,7 @@ void PlayerSystem::update_state(STATE state_new)
 
 STATE PlayerSystem::get_state() {
     if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::SPLASH || WorldSystem::get_game_screen() == GAME_SCREEN_ID::CG) return STATE::STATE_COUNT;
-    Entity player = registry.players.entities[0];
-    State& state = registry.states.get(player);
+    Entity player = registry().players.entities[0];
+    State& state = registry().states.get(player);
     return state.state;
 }
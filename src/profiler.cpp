@@ -0,0 +1,122 @@
+// internal
+#include "profiler.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char *name;
+		uint64_t start_ns;
+		uint64_t end_ns;
+	};
+
+	// One thread's events; only that thread writes, so `written` is the only shared state
+	struct TraceBuffer
+	{
+		TraceEvent events[Profiler::EVENTS_PER_THREAD];
+		std::atomic<uint64_t> written{0};
+		unsigned int thread_index = 0;
+	};
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	// every thread's buffer, in the order the threads first recorded. Buffers are never freed, a
+	// thread may end before its events are written out
+	std::mutex buffers_mutex;
+	std::vector<TraceBuffer *> buffers;
+
+	thread_local TraceBuffer *thread_buffer = nullptr;
+
+	// Writes ns as microseconds with three decimals, exactly: a double in the stream's default format
+	// keeps 6 digits, which a second into the run rounds timestamps to tenths of a millisecond
+	void write_microseconds(std::ostream &out, uint64_t ns)
+	{
+		out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+	}
+
+	TraceBuffer *register_thread()
+	{
+		TraceBuffer *buffer = new TraceBuffer();
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		buffer->thread_index = (unsigned int)buffers.size();
+		buffers.push_back(buffer);
+		return buffer;
+	}
+}
+
+void Profiler::start()
+{
+	recording.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stop()
+{
+	recording.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::clear()
+{
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	for (TraceBuffer *buffer : buffers)
+		buffer->written.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::record(const char *name, uint64_t start_ns, uint64_t end_ns)
+{
+	if (!thread_buffer)
+		thread_buffer = register_thread();
+	uint64_t written = thread_buffer->written.load(std::memory_order_relaxed);
+	thread_buffer->events[written % EVENTS_PER_THREAD] = {name, start_ns, end_ns};
+	thread_buffer->written.store(written + 1, std::memory_order_release);
+}
+
+bool Profiler::write_chrome_trace(const std::string &path)
+{
+	std::ofstream out(path, std::ios::trunc);
+	if (!out)
+	{
+		std::cerr << "ERROR: cannot write the profile to " << path << std::endl;
+		return false;
+	}
+
+	// complete ("X") events, timestamps in microseconds
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	size_t event_count = 0;
+	for (TraceBuffer *buffer : buffers)
+	{
+		out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_index
+			<< ",\"args\":{\"name\":\"thread " << buffer->thread_index << "\"}}";
+		first = false;
+
+		uint64_t written = buffer->written.load(std::memory_order_acquire);
+		uint64_t begin = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+		for (uint64_t i = begin; i < written; i++)
+		{
+			const TraceEvent &event = buffer->events[i % EVENTS_PER_THREAD];
+			out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index
+				<< ",\"ts\":";
+			write_microseconds(out, event.start_ns);
+			out << ",\"dur\":";
+			write_microseconds(out, event.end_ns - event.start_ns);
+			out << "}";
+		}
+		event_count += written - begin;
+	}
+	out << "\n]}\n";
+	std::cout << "Wrote " << event_count << " profile events to " << path << std::endl;
+	return bool(out);
+}
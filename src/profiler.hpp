@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timers for systems and their expensive phases, exported as a Chrome trace_event file
+// (open it in chrome://tracing or ui.perfetto.dev).
+//
+//   void PhysicsSystem::handle_projectile_collisions()
+//   {
+//       PROFILE_SCOPE("handle_projectile_collisions");
+//       ...
+//
+// Every thread records into its own ring buffer, so recording takes no lock; when a buffer is full
+// the oldest events are overwritten. Nothing is recorded until start(), and a scope outside a
+// recording costs one relaxed atomic load.
+class Profiler
+{
+public:
+	// Events kept per thread, the last ones win
+	static constexpr uint32_t EVENTS_PER_THREAD = 1 << 16;
+
+	static void start();
+	static void stop();
+	static bool is_recording() { return recording.load(std::memory_order_relaxed); }
+
+	// Forgets the recorded events
+	static void clear();
+
+	// Writes the recorded events as Chrome trace_event JSON; call it while no thread records
+	// (e.g. after stop(), between frames). Returns false if the file cannot be written
+	static bool write_chrome_trace(const std::string &path);
+
+	// Nanoseconds on a steady clock, since the profiler's first use
+	static uint64_t now_ns();
+
+	// Adds a finished scope to the calling thread's buffer
+	static void record(const char *name, uint64_t start_ns, uint64_t end_ns);
+
+private:
+	static inline std::atomic<bool> recording{false};
+};
+
+// Times the enclosing scope while the profiler records. name must outlive the recording
+// (a string literal, or a name registered for the program's lifetime)
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char *name)
+		: name(name), active(Profiler::is_recording()), start_ns(active ? Profiler::now_ns() : 0)
+	{
+	}
+	~ProfileScope()
+	{
+		if (active)
+			Profiler::record(name, start_ns, Profiler::now_ns());
+	}
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+	const char *name;
+	bool active;
+	uint64_t start_ns;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
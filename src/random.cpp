@@ -0,0 +1,46 @@
+// internal
+#include "random.hpp"
+#include "world.hpp"
+
+namespace
+{
+	uint64_t splitmix64(uint64_t &x)
+	{
+		uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+}
+
+void Rng::seed(uint64_t key)
+{
+	uint64_t a = splitmix64(key);
+	uint64_t b = splitmix64(key);
+	s[0] = (uint32_t)a;
+	s[1] = (uint32_t)(a >> 32);
+	s[2] = (uint32_t)b;
+	s[3] = (uint32_t)(b >> 32);
+	// the all-zero state is the one state xoshiro never leaves
+	if ((s[0] | s[1] | s[2] | s[3]) == 0)
+		s[0] = 1;
+}
+
+void Rng::fill_uniform(float *out, size_t count, float min, float max)
+{
+	const float scale = (max - min) * (1.0f / 16777216.0f);
+	for (size_t i = 0; i < count; i++)
+		out[i] = min + (next_u32() >> 8) * scale;
+}
+
+void RandomService::seed(uint32_t seed)
+{
+	session_seed = seed;
+	for (size_t i = 0; i < (size_t)RandomStream::STREAM_COUNT; i++)
+		streams[i].seed((uint64_t)seed << 32 | i);
+}
+
+Rng &rng(RandomStream id)
+{
+	return world().random.stream(id);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// xoshiro128** (Blackman & Vigna): 128 bits of state, a few shifts and rotates per 32-bit draw, and
+// no tables, unlike std::mt19937 behind a std::uniform_real_distribution
+class Rng
+{
+public:
+	Rng() { seed(0); }
+	explicit Rng(uint64_t key) { seed(key); }
+
+	// Derives the whole state from key with splitmix64, so nearby keys give unrelated sequences
+	void seed(uint64_t key);
+
+	uint32_t next_u32()
+	{
+		const uint32_t result = rotl(s[1] * 5, 7) * 9;
+		const uint32_t t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 11);
+		return result;
+	}
+
+	// Uniform in [0, 1), from the top 24 bits so every value is exact in a float
+	float uniform() { return (next_u32() >> 8) * (1.0f / 16777216.0f); }
+	// Uniform in [min, max)
+	float uniform(float min, float max) { return min + uniform() * (max - min); }
+	// Uniform in [0, n), n > 0 (Lemire's multiply-shift; the bias is below 2^-32 * n)
+	uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next_u32() * n) >> 32); }
+	// True with probability p
+	bool chance(float p) { return uniform() < p; }
+
+	// Writes count uniform floats in [min, max), for callers that need many at once
+	void fill_uniform(float *out, size_t count, float min = 0.0f, float max = 1.0f);
+
+private:
+	uint32_t s[4];
+
+	static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+};
+
+// The game's random streams, one per consumer. Each is derived from the session seed and its own
+// index, so a system draws the same sequence whatever the others do, and adding a draw in one
+// system does not shift every other. A stream belongs to systems that never run concurrently.
+enum class RandomStream
+{
+	WORLD,	   // WorldSystem: screen shake
+	LEVEL_UP,  // WorldSystem: the seeds offered on level-up
+	SPAWN,	   // SpawnManager: spawn points and enemy types
+	PARTICLES, // ParticleSystem, and the effects created for it
+	STREAM_COUNT
+};
+
+// A world's streams, see World::random
+class RandomService
+{
+public:
+	RandomService() { seed(session_seed); }
+
+	// Restarts every stream from session_seed; call it before the systems are created. A replay
+	// restores the seed, so the same input gives the same game
+	void seed(uint32_t session_seed);
+	uint32_t get_seed() const { return session_seed; }
+
+	Rng &stream(RandomStream id) { return streams[(size_t)id]; }
+
+private:
+	uint32_t session_seed = 1;
+	Rng streams[(size_t)RandomStream::STREAM_COUNT];
+};
+
+// Stream id of the world bound to the calling thread (world().random.stream(id))
+Rng &rng(RandomStream id);
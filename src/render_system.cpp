@@ -5,6 +5,7 @@
 
 // internal
 #include "render_system.hpp"
+#include "profiler.hpp"
 #include "tinyECS/registry.hpp"
 #include "world_system.hpp"
 #include <glm/gtc/type_ptr.hpp>
@@ -14,7 +15,7 @@ void RenderSystem::drawGridLine(Entity entity,
 								const mat3 &projection)
 {
 
-	GridLine &gridLine = registry.gridLines.get(entity);
+	GridLine &gridLine = registry().gridLines.get(entity);
 
 	// Transformation code, see Rendering and Transformation in the template
 	// specification for more info Incrementally updates transformation matrix,
@@ -23,8 +24,8 @@ void RenderSystem::drawGridLine(Entity entity,
 	transform.translate(gridLine.start_pos);
 	transform.scale(gridLine.end_pos);
 
-	assert(registry.renderRequests.has(entity));
-	const RenderRequest &render_request = registry.renderRequests.get(entity);
+	assert(registry().renderRequests.has(entity));
+	const RenderRequest &render_request = registry().renderRequests.get(entity);
 
 	const GLuint used_effect_enum = (GLuint)render_request.used_effect;
 	assert(used_effect_enum != (GLuint)EFFECT_ASSET_ID::EFFECT_COUNT);
@@ -70,7 +71,7 @@ void RenderSystem::drawGridLine(Entity entity,
 
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
-	const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+	const vec3 color = registry().colors.has(entity) ? registry().colors.get(entity) : vec3(1);
 	glUniform3fv(color_uloc, 1, (float *)&color);
 	gl_has_errors();
 
@@ -100,24 +101,24 @@ void RenderSystem::drawGridLine(Entity entity,
 void RenderSystem::drawTexturedMesh(Entity entity,
 									const mat3 &projection)
 {
-	Motion &motion = registry.motions.get(entity);
+	Motion &motion = registry().motions.get(entity);
 	// Transformation code, see Rendering and Transformation in the template
 	// specification for more info Incrementally updates transformation matrix,
 	// thus ORDER IS IMPORTANT
 
 	// Get visual scale if available, otherwise use {1,1}
 	vec2 visualScale = {1.0f, 1.0f};
-	if (registry.visualScales.has(entity))
+	if (registry().visualScales.has(entity))
 	{
-		visualScale = registry.visualScales.get(entity).scale;
+		visualScale = registry().visualScales.get(entity).scale;
 	}
 	Transform transform;
-	transform.translate(motion.position);
+	transform.translate(interpolation.position(entity, motion));
 	transform.scale(motion.scale * visualScale);
-	transform.rotate(radians(motion.angle));
+	transform.rotate(radians(interpolation.angle(entity, motion)));
 
-	assert(registry.renderRequests.has(entity));
-	const RenderRequest &render_request = registry.renderRequests.get(entity);
+	assert(registry().renderRequests.has(entity));
+	const RenderRequest &render_request = registry().renderRequests.get(entity);
 
 	const GLuint used_effect_enum = (GLuint)render_request.used_effect;
 	assert(used_effect_enum != (GLuint)EFFECT_ASSET_ID::EFFECT_COUNT);
@@ -161,9 +162,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		glActiveTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		assert(registry.renderRequests.has(entity));
+		assert(registry().renderRequests.has(entity));
 		GLuint texture_id =
-			texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+			texture_gl_handles[(GLuint)registry().renderRequests.get(entity).used_texture];
 
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
@@ -188,16 +189,16 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 		// handle alpha
 		float alpha = 1.0f;
-		if (registry.deathAnimations.has(entity))
+		if (registry().deathAnimations.has(entity))
 		{
-			alpha = registry.deathAnimations.get(entity).alpha;
+			alpha = registry().deathAnimations.get(entity).alpha;
 		}
 		GLint alpha_loc = glGetUniformLocation(program, "alpha");
 		glUniform1f(alpha_loc, alpha);
 		gl_has_errors();
 
 		// handle hit effect
-		bool zombie_is_hit = registry.hitEffects.has(entity);
+		bool zombie_is_hit = registry().hitEffects.has(entity);
 		GLint hit_loc = glGetUniformLocation(program, "zombie_is_hit");
 		glUniform1i(hit_loc, zombie_is_hit);
 		gl_has_errors();
@@ -206,9 +207,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		glActiveTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		assert(registry.renderRequests.has(entity));
+		assert(registry().renderRequests.has(entity));
 		GLuint texture_id =
-			texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+			texture_gl_handles[(GLuint)registry().renderRequests.get(entity).used_texture];
 
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
@@ -231,7 +232,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 			(void *)sizeof(vec3)); // note the stride to skip the preceeding vertex position
 
 		// handle hit effect
-		bool player_is_hit = registry.hitEffects.has(entity);
+		bool player_is_hit = registry().hitEffects.has(entity);
 		GLint hit_loc = glGetUniformLocation(program, "player_is_hit");
 		glUniform1i(hit_loc, player_is_hit);
 		gl_has_errors();
@@ -240,9 +241,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		glActiveTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		assert(registry.renderRequests.has(entity));
+		assert(registry().renderRequests.has(entity));
 		GLuint texture_id =
-			texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+			texture_gl_handles[(GLuint)registry().renderRequests.get(entity).used_texture];
 
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
@@ -282,9 +283,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 		// Pass color as vec4 including alpha
 		vec4 particleColor = {1.0f, 1.0f, 1.0f, 1.0f};
-		if (registry.particles.has(entity))
+		if (registry().particles.has(entity))
 		{
-			Particle &particle = registry.particles.get(entity);
+			Particle &particle = registry().particles.get(entity);
 			particleColor = particle.Color;
 		}
 
@@ -294,12 +295,12 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 		// Set particle type based on the particle's generator type
 		int particleType = 0; // Default type for regular particles
-		if (registry.particles.has(entity))
+		if (registry().particles.has(entity))
 		{
 			// Find the generator that created this particle
-			for (Entity gen_entity : registry.particleGenerators.entities)
+			for (Entity gen_entity : registry().particleGenerators.entities)
 			{
-				const ParticleGenerator &generator = registry.particleGenerators.get(gen_entity);
+				const ParticleGenerator &generator = registry().particleGenerators.get(gen_entity);
 
 				// Check if this particle is in this generator's list
 				bool found = false;
@@ -335,9 +336,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 		// Pass life ratio for visual effects
 		float lifeRatio = 1.0f;
-		if (registry.particles.has(entity))
+		if (registry().particles.has(entity))
 		{
-			Particle &particle = registry.particles.get(entity);
+			Particle &particle = registry().particles.get(entity);
 			lifeRatio = particle.Life / particle.MaxLife;
 		}
 
@@ -353,7 +354,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		gl_has_errors();
 
 		GLuint texture_id =
-			texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+			texture_gl_handles[(GLuint)registry().renderRequests.get(entity).used_texture];
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 		gl_has_errors();
 	}
@@ -364,7 +365,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
-	const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+	const vec3 color = registry().colors.has(entity) ? registry().colors.get(entity) : vec3(1);
 	glUniform3fv(color_uloc, 1, (float *)&color);
 	gl_has_errors();
 
@@ -420,8 +421,8 @@ void RenderSystem::drawToScreen()
 																	 // indices to the bound GL_ARRAY_BUFFER
 	gl_has_errors();
 
-	ScreenState &screen = registry.screenStates.get(screen_state_entity);
-	// if (!WorldSystem::game_is_over) {
+	ScreenState &screen = registry().screenStates.get(screen_state_entity);
+	// if (!world().game_is_over) {
 	if (1) {
 		// add the "UI" effect
 		const GLuint ui_program = effects[(GLuint)EFFECT_ASSET_ID::UI];
@@ -459,7 +460,7 @@ void RenderSystem::drawToScreen()
 		// std::cout<<screen.lerp_timer/2000<<std::endl;
 		glUniform1f(time_uloc1, screen.lerp_timer);
 		glUniform1f(game_continues_uloc1, screen.game_over);
-		glUniform2f(tex_offset_uloc, registry.motions.get(registry.players.entities[0]).position.x, registry.motions.get(registry.players.entities[0]).position.y);
+		glUniform2f(tex_offset_uloc, registry().motions.get(registry().players.entities[0]).position.x, registry().motions.get(registry().players.entities[0]).position.y);
 		glEnableVertexAttribArray(in_position_loc1);
 		glVertexAttribPointer(in_position_loc1, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void *)0);
 		gl_has_errors();
@@ -483,6 +484,7 @@ void RenderSystem::drawToScreen()
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 void RenderSystem::step_and_draw(float elapsed_ms)
 {
+	PROFILE_SCOPE("draw");
 	// Getting size of window
 	int w, h;
 	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
@@ -506,21 +508,21 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 							  // and alpha blending, one would have to sort
 							  // sprites back to front
 	gl_has_errors();
-	int cutscene = registry.screenStates.components[0].cutscene;
+	int cutscene = registry().screenStates.components[0].cutscene;
 	mat3 projection_2D = (WorldSystem::get_game_screen() == GAME_SCREEN_ID::SPLASH || WorldSystem::get_game_screen() == GAME_SCREEN_ID::CG || WorldSystem::get_game_screen() == GAME_SCREEN_ID::GAME_OVER) ? createProjectionMatrix_splash() : createProjectionMatrix();
 
 	if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::SPLASH || WorldSystem::get_game_screen() == GAME_SCREEN_ID::CG || WorldSystem::get_game_screen() == GAME_SCREEN_ID::GAME_OVER)
 	{
-		for (Entity entity : registry.cgs.entities)
+		for (Entity entity : registry().cgs.entities)
 		{
-			if (registry.renderRequests.has(entity)) drawTexturedMesh(entity, projection_2D);
+			if (registry().renderRequests.has(entity)) drawTexturedMesh(entity, projection_2D);
 		}
 
 		if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::SPLASH) {
 			renderText("Farmer Defense", WINDOW_WIDTH_PX / 3, WINDOW_HEIGHT_PX - 100, OS_RES, {0, 0, 0}, trans);
 		} else if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::CG) {
-			int cg_idx = registry.screenStates.components[0].cg_index;
-			int cutscene = registry.screenStates.components[0].cutscene;
+			int cg_idx = registry().screenStates.components[0].cg_index;
+			int cutscene = registry().screenStates.components[0].cutscene;
 			if (cutscene == 1)
 			{
 				if (cg_idx == 0)
@@ -576,8 +578,8 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 					renderText("Alright...", 60, 350, 0.6 * OS_RES, {1, 1, 1}, trans);
 			}
 		} else if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::GAME_OVER) {
-			for (Entity text_entity : registry.texts.entities) {
-				renderText(registry.texts.get(text_entity).text, registry.texts.get(text_entity).pos.x, registry.texts.get(text_entity).pos.y, registry.texts.get(text_entity).size, registry.texts.get(text_entity).color, trans);
+			for (Entity text_entity : registry().texts.entities) {
+				renderText(registry().texts.get(text_entity).text, registry().texts.get(text_entity).pos.x, registry().texts.get(text_entity).pos.y, registry().texts.get(text_entity).size, registry().texts.get(text_entity).color, trans);
 			}
 
 			renderText("GAME OVER", WINDOW_WIDTH_PX * 0.25, WINDOW_HEIGHT_PX * 0.8, 2.0f, glm::vec3(0.0f, 0.0f, 0.0f), trans);
@@ -585,47 +587,37 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 
 		drawToScreen();
 	} else {
-		// draw all entities with a render request to the frame buffer
-		for (Entity entity : registry.renderRequests.entities)
+		// draw all entities with a render request and a motion to the frame buffer, in render request order;
+		// camera-following entities are drawn on top further below
+		bool tutorial = WorldSystem::get_game_screen() == GAME_SCREEN_ID::TUTORIAL;
+		registry().view<RenderRequest>().each([&](Entity entity, RenderRequest &request)
 		{
-			// filter to entities that have a motion component
-			if (registry.motions.has(entity) && registry.renderRequests.get(entity).used_geometry != GEOMETRY_BUFFER_ID::DEBUG_LINE && !registry.moveWithCameras.has(entity))
+			if (registry().has_all<Motion>(entity) && request.used_geometry != GEOMETRY_BUFFER_ID::DEBUG_LINE && registry().has_none<MoveWithCamera>(entity))
 			{
-				// Note, its not very efficient to access elements indirectly via the entity
-				// albeit iterating through all Sprites in sequence. A good point to optimize
-				if (WorldSystem::get_game_screen() == GAME_SCREEN_ID::TUTORIAL)
+				if (tutorial)
 				{
-					if (registry.mapTiles.has(entity))
-					{
-						if (registry.tutorialTiles.has(entity))
-						{
-							drawTexturedMesh(entity, projection_2D);
-						}
-					}
-					else
-					{
+					if (registry().has_none<MapTile>(entity) || registry().has_any<TutorialTile>(entity))
 						drawTexturedMesh(entity, projection_2D);
-					}
 				}
-				else if (!registry.tutorialSigns.has(entity) && !registry.tutorialTiles.has(entity))
+				else if (registry().has_none<TutorialSign, TutorialTile>(entity))
 				{
 					drawTexturedMesh(entity, projection_2D);
 				}
 			}
 			// draw grid lines separately, as they do not have motion but need to be rendered
-			else if (registry.gridLines.has(entity))
+			else if (registry().has_any<GridLine>(entity))
 			{
 				drawGridLine(entity, projection_2D);
 			}
-		}
+		});
 		drawParticlesInstanced(projection_2D);
 
 		// individually draw player, toolbar, inventory seeds, pause button; will render on top of all the motion sprites
-		if (!WorldSystem::game_is_over && WorldSystem::get_game_screen() != GAME_SCREEN_ID::PAUSE && WorldSystem::get_game_screen() != GAME_SCREEN_ID::LEVEL_UP)
+		if (!world().game_is_over && WorldSystem::get_game_screen() != GAME_SCREEN_ID::PAUSE && WorldSystem::get_game_screen() != GAME_SCREEN_ID::LEVEL_UP)
 		{
-			for (Entity entity : registry.moveWithCameras.entities)
+			for (Entity entity : registry().moveWithCameras.entities)
 			{
-				if (registry.renderRequests.has(entity))
+				if (registry().renderRequests.has(entity))
 					drawTexturedMesh(entity, projection_2D);
 			}
 		}
@@ -635,14 +627,14 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 			renderText("HP", WINDOW_WIDTH_PX * 0.625, WINDOW_HEIGHT_PX * 0.925, 0.75, {1, 1, 1}, trans);
 			renderText("EXP", WINDOW_WIDTH_PX * 0.625, WINDOW_HEIGHT_PX * 0.85, 0.75, {1, 1, 1}, trans);
 
-			for (Entity seed_entity : registry.seeds.entities)
+			for (Entity seed_entity : registry().seeds.entities)
 			{
-				if (registry.motions.has(seed_entity) && registry.moveWithCameras.has(seed_entity))
+				if (registry().motions.has(seed_entity) && registry().moveWithCameras.has(seed_entity))
 				{
-					if (registry.inventorys.size() != 0) {
-						int seed_type = registry.seeds.get(seed_entity).type;
-						int current_seed_count = registry.inventorys.components[0].seedCount[seed_type];
-						vec2 seed_pos = registry.motions.get(seed_entity).position;
+					if (registry().inventorys.size() != 0) {
+						int seed_type = registry().seeds.get(seed_entity).type;
+						int current_seed_count = registry().inventorys.components[0].seedCount[seed_type];
+						vec2 seed_pos = registry().motions.get(seed_entity).position;
 						#if __APPLE__
 						renderText(std::to_string(current_seed_count), WINDOW_WIDTH_PX / 2 - TOOLBAR_WIDTH / 2 + TOOLBAR_HEIGHT * (seed_type * 0.95 + 0.9), 22.5, 0.25, {0.7, 0.25, 0.25}, trans);
 						#else
@@ -651,23 +643,27 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 					}
 				}
 			}
-			for (Entity text_entity : registry.texts.entities)
+			for (Entity text_entity : registry().texts.entities)
 			{
-				renderText(registry.texts.get(text_entity).text, registry.texts.get(text_entity).pos.x, registry.texts.get(text_entity).pos.y, registry.texts.get(text_entity).size, registry.texts.get(text_entity).color, trans);
+				renderText(registry().texts.get(text_entity).text, registry().texts.get(text_entity).pos.x, registry().texts.get(text_entity).pos.y, registry().texts.get(text_entity).size, registry().texts.get(text_entity).color, trans);
 			}
 			// Render the FPS counter
 			float current_fps = (1 / (elapsed_ms / 1000));
 			renderText("FPS: " + std::to_string(current_fps), WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.925, 0.3, {0, 1, 1}, trans);
 
 			// Render the number of enemies on screen
-			renderText("Enemy count: " + std::to_string(registry.enemies.size()), WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.875, 0.3, {0, 1, 1}, trans);
+			renderText("Enemy count: " + std::to_string(registry().enemies.size()), WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.875, 0.3, {0, 1, 1}, trans);
 
 			// Render the number of plants on screen
 			int total_seed_count = 0;
-			for (Entity entity : registry.seeds.entities) {
-				if (!registry.moveWithCameras.has(entity)) total_seed_count++;
+			for (Entity entity : registry().seeds.entities) {
+				if (!registry().moveWithCameras.has(entity)) total_seed_count++;
 			}
-			renderText("Plant count: " + std::to_string(total_seed_count + registry.towers.size()), WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.825, 0.3, {0, 1, 1}, trans);
+			renderText("Plant count: " + std::to_string(total_seed_count + registry().towers.size()), WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.825, 0.3, {0, 1, 1}, trans);
+
+			// Render the frame time percentiles and hitches of the last second
+			if (stats_line[0] != '\0')
+				renderText(stats_line, WINDOW_WIDTH_PX * 0.05, WINDOW_HEIGHT_PX * 0.775, 0.3, {0, 1, 1}, trans);
 
 		}
 
@@ -682,9 +678,9 @@ void RenderSystem::step_and_draw(float elapsed_ms)
 	}
 
 	// // draw all particles
-	// for (Entity entity : registry.particles.entities)
+	// for (Entity entity : registry().particles.entities)
 	// {
-	// 	if (registry.renderRequests.has(entity))
+	// 	if (registry().renderRequests.has(entity))
 	// 	{
 	// 		drawTexturedMesh(entity, projection_2D);
 	// 	}
@@ -715,7 +711,7 @@ mat3 RenderSystem::createProjectionMatrix_splash()
 }
 
 // mat3 RenderSystem::createProjectionMatrix() {
-//     auto& screen = registry.screenStates.get(screen_state_entity);
+//     auto& screen = registry().screenStates.get(screen_state_entity);
 
 //     float left = 0.f + screen.shake_offset.x;
 //     float top = 0.f + screen.shake_offset.y;
@@ -732,14 +728,15 @@ mat3 RenderSystem::createProjectionMatrix_splash()
 
 mat3 RenderSystem::createProjectionMatrix()
 {
-	auto &screen = registry.screenStates.get(screen_state_entity);
-	auto &camera = registry.cameras.get(registry.cameras.entities[0]);
+	auto &screen = registry().screenStates.get(screen_state_entity);
+	auto &camera = registry().cameras.get(registry().cameras.entities[0]);
+	vec2 camera_position = interpolation.camera_position(camera);
 
 	// Center camera on player, accounting for window size
-	float left = camera.position.x - camera.camera_width / 2 + screen.shake_offset.x;
-	float top = camera.position.y - camera.camera_height / 2 + screen.shake_offset.y;
-	float right = camera.position.x + camera.camera_width / 2 + screen.shake_offset.x;
-	float bottom = camera.position.y + camera.camera_height / 2 + screen.shake_offset.y;
+	float left = camera_position.x - camera.camera_width / 2 + screen.shake_offset.x;
+	float top = camera_position.y - camera.camera_height / 2 + screen.shake_offset.y;
+	float right = camera_position.x + camera.camera_width / 2 + screen.shake_offset.x;
+	float bottom = camera_position.y + camera.camera_height / 2 + screen.shake_offset.y;
 
 	float sx = 2.f / (right - left);
 	float sy = 2.f / (top - bottom);
@@ -918,8 +915,9 @@ bool RenderSystem::fontInit(const std::string &font_filename, unsigned int font_
 	return true;
 }
 
-void RenderSystem::renderText(std::string text, float x, float y, float scale, const glm::vec3 &color, const glm::mat4 &trans)
+void RenderSystem::renderText(std::string_view text, float x, float y, float scale, const glm::vec3 &color, const glm::mat4 &trans)
 {
+	PROFILE_SCOPE("renderText");
 	// Activate shader
 	glUseProgram(m_font_shaderProgram);
 
@@ -940,10 +938,9 @@ void RenderSystem::renderText(std::string text, float x, float y, float scale, c
 	glBindVertexArray(m_font_VAO);
 
 	// iterate through each character
-	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
+	for (char c : text)
 	{
-		Character ch = m_ftCharacters[*c];
+		Character ch = m_ftCharacters[c];
 
 		float xpos = x + ch.Bearing.x * scale;
 		float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
@@ -981,12 +978,13 @@ void RenderSystem::renderText(std::string text, float x, float y, float scale, c
 
 void RenderSystem::drawParticlesInstanced(const mat3 &projection)
 {
+	PROFILE_SCOPE("drawParticlesInstanced");
 	// Skip if no particles
-	if (registry.particles.entities.empty())
+	if (registry().particles.entities.empty())
 		return;
 
 	// Count active particles
-	int particleCount = (int)registry.particles.size();
+	int particleCount = (int)registry().particles.size();
 	if (particleCount == 0)
 		return;
 
@@ -999,9 +997,9 @@ void RenderSystem::drawParticlesInstanced(const mat3 &projection)
 	if (!instancing_supported)
 	{
 		// Fallback to regular rendering
-		for (Entity entity : registry.particles.entities)
+		for (Entity entity : registry().particles.entities)
 		{
-			if (registry.renderRequests.has(entity))
+			if (registry().renderRequests.has(entity))
 			{
 				drawTexturedMesh(entity, projection);
 			}
@@ -1068,16 +1066,16 @@ void RenderSystem::drawParticlesInstanced(const mat3 &projection)
 
 	// Fill instance data
 	int idx = 0;
-	for (Entity entity : registry.particles.entities)
+	for (Entity entity : registry().particles.entities)
 	{
-		Particle &particle = registry.particles.get(entity);
+		Particle &particle = registry().particles.get(entity);
 
 		// Get position and scale
 		vec2 position = particle.Position;
 		vec2 scale = vec2(10.0f * (particle.Life / particle.MaxLife));
-		if (registry.motions.has(entity))
+		if (registry().motions.has(entity))
 		{
-			scale = registry.motions.get(entity).scale;
+			scale = registry().motions.get(entity).scale;
 		}
 
 		// Position(xy) and scale(zw)
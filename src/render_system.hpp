@@ -6,6 +6,7 @@
 #include "common.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/tiny_ecs.hpp"
+#include "motion_interpolation.hpp"
 
 
 // fonts
@@ -408,13 +409,19 @@ public:
 	// Draw all entities
 	void step_and_draw(float elapsed_ms);
 
+	// Motions are drawn between the last two simulation steps, see MotionInterpolation
+	MotionInterpolation interpolation;
+
+	// Frame time percentiles drawn under the HUD counters, see FrameTelemetry
+	const char *stats_line = "";
+
 	mat3 createProjectionMatrix();
 	mat3 createProjectionMatrix_splash();
 	
 	Entity get_screen_state_entity() { return screen_state_entity; }
 
 	bool fontInit(const std::string &font_filename, unsigned int font_default_size);
-	void renderText(std::string text, float x, float y, float scale, const glm::vec3 &color, const glm::mat4 &trans);
+	void renderText(std::string_view text, float x, float y, float scale, const glm::vec3 &color, const glm::mat4 &trans);
 
 private:
 	// Internal drawing functions for each entity type
@@ -232,6 +232,7 @@ void RenderSystem::initializeGlMeshes()
 							  meshes[(int)geom_index].vertices,
 							  meshes[(int)geom_index].vertex_indices,
 							  meshes[(int)geom_index].original_size);
+		meshes[(int)geom_index].build_collision_data();
 
 		bindVBOandIBO(geom_index,
 					  meshes[(int)geom_index].vertices,
@@ -353,15 +354,15 @@ RenderSystem::~RenderSystem()
 	gl_has_errors();
 
 	// remove all entities created by the render system
-	while (registry.renderRequests.entities.size() > 0)
-		registry.remove_all_components_of(registry.renderRequests.entities.back());
+	while (registry().renderRequests.entities.size() > 0)
+		registry().remove_all_components_of(registry().renderRequests.entities.back());
 }
 
 // Initialize the screen texture from a standard sprite
 bool RenderSystem::initScreenTexture()
 {
 	// create a single entry
-	registry.screenStates.emplace(screen_state_entity);
+	registry().screenStates.emplace(screen_state_entity);
 
 	int framebuffer_width, framebuffer_height;
 	glfwGetFramebufferSize(const_cast<GLFWwindow *>(window), &framebuffer_width, &framebuffer_height); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
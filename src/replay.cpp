@@ -0,0 +1,210 @@
+// internal
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+	const char MAGIC[4] = {'F', 'D', 'R', 'P'};
+	const uint16_t VERSION = 1;
+
+	// a cursor over the file's bytes; reads past the end fail and stay failed
+	struct Reader
+	{
+		const std::vector<uint8_t> &bytes;
+		size_t position = 0;
+		bool failed = false;
+
+		uint8_t byte()
+		{
+			if (position >= bytes.size())
+			{
+				failed = true;
+				return 0;
+			}
+			return bytes[position++];
+		}
+		uint32_t fixed(int size)
+		{
+			uint32_t value = 0;
+			for (int i = 0; i < size; i++)
+				value |= uint32_t(byte()) << (8 * i);
+			return value;
+		}
+		uint32_t varint()
+		{
+			uint32_t value = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				uint8_t b = byte();
+				value |= uint32_t(b & 0x7f) << shift;
+				if (!(b & 0x80))
+					return value;
+			}
+			failed = true;
+			return value;
+		}
+		float f32()
+		{
+			uint32_t bits = fixed(4);
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+	};
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+	if (is_open())
+		close(last_tick);
+}
+
+bool ReplayRecorder::open(const std::string &path_arg, uint32_t seed)
+{
+	path = path_arg;
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cerr << "ERROR: cannot write the replay to " << path << std::endl;
+		return false;
+	}
+	file.write(MAGIC, sizeof(MAGIC));
+	file.put(char(VERSION & 0xff));
+	file.put(char(VERSION >> 8));
+	for (int i = 0; i < 4; i++)
+		file.put(char((seed >> (8 * i)) & 0xff));
+	last_tick = 0;
+	event_count = 0;
+	return true;
+}
+
+void ReplayRecorder::write_varint(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		file.put(char((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	file.put(char(value));
+}
+
+void ReplayRecorder::record(const InputEvent &event)
+{
+	if (!is_open())
+		return;
+	write_varint(event.tick - last_tick);
+	last_tick = event.tick;
+	bool has_mods = event.mods != 0;
+	file.put(char(uint8_t(event.type) | (event.action & 0x3) << 2 | (has_mods ? 1 : 0) << 4));
+	switch (event.type)
+	{
+	case InputEvent::Type::KEY:
+		write_varint(uint32_t(event.code));
+		break;
+	case InputEvent::Type::MOUSE_BUTTON:
+		file.put(char(event.code));
+		break;
+	case InputEvent::Type::MOUSE_MOVE:
+		for (float value : {event.x, event.y})
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			for (int i = 0; i < 4; i++)
+				file.put(char((bits >> (8 * i)) & 0xff));
+		}
+		break;
+	case InputEvent::Type::END:
+		break;
+	}
+	if (has_mods)
+		file.put(char(event.mods));
+	event_count++;
+}
+
+void ReplayRecorder::close(uint32_t tick)
+{
+	InputEvent end;
+	end.type = InputEvent::Type::END;
+	end.tick = std::max(tick, last_tick);
+	record(end);
+	file.close();
+	std::cout << "Recorded " << event_count - 1 << " input events over " << end.tick << " steps to " << path << std::endl;
+}
+
+bool ReplayPlayer::open(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "ERROR: cannot open the replay " << path << std::endl;
+		return false;
+	}
+	std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	Reader in{bytes};
+	if (bytes.size() < sizeof(MAGIC) || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0)
+	{
+		std::cerr << "ERROR: " << path << " is not a replay" << std::endl;
+		return false;
+	}
+	in.position = sizeof(MAGIC);
+	uint32_t version = in.fixed(2);
+	if (version != VERSION)
+	{
+		std::cerr << "ERROR: " << path << " is a version " << version << " replay, this build reads version " << VERSION << std::endl;
+		return false;
+	}
+	seed = in.fixed(4);
+
+	events.clear();
+	position = 0;
+	end_tick = 0;
+	uint32_t tick = 0;
+	bool ended = false;
+	while (!ended && in.position < bytes.size())
+	{
+		InputEvent event;
+		tick += in.varint();
+		event.tick = tick;
+		uint8_t header = in.byte();
+		event.type = InputEvent::Type(header & 0x3);
+		event.action = (header >> 2) & 0x3;
+		switch (event.type)
+		{
+		case InputEvent::Type::KEY:
+			event.code = int(in.varint());
+			break;
+		case InputEvent::Type::MOUSE_BUTTON:
+			event.code = in.byte();
+			break;
+		case InputEvent::Type::MOUSE_MOVE:
+			event.x = in.f32();
+			event.y = in.f32();
+			break;
+		case InputEvent::Type::END:
+			ended = true;
+			break;
+		}
+		if (header & (1 << 4))
+			event.mods = in.byte();
+		if (in.failed)
+			break;
+		end_tick = tick;
+		if (!ended)
+			events.push_back(event);
+	}
+	if (!ended)
+		std::cerr << "WARNING: " << path << " was cut short, replaying its first " << events.size() << " events" << std::endl;
+	return true;
+}
+
+bool ReplayPlayer::next(uint32_t tick, InputEvent &event)
+{
+	if (position == events.size() || events[position].tick > tick)
+		return false;
+	event = events[position++];
+	return true;
+}
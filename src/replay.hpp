@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One input event as WorldSystem receives it from the window (see WorldSystem::handle_input)
+struct InputEvent
+{
+	enum class Type : uint8_t
+	{
+		KEY = 0,
+		MOUSE_MOVE = 1,
+		MOUSE_BUTTON = 2,
+		END = 3 // the session ended at this tick
+	};
+
+	uint32_t tick = 0; // simulation steps completed before the event
+	Type type = Type::KEY;
+	int code = 0;	// key, or mouse button
+	int action = 0; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+	int mods = 0;
+	float x = 0; // cursor position, for MOUSE_MOVE
+	float y = 0;
+};
+
+// Replay files hold the game seed and every input event of a session, stamped with the simulation
+// tick; the simulation is deterministic given both, so playing the events back at the same ticks
+// reproduces the session. Layout, little-endian:
+//   "FDRP", u16 version, u32 seed
+//   per event: varint tick delta, u8 type | action << 2 | has_mods << 4, then
+//     KEY: varint key, MOUSE_BUTTON: u8 button, MOUSE_MOVE: f32 x, f32 y,
+//     and u8 mods if has_mods
+//   one END event with the last tick
+class ReplayRecorder
+{
+public:
+	~ReplayRecorder();
+
+	bool open(const std::string &path, uint32_t seed);
+	bool is_open() const { return file.is_open(); }
+	void record(const InputEvent &event);
+	// Writes the END event at tick and closes the file
+	void close(uint32_t tick);
+
+	size_t get_event_count() const { return event_count; }
+
+private:
+	std::ofstream file;
+	std::string path;
+	uint32_t last_tick = 0;
+	size_t event_count = 0;
+
+	void write_varint(uint32_t value);
+};
+
+class ReplayPlayer
+{
+public:
+	// Reads the whole file; false (with a message) if it is not a replay
+	bool open(const std::string &path);
+
+	uint32_t get_seed() const { return seed; }
+	// The tick the session ended at
+	uint32_t get_end_tick() const { return end_tick; }
+	size_t get_event_count() const { return events.size(); }
+
+	// The next event, if it happened at or before tick
+	bool next(uint32_t tick, InputEvent &event);
+	// The session's last tick is reached; events stamped with it came after its last step
+	bool finished(uint32_t tick) const { return tick >= end_tick; }
+
+private:
+	std::vector<InputEvent> events;
+	size_t position = 0;
+	uint32_t seed = 0;
+	uint32_t end_tick = 0;
+};
@@ -6,8 +6,5 @@
 
 class SeedSystem {
 public:
-    static void init(RenderSystem* renderer);
     void step(float elapsed_ms);
-private:
-    static RenderSystem* renderer;
 };
@@ -0,0 +1,134 @@
+// internal
+#include "simulation.hpp"
+#include "profiler.hpp"
+
+#include <iostream>
+
+Simulation::Simulation(World &world, unsigned int worker_count)
+	: world(world), thread_pool(worker_count), scheduler(thread_pool, world), step_screen(world.game_screen)
+{
+	// the simulation systems run as a task graph: each waits only for the earlier systems whose
+	// components it conflicts with. Stage 0 may start a cutscene or end the game, which skips stage 1
+	scheduler.add(0, "ai", fm_ai, SystemAccess().write_all_components().write_world(),
+		[this](float elapsed_ms) { ai_system.step(elapsed_ms); });
+	scheduler.add(0, "physics", fm_physics, SystemAccess().write_all_components().write_world(),
+		[this](float elapsed_ms) { physics_system.step(elapsed_ms); });
+	scheduler.add(0, "status", fm_status, SystemAccess().write_all_components().write_world(),
+		[this](float elapsed_ms) { status_system.step(elapsed_ms, world_system); });
+	scheduler.add(0, "seed", fm_seed, SystemAccess().write_all_components().write_world(),
+		[this](float elapsed_ms) { seed_system.step(elapsed_ms); });
+	scheduler.add(1, "player", fm_player, SystemAccess().add_components().read<Player, Motion>().write<State, Animation, RenderRequest>().read_world(),
+		[this](float elapsed_ms) { player_system.step(elapsed_ms); });
+	scheduler.add(1, "tower", fm_tower, SystemAccess().write_all_components().write_world(),
+		[this](float elapsed_ms) { tower_system.step(elapsed_ms); });
+	scheduler.add(1, "movement", fm_movement, SystemAccess().read<Player, MoveWithCamera>().write<Motion>().read_world(),
+		[this](float elapsed_ms) { movement_system.step(elapsed_ms, step_screen); });
+	scheduler.add(1, "animation", fm_animation, SystemAccess().write_all_components(),
+		[this](float elapsed_ms) { animation_system.step(elapsed_ms); });
+	scheduler.add(1, "particle", fm_particle, SystemAccess().write_all_components(),
+		[this](float elapsed_ms) { particle_system.step(elapsed_ms); });
+	scheduler.add(1, "screen", fm_screen, SystemAccess().read<Player>().write<ScreenState>(),
+		[this](float elapsed_ms) { screen_system.step(elapsed_ms); });
+	scheduler.add(1, "death", fm_death, SystemAccess().add_components().read<Enemy, Player, Attack>().write<DeathAnimation, ScreenState>().write_world(),
+		[this](float elapsed_ms) { death_system.step(elapsed_ms, world_system); });
+
+	world_system.input_filter = [this](InputEvent &event) { return filter_live_input(event); };
+}
+
+void Simulation::start_and_load_sounds()
+{
+	if (!world_system.start_and_load_sounds())
+	{
+		std::cerr << "ERROR: Failed to start or load sounds in world_system." << std::endl;
+	}
+
+	if (!ai_system.start_and_load_sounds())
+	{
+		std::cerr << "ERROR: Failed to start or load sounds in ai_system." << std::endl;
+	}
+
+	if (!status_system.start_and_load_sounds())
+	{
+		std::cerr << "ERROR: Failed to start or load sounds in status_system." << std::endl;
+	}
+
+	if (!physics_system.start_and_load_sounds())
+	{
+		std::cerr << "ERROR: Failed to start or load sounds in status_system." << std::endl;
+	}
+}
+
+void Simulation::init(RenderSystem *renderer)
+{
+	world.renderer = renderer;
+	world_system.init(renderer);
+	particle_system.init(renderer);
+}
+
+void Simulation::record_input(ReplayRecorder *recorder)
+{
+	replay_recorder = recorder;
+}
+
+void Simulation::replay_input(ReplayPlayer *player)
+{
+	replay_player = player;
+}
+
+bool Simulation::filter_live_input(InputEvent &event)
+{
+	if (replay_player)
+		return false;
+	event.tick = tick;
+	if (replay_recorder)
+		replay_recorder->record(event);
+	return true;
+}
+
+void Simulation::deliver_replay_input()
+{
+	if (!replay_player)
+		return;
+	InputEvent event;
+	while (replay_player->next(tick, event))
+		world_system.handle_input(event);
+}
+
+bool Simulation::step(float step_ms)
+{
+	PROFILE_SCOPE("simulation step");
+	deliver_replay_input();
+	tick++;
+	// CK: be mindful of the order of your systems and rearrange this list only if necessary
+	if (fm_world.can_update()) world_system.step(fm_world.get_time());
+	GAME_SCREEN_ID game_screen = world_system.get_game_screen();
+	if (!world.game_is_over && game_screen != GAME_SCREEN_ID::SPLASH && game_screen != GAME_SCREEN_ID::CG ) {
+		for (FrameManager *frame_manager : frame_managers)
+			frame_manager->tick(step_ms); //moved here so when doing cg the game will pause
+		step_screen = game_screen;
+
+		scheduler.begin_step();
+		scheduler.run(0);
+
+		// the rest of the frame belongs to the cutscene, or to the game over screen, whose entities
+		// replaced the ones the later systems would step
+		if (world_system.get_game_screen() == GAME_SCREEN_ID::CG || world.game_is_over)
+		{
+			scheduler.end_step();
+			return false;
+		}
+
+		scheduler.run(1);
+		scheduler.end_step();
+	}
+
+	// a pause or level-up screen opened during this step freezes the rest
+	game_screen = world_system.get_game_screen();
+	return game_screen != GAME_SCREEN_ID::PAUSE && game_screen != GAME_SCREEN_ID::LEVEL_UP;
+}
+
+void Simulation::print_report(std::ostream &out)
+{
+	scheduler.print_report(out);
+	scheduler.reset_report();
+}
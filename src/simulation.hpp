@@ -0,0 +1,107 @@
+#pragma once
+
+// internal
+#include "ai_system.hpp"
+#include "animation_system.hpp"
+#include "death_system.hpp"
+#include "frame_manager.hpp"
+#include "movement_system.hpp"
+#include "particle_system.hpp"
+#include "physics_system.hpp"
+#include "player_system.hpp"
+#include "render_system.hpp"
+#include "replay.hpp"
+#include "screen_system.hpp"
+#include "seed_system.hpp"
+#include "status_system.hpp"
+#include "system_scheduler.hpp"
+#include "tower_system.hpp"
+#include "world.hpp"
+#include "world_system.hpp"
+
+// The gameplay systems and the order they run in, one simulation step at a time. Shared by the game
+// (main.cpp) and the headless runner (headless/headless_main.cpp), which differ only in what drives it.
+//
+// A simulation plays one World. The thread that creates and drives it must have that world bound
+// (World::Scope) for as long as it does; the scheduler binds it on its worker threads. Simulations
+// of different worlds can be driven from different threads at the same time.
+class Simulation
+{
+public:
+	// Steps the systems with worker_count threads besides the caller, see ThreadPool
+	explicit Simulation(World &world, unsigned int worker_count = ThreadPool::default_worker_count());
+	Simulation(const Simulation &) = delete;
+	Simulation &operator=(const Simulation &) = delete;
+
+	// Loads music and sound effects; failures are reported but the game runs without them
+	void start_and_load_sounds();
+
+	// Starts the game, creating entities with the meshes of renderer
+	void init(RenderSystem *renderer);
+
+	// Advances the game by one simulation step of step_ms milliseconds. Returns false when the rest
+	// of the frame is frozen: a cutscene started, the game ended, or a pause or level-up screen opened
+	bool step(float step_ms);
+
+	// Per-system timings since the last summary, see SystemScheduler
+	void print_report(std::ostream &out);
+	const SystemScheduler &get_scheduler() const { return scheduler; }
+
+	// Simulation steps taken so far; input events are stamped with it
+	uint32_t get_tick() const { return tick; }
+
+	// Writes every input event from the window to recorder, stamped with the tick it arrived at.
+	// The recorder must be open, with the session seed (world.random.get_seed())
+	void record_input(ReplayRecorder *recorder);
+	// Feeds the events of player back in place of the window's: each step first handles the events
+	// recorded before it. The game seed must be player's. A replay steps on every frame, pause and
+	// level-up screens included; the recorded ticks already say when the session stepped
+	void replay_input(ReplayPlayer *player);
+	bool is_replaying() const { return replay_player != nullptr; }
+	// The replay has reached the tick its session ended at
+	bool replay_finished() const { return replay_player && replay_player->finished(tick); }
+
+	World &world;
+
+	// global systems
+	AISystem ai_system;
+	WorldSystem world_system;
+	PhysicsSystem physics_system;
+	StatusSystem status_system;
+	AnimationSystem animation_system;
+	TowerSystem tower_system;
+	SeedSystem seed_system;
+	MovementSystem movement_system;
+	ParticleSystem particle_system;
+	PlayerSystem player_system;
+	ScreenSystem screen_system;
+	DeathSystem death_system;
+
+private:
+	// tick divisors: each system runs every n-th simulation step
+	FrameManager fm_world = FrameManager(1);
+	FrameManager fm_ai = FrameManager(1);
+	FrameManager fm_physics = FrameManager(1);
+	FrameManager fm_status = FrameManager(1);
+	FrameManager fm_tower = FrameManager(5);
+	FrameManager fm_movement = FrameManager(2);
+	FrameManager fm_animation = FrameManager(2);
+	FrameManager fm_particle = FrameManager(10);
+	FrameManager fm_seed = FrameManager(5);
+	FrameManager fm_player = FrameManager(5);
+	FrameManager fm_screen = FrameManager(2);
+	FrameManager fm_death = FrameManager(2);
+	FrameManager *frame_managers[12] = {&fm_world, &fm_ai, &fm_physics, &fm_status, &fm_tower, &fm_movement,
+										&fm_animation, &fm_particle, &fm_seed, &fm_player, &fm_screen, &fm_death};
+
+	uint32_t tick = 0;
+	ReplayRecorder *replay_recorder = nullptr;
+	ReplayPlayer *replay_player = nullptr;
+	bool filter_live_input(InputEvent &event);
+	void deliver_replay_input();
+
+	ThreadPool thread_pool;
+	SystemScheduler scheduler;
+	// the game screen at the start of the step, as the movement system sees it
+	GAME_SCREEN_ID step_screen;
+};
@@ -0,0 +1,153 @@
+// internal
+#include "spatial_grid.hpp"
+
+void SpatialGrid::build(const std::vector<Entity> &entities, ComponentContainer<Motion> &motions)
+{
+	in_order.clear();
+	max_radius = 0.f;
+	std::fill(bucket_start.begin(), bucket_start.end(), 0);
+	for (Entity entity : entities)
+	{
+		const Motion *motion = motions.try_get(entity);
+		if (!motion)
+			continue;
+		Entry entry;
+		entry.entity = entity;
+		entry.position = motion->position;
+		entry.radius = length(abs(motion->scale) / 2.f);
+		entry.cell_x = cell_of(entry.position.x);
+		entry.cell_y = cell_of(entry.position.y);
+		max_radius = std::max(max_radius, entry.radius);
+		bucket_start[bucket_of(entry.cell_x, entry.cell_y) + 1]++;
+		in_order.push_back(entry);
+	}
+
+	// counting sort: bucket_start[b] becomes the first slot of bucket b
+	for (uint32_t b = 0; b < BUCKET_COUNT; b++)
+		bucket_start[b + 1] += bucket_start[b];
+	entries.resize(in_order.size());
+	for (const Entry &entry : in_order)
+		entries[bucket_start[bucket_of(entry.cell_x, entry.cell_y)]++] = entry;
+	// the scatter moved every start to the next bucket's
+	for (uint32_t b = BUCKET_COUNT; b > 0; b--)
+		bucket_start[b] = bucket_start[b - 1];
+	bucket_start[0] = 0;
+}
+
+void SpatialGrid::query_radius(vec2 center, float radius, std::vector<Entity> &out) const
+{
+	float reach = radius + max_radius;
+	for_each_in_cells(cell_of(center.x - reach), cell_of(center.y - reach), cell_of(center.x + reach), cell_of(center.y + reach),
+					  [&](const Entry &entry)
+	{
+		vec2 d = entry.position - center;
+		float r = radius + entry.radius;
+		if (dot(d, d) <= r * r)
+			out.push_back(entry.entity);
+	});
+}
+
+void SpatialGrid::query_aabb(vec2 min, vec2 max, std::vector<Entity> &out) const
+{
+	for_each_in_cells(cell_of(min.x - max_radius), cell_of(min.y - max_radius), cell_of(max.x + max_radius), cell_of(max.y + max_radius),
+					  [&](const Entry &entry)
+	{
+		vec2 closest = clamp(entry.position, min, max);
+		vec2 d = entry.position - closest;
+		if (dot(d, d) <= entry.radius * entry.radius)
+			out.push_back(entry.entity);
+	});
+}
+
+void SpatialGrid::query_oriented_rect(vec2 origin, vec2 direction, float length, float half_width, std::vector<Entity> &out) const
+{
+	// also false for a NaN length, from the direction between two equal points
+	if (!(length >= 0.f))
+		return;
+	vec2 normal(-direction.y, direction.x);
+	vec2 end = origin + direction * length;
+	vec2 corners[4] = {origin + normal * half_width, origin - normal * half_width, end + normal * half_width, end - normal * half_width};
+	vec2 min = corners[0];
+	vec2 max = corners[0];
+	for (const vec2 &corner : corners)
+	{
+		min = glm::min(min, corner);
+		max = glm::max(max, corner);
+	}
+	for_each_in_cells(cell_of(min.x - max_radius), cell_of(min.y - max_radius), cell_of(max.x + max_radius), cell_of(max.y + max_radius),
+					  [&](const Entry &entry)
+	{
+		// distance from the rectangle, in its own frame
+		vec2 relative = entry.position - origin;
+		float along = dot(relative, direction);
+		float across = std::abs(dot(relative, normal));
+		float dx = std::max({0.f, -along, along - length});
+		float dy = std::max(0.f, across - half_width);
+		if (dx * dx + dy * dy <= entry.radius * entry.radius)
+			out.push_back(entry.entity);
+	});
+}
+
+size_t SpatialGrid::query_nearest(vec2 center, float max_distance, size_t k, std::vector<Entity> &out) const
+{
+	if (k == 0 || entries.empty())
+		return 0;
+	// (squared distance, entity) of the entries within max_distance seen so far
+	std::vector<std::pair<float, Entity>> found;
+	auto consider = [&](const Entry &entry)
+	{
+		vec2 d = entry.position - center;
+		float distance_squared = dot(d, d);
+		if (distance_squared <= max_distance * max_distance)
+			found.push_back({distance_squared, entry.entity});
+	};
+	auto closest_first = [](const std::pair<float, Entity> &a, const std::pair<float, Entity> &b)
+	{
+		return a.first < b.first || (a.first == b.first && a.second.id() < b.second.id());
+	};
+
+	// rings of cells around the centre's cell, until the k closest so far are nearer than any cell
+	// left to visit
+	int32_t center_x = cell_of(center.x);
+	int32_t center_y = cell_of(center.y);
+	// the fallback below stops the rings long before this for a far max_distance
+	int32_t last_ring = (int32_t)std::min(std::ceil(max_distance / CELL_SIZE) + 1.f, 65536.f);
+	size_t visited_cells = 0;
+	for (int32_t ring = 0; ring <= last_ring; ring++)
+	{
+		size_t ring_cells = ring == 0 ? 1 : (size_t)ring * 8;
+		if (visited_cells + ring_cells >= entries.size())
+		{
+			// cheaper to look at everything
+			found.clear();
+			for (const Entry &entry : in_order)
+				consider(entry);
+			break;
+		}
+		visited_cells += ring_cells;
+		for (int32_t y = center_y - ring; y <= center_y + ring; y++)
+		{
+			bool edge_row = y == center_y - ring || y == center_y + ring;
+			for (int32_t x = center_x - ring; x <= center_x + ring; x += edge_row ? 1 : 2 * ring)
+			{
+				for_each_in_cell(x, y, consider);
+				if (ring == 0)
+					break;
+			}
+		}
+		// every cell of the next ring is at least ring cells away from the centre
+		if (found.size() >= k)
+		{
+			std::nth_element(found.begin(), found.begin() + (k - 1), found.end(), closest_first);
+			float reach = ring * CELL_SIZE;
+			if (found[k - 1].first <= reach * reach)
+				break;
+		}
+	}
+
+	size_t count = std::min(k, found.size());
+	std::partial_sort(found.begin(), found.begin() + count, found.end(), closest_first);
+	for (size_t i = 0; i < count; i++)
+		out.push_back(found[i].second);
+	return count;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "common.hpp"
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+// A uniform grid of GRID_CELL_WIDTH_PX cells over the plane, hashed into a fixed table so that
+// positions off the map need no special case. Holds a set of entities as bounding circles (position
+// and half the diagonal of Motion::scale, the circle PhysicsSystem::collides uses), bucketed by the
+// cell of their centre. A build is a counting sort of the entities by bucket: O(n), and no
+// allocation once the arrays have grown to the largest set.
+//
+// Queries report every entity whose circle, as of the last build, touches the region, and maybe a
+// few more; callers apply their exact test to the live components. They cost the cells the region
+// covers plus the entities in them, or one pass over all entities when the region spans more cells
+// than there are entities. Results come in no particular order, see order_like.
+class SpatialGrid
+{
+public:
+	static constexpr float CELL_SIZE = (float)GRID_CELL_WIDTH_PX;
+
+	// Replaces the contents with every entity of entities that has a Motion, as it is now
+	void build(const std::vector<Entity> &entities, ComponentContainer<Motion> &motions);
+
+	size_t size() const { return entries.size(); }
+	// The largest circle radius in the grid
+	float get_max_radius() const { return max_radius; }
+
+	// Entities whose circle touches the circle (center, radius)
+	void query_radius(vec2 center, float radius, std::vector<Entity> &out) const;
+	// Entities whose circle touches the box [min, max]
+	void query_aabb(vec2 min, vec2 max, std::vector<Entity> &out) const;
+	// Entities whose circle touches the rectangle reaching length along direction (unit) from origin,
+	// half_width to either side
+	void query_oriented_rect(vec2 origin, vec2 direction, float length, float half_width, std::vector<Entity> &out) const;
+	// Up to k entities whose centres are the closest to center and within max_distance of it,
+	// closest first. Returns how many were found
+	size_t query_nearest(vec2 center, float max_distance, size_t k, std::vector<Entity> &out) const;
+
+private:
+	static constexpr uint32_t BUCKET_COUNT = 1024; // power of two
+	static constexpr uint32_t BUCKET_MASK = BUCKET_COUNT - 1;
+
+	struct Entry
+	{
+		Entity entity;
+		vec2 position;
+		float radius;
+		int32_t cell_x;
+		int32_t cell_y;
+	};
+
+	// entries sorted by bucket; bucket b holds entries[bucket_start[b], bucket_start[b + 1])
+	std::vector<Entry> entries;
+	std::vector<uint32_t> bucket_start = std::vector<uint32_t>(BUCKET_COUNT + 1, 0);
+	std::vector<Entry> in_order; // the entries in the order build was given them
+	float max_radius = 0.f;
+
+	static int32_t cell_of(float coordinate) { return (int32_t)std::floor(coordinate / CELL_SIZE); }
+	static uint32_t bucket_of(int32_t cell_x, int32_t cell_y)
+	{
+		return ((uint32_t)cell_x * 73856093u ^ (uint32_t)cell_y * 19349663u) & BUCKET_MASK;
+	}
+
+	// Calls visit(entry) for every entry whose centre lies in cell (x, y)
+	template <typename Visit>
+	void for_each_in_cell(int32_t x, int32_t y, Visit &&visit) const
+	{
+		uint32_t bucket = bucket_of(x, y);
+		for (uint32_t i = bucket_start[bucket]; i < bucket_start[bucket + 1]; i++)
+		{
+			// buckets are shared by distant cells
+			if (entries[i].cell_x == x && entries[i].cell_y == y)
+				visit(entries[i]);
+		}
+	}
+
+	// Calls visit(entry) for every entry whose centre lies in a cell of [min, max] (in cells), or for
+	// every entry when that is fewer
+	template <typename Visit>
+	void for_each_in_cells(int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y, Visit &&visit) const
+	{
+		if ((uint64_t)(max_x - min_x + 1) * (uint64_t)(max_y - min_y + 1) >= entries.size())
+		{
+			// in build order, so that order_like finds them sorted already
+			for (const Entry &entry : in_order)
+				visit(entry);
+			return;
+		}
+		for (int32_t y = min_y; y <= max_y; y++)
+		{
+			for (int32_t x = min_x; x <= max_x; x++)
+				for_each_in_cell(x, y, visit);
+		}
+	}
+};
+
+// An entity and its slot in a container, as order_like sorts them
+struct OrderKey
+{
+	int slot;
+	unsigned int id;
+};
+
+// Sorts entities in the order a loop over container visits them, dropping those that no longer
+// have a component in it. Systems that used such a loop keep their order, and with it which entity
+// wins and the order of what they create. scratch is the caller's, kept across calls so that the
+// sort allocates nothing once it has grown to the largest query
+template <typename Component>
+void order_like(ComponentContainer<Component> &container, std::vector<Entity> &entities, std::vector<OrderKey> &scratch)
+{
+	// each slot is looked up once, and the sort skipped when the grid gave them in order
+	scratch.clear();
+	bool sorted = true;
+	for (Entity entity : entities)
+	{
+		if (!container.has(entity))
+			continue;
+		scratch.push_back({container.getEntityId(entity), entity.id()});
+		sorted = sorted && (scratch.size() == 1 || scratch[scratch.size() - 2].slot < scratch.back().slot);
+	}
+	if (!sorted)
+		std::sort(scratch.begin(), scratch.end(), [](const OrderKey &a, const OrderKey &b) { return a.slot < b.slot; });
+	entities.clear();
+	for (const OrderKey &key : scratch)
+		entities.push_back(Entity((int)key.id));
+}
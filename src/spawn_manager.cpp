@@ -9,10 +9,6 @@ SpawnManager::SpawnManager() : wave_timer_ms(0.f),
                                current_wave(0),
                                is_game_started(false)
 {
-    // Initialize RNG
-    rng = std::default_random_engine(std::random_device()());
-    uniform_dist = std::uniform_real_distribution<float>(0.f, 1.f);
-
     initialize_spawn_points();
 }
 
@@ -81,9 +77,9 @@ void SpawnManager::generate_wave(RenderSystem *renderer)
     for (int i = 0; i < zombies_per_wave; i++)
     {
         // Get a random spawn point index
-        int random_point = (int)(uniform_dist(rng) * spawn_points.size());
+        int random_point = (int)rng(RandomStream::SPAWN).below(spawn_points.size());
         vec2 spawn_pos = spawn_points[random_point].position;
-        if (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) < 0.3f)
+        if (rng(RandomStream::SPAWN).chance(0.3f))
         {
             createOrc(renderer, spawn_pos);
         }
@@ -136,7 +132,7 @@ void SpawnManager::set_day(int day)
 void SpawnManager::spawn_enemy(RenderSystem *renderer)
 {
     // Get a random spawn point
-    int random_point = (int)(uniform_dist(rng) * spawn_points.size());
+    int random_point = (int)rng(RandomStream::SPAWN).below(spawn_points.size());
     vec2 spawn_pos = spawn_points[random_point].position;
 
     // Get the current day from WorldSystem
@@ -257,7 +253,7 @@ void SpawnManager::spawnEnemyByDay(RenderSystem *renderer, vec2 spawn_pos, int c
     if (current_day >= 9)
     {
         // After day 9, use the original random distribution but with adjusted rates
-        float prob = uniform_dist(rng);
+        float prob = rng(RandomStream::SPAWN).uniform();
 
         if (prob < 0.25f)
         {
@@ -297,7 +293,7 @@ void SpawnManager::spawnEnemyByDay(RenderSystem *renderer, vec2 spawn_pos, int c
     }
 
     // For days 1-7, select from available enemies list
-    int enemy_idx = (int)(uniform_dist(rng) * available_enemies.size());
+    int enemy_idx = (int)rng(RandomStream::SPAWN).below(available_enemies.size());
     available_enemies[enemy_idx]();
 }
 
@@ -315,14 +311,14 @@ void SpawnManager::start_challenge_day(RenderSystem *renderer, vec2 spawn_pos)
 
     // Create a squad entity to coordinate the members
     Entity squad_entity = Entity();
-    Squad &squad = registry.squads.emplace(squad_entity);
+    Squad &squad = registry().squads.emplace(squad_entity);
     squad.squad_id = 1; // First squad
 
     // Get player position for reference
     vec2 player_pos;
-    if (!registry.players.entities.empty() && registry.motions.has(registry.players.entities[0]))
+    if (!registry().players.entities.empty() && registry().motions.has(registry().players.entities[0]))
     {
-        player_pos = registry.motions.get(registry.players.entities[0]).position;
+        player_pos = registry().motions.get(registry().players.entities[0]).position;
     }
     else
     {
@@ -384,9 +380,9 @@ void SpawnManager::start_challenge_day(RenderSystem *renderer, vec2 spawn_pos)
         squad.archers.push_back(archer);
         
         // Set initial movement toward final position
-        if (registry.motions.has(archer))
+        if (registry().motions.has(archer))
         {
-            Motion& motion = registry.motions.get(archer);
+            Motion& motion = registry().motions.get(archer);
             vec2 direction = normalize(final_pos - archer_spawn);
             motion.velocity = direction * 120.0f;
             
@@ -416,9 +412,9 @@ void SpawnManager::start_challenge_day(RenderSystem *renderer, vec2 spawn_pos)
         squad.orcs.push_back(orc);
         
         // Set initial movement toward final position
-        if (registry.motions.has(orc))
+        if (registry().motions.has(orc))
         {
-            Motion& motion = registry.motions.get(orc);
+            Motion& motion = registry().motions.get(orc);
             vec2 direction = normalize(final_pos - orc_spawn);
             motion.velocity = direction * 150.0f;
             
@@ -436,10 +432,10 @@ void SpawnManager::start_challenge_day(RenderSystem *renderer, vec2 spawn_pos)
     squad.knights.push_back(knight);
     
     // Set initial movement for knight
-    if (registry.motions.has(knight) && registry.orcRiders.has(knight))
+    if (registry().motions.has(knight) && registry().orcRiders.has(knight))
     {
-        Motion& motion = registry.motions.get(knight);
-        OrcRider& rider = registry.orcRiders.get(knight);
+        Motion& motion = registry().motions.get(knight);
+        OrcRider& rider = registry().orcRiders.get(knight);
         vec2 direction = normalize(knight_final - knight_spawn);
         motion.velocity = direction * rider.walk_speed * 1.2f;
         
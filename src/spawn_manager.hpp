@@ -5,8 +5,8 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/registry.hpp"
 #include <vector>
-#include <random>
 #include "days.hpp"
+#include "random.hpp"
 
 class SpawnManager {
 public:
@@ -38,9 +38,6 @@ private:
     int zombies_per_wave;
     
     
-    // RNG
-    std::default_random_engine rng;
-    std::uniform_real_distribution<float> uniform_dist;
     
     // Constants
     static constexpr float WAVE_INTERVAL_MS = 10000.0f;
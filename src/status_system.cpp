@@ -19,33 +19,36 @@ StatusSystem::~StatusSystem()
 void StatusSystem::step(float elapsed_ms, WorldSystem& world_system)
 {
         // Handle different types of status effects
-        for (Entity entity : registry.statuses.entities)
+        for (Entity entity : registry().statuses.entities)
         {
             update_zombie_attack(entity, elapsed_ms, world_system);
             handle_projectile_attack(entity, elapsed_ms);
         }
 
         // Clean up expired statuses after all processing
-        for (auto entity : registry.statuses.entities)
+        for (auto entity : registry().statuses.entities)
         {
             remove_expired_statuses(entity);
         }
 
         handle_cooldowns(elapsed_ms);
         handle_hit_effects(elapsed_ms);
+
+        // sync point: apply the removals recorded above
+        registry().flush_deferred();
 }
 
 void StatusSystem::update_zombie_attack(Entity entity, float elapsed_ms, WorldSystem& world_system)
 {
     // First check if entity has both required components
-    if (!registry.statuses.has(entity) || !registry.players.has(entity))
+    if (!registry().statuses.has(entity) || !registry().players.has(entity))
     {
         return;
     }
 
     // Only get the components after confirming they exist
-    auto &status_comp = registry.statuses.get(entity);
-    auto &player = registry.players.get(entity);
+    auto &status_comp = registry().statuses.get(entity);
+    auto &player = registry().players.get(entity);
 
     for (auto &status : status_comp.active_statuses)
     {
@@ -56,25 +59,25 @@ void StatusSystem::update_zombie_attack(Entity entity, float elapsed_ms, WorldSy
             //           << " attack damage. Health: " << player.health << std::endl;
 
             // If the creature is an entity, update the hp_percentage.
-            if (registry.players.has(entity))
+            if (registry().players.has(entity))
             {
-                registry.screenStates.get(registry.screenStates.entities[0]).hp_percentage = player.health / PLAYER_HEALTH;
+                registry().screenStates.get(registry().screenStates.entities[0]).hp_percentage = player.health / PLAYER_HEALTH;
             }
         }
-        if (registry.players.has(entity) && player.health <= 0)
+        if (registry().players.has(entity) && player.health <= 0)
         {
             Mix_PlayChannel(1, player_death_sound, 0);
             world_system.game_over(); // You'll need to pass WorldSystem reference
             return;
         }
 
-        if (registry.players.has(entity))
+        if (registry().players.has(entity))
         {
             // Add hit effect
-            registry.hitEffects.emplace_with_duplicates(entity);
+            registry().hitEffects.emplace_with_duplicates(entity);
 
             // Add screen shake
-            auto &screen = registry.screenStates.get(registry.screenStates.entities[0]);
+            auto &screen = registry().screenStates.get(registry().screenStates.entities[0]);
             screen.shake_duration_ms = 200.0f;
             screen.shake_intensity = 10.0f;
         }
@@ -83,12 +86,12 @@ void StatusSystem::update_zombie_attack(Entity entity, float elapsed_ms, WorldSy
 
 void StatusSystem::remove_expired_statuses(Entity entity)
 {
-    if (!registry.statuses.has(entity))
+    if (!registry().statuses.has(entity))
     {
         return;
     }
 
-    auto &status_comp = registry.statuses.get(entity);
+    auto &status_comp = registry().statuses.get(entity);
     auto initial_size = status_comp.active_statuses.size();
 
     // Use std::remove_if to remove expired statuses
@@ -103,37 +106,28 @@ void StatusSystem::remove_expired_statuses(Entity entity)
 
 void StatusSystem::handle_cooldowns(float elapsed_ms)
 {
-    auto &registry_cooldown = registry.cooldowns;
+    auto &registry_cooldown = registry().cooldowns;
     for (uint i = 0; i < registry_cooldown.size(); i++)
     {
         Cooldown &cooldown = registry_cooldown.components[i];
         cooldown.timer_ms -= elapsed_ms;
         if (cooldown.timer_ms <= 0)
-        {
-            Entity entity = registry_cooldown.entities[i];
-            registry_cooldown.remove(entity);
-        }
+            registry().deferred.remove(registry_cooldown, registry_cooldown.entities[i]);
     }
 }
 
 void StatusSystem::handle_hit_effects(float elapsed_ms)
 {
-    for (Entity entity : registry.hitEffects.entities)
+    // one entry per entity: a repeated hit shadows the older effect, which goes away together with it
+    registry().view<HitEffect>().each([&](Entity entity, HitEffect &hit)
     {
-        if (registry.hitEffects.has(entity))
-        {
-            auto &hit = registry.hitEffects.get(entity);
-
-            // Update duration
-            hit.duration_ms -= elapsed_ms;
+        // Update duration
+        hit.duration_ms -= elapsed_ms;
 
-            // Remove effect when done
-            if (hit.duration_ms <= 0)
-            {
-                registry.hitEffects.remove(entity);
-            }
-        }
-    }
+        // Remove effect when done
+        if (hit.duration_ms <= 0)
+            registry().deferred.remove(registry().hitEffects, entity);
+    });
 }
 
 bool StatusSystem::start_and_load_sounds()
@@ -168,14 +162,14 @@ bool StatusSystem::start_and_load_sounds()
 void StatusSystem::handle_projectile_attack(Entity entity, float elapsed_ms)
 {
     // Check if entity has necessary components
-    if (!registry.statuses.has(entity) || !registry.enemies.has(entity))
+    if (!registry().statuses.has(entity) || !registry().enemies.has(entity))
    
     {
         return;
     }
 
-    auto &status_comp = registry.statuses.get(entity);
-    auto &enemy = registry.enemies.get(entity);
+    auto &status_comp = registry().statuses.get(entity);
+    auto &enemy = registry().enemies.get(entity);
 
     // Process each status
     for (auto it = status_comp.active_statuses.begin(); it != status_comp.active_statuses.end();)
@@ -193,10 +187,10 @@ void StatusSystem::handle_projectile_attack(Entity entity, float elapsed_ms)
             it = status_comp.active_statuses.erase(it);
 
             // Only check for death after all damage is applied
-            if (enemy.health <= 0 && !registry.deathAnimations.has(entity))
+            if (enemy.health <= 0 && !registry().deathAnimations.has(entity))
             {
                 // Add death animation only if it doesn't already have one
-                registry.deathAnimations.emplace(entity);
+                registry().deathAnimations.emplace(entity);
 
                 // Increase player experience
                 WorldSystem::increase_exp();
@@ -0,0 +1,196 @@
+// internal
+#include "system_scheduler.hpp"
+#include "profiler.hpp"
+#include "world.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+SystemScheduler::SystemScheduler(ThreadPool &pool, World &world)
+	: pool(pool), world(world), epoch(std::chrono::steady_clock::now())
+{
+}
+
+void SystemScheduler::add(int stage, const char *name, FrameManager &frame_manager, SystemAccess access, std::function<void(float)> step)
+{
+	std::unique_ptr<System> system = std::make_unique<System>();
+	system->stage = stage;
+	system->name = name;
+	system->frame_manager = &frame_manager;
+	system->access = access;
+	system->step = std::move(step);
+	system->scheduler = this;
+	systems.push_back(std::move(system));
+	// reserved up front so run() never allocates
+	for (auto &registered : systems)
+		registered->dependents.reserve(systems.size());
+	roots.reserve(systems.size());
+	step_path.reserve(systems.size());
+	scratch_path_ms.reserve(systems.size());
+	scratch_previous.reserve(systems.size());
+	totals.critical_path.reserve(systems.size());
+}
+
+double SystemScheduler::now_ms() const
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void SystemScheduler::submit(System &system)
+{
+	pool.submit({&SystemScheduler::run_system, &system});
+}
+
+void SystemScheduler::run_system(void *arg)
+{
+	System &system = *static_cast<System *>(arg);
+	SystemScheduler &scheduler = *system.scheduler;
+	// pool workers have no world of their own, this system works on the scheduler's
+	World::Scope scope(scheduler.world);
+	system.start_ms = scheduler.now_ms();
+	{
+		PROFILE_SCOPE(system.name);
+		system.step(system.elapsed_ms);
+	}
+	system.duration_ms = scheduler.now_ms() - system.start_ms;
+	system.histogram.record(system.duration_ms);
+	// release the systems that waited for this one, on this thread's queue
+	for (int dependent : system.dependents)
+	{
+		if (--scheduler.systems[dependent]->waiting_for == 0)
+			scheduler.submit(*scheduler.systems[dependent]);
+	}
+	scheduler.remaining--;
+}
+
+void SystemScheduler::run(int stage)
+{
+	// pick the due systems and hand out their time on this thread, FrameManager is not thread-safe
+	int due_count = 0;
+	for (auto &system : systems)
+	{
+		system->due = system->stage == stage && system->frame_manager->can_update();
+		system->dependents.clear();
+		system->waiting_for = 0;
+		if (system->due)
+		{
+			system->elapsed_ms = system->frame_manager->get_time();
+			due_count++;
+		}
+	}
+	if (due_count == 0)
+		return;
+
+	// a system depends on every earlier due system it conflicts with
+	for (size_t j = 0; j < systems.size(); j++)
+	{
+		if (!systems[j]->due)
+			continue;
+		for (size_t i = 0; i < j; i++)
+		{
+			if (systems[i]->due && systems[i]->access.conflicts_with(systems[j]->access))
+			{
+				systems[i]->dependents.push_back((int)j);
+				systems[j]->waiting_for++;
+			}
+		}
+	}
+
+	// the systems that wait for nothing, picked before any of them runs: once one does, it releases
+	// its dependents, whose waiting_for then reads 0 as well and must not be submitted a second time
+	roots.clear();
+	for (auto &system : systems)
+	{
+		if (system->due && system->waiting_for == 0)
+			roots.push_back(system.get());
+	}
+	remaining = due_count;
+	for (System *root : roots)
+		submit(*root);
+	pool.help_until([this]() { return remaining == 0; });
+
+	// barrier: structural changes recorded by the stage
+	{
+		PROFILE_SCOPE("flush_deferred");
+		world.registry.flush_deferred();
+	}
+
+	// critical path: longest chain of durations through the dependencies, in registration order
+	std::vector<double> &path_ms = scratch_path_ms;
+	std::vector<int> &previous = scratch_previous;
+	path_ms.assign(systems.size(), 0.0);
+	previous.assign(systems.size(), -1);
+	int last = -1;
+	for (size_t j = 0; j < systems.size(); j++)
+	{
+		if (!systems[j]->due)
+			continue;
+		step_serial_ms += systems[j]->duration_ms;
+		path_ms[j] += systems[j]->duration_ms;
+		for (int dependent : systems[j]->dependents)
+		{
+			if (path_ms[j] > path_ms[dependent])
+			{
+				path_ms[dependent] = path_ms[j];
+				previous[dependent] = (int)j;
+			}
+		}
+		if (last < 0 || path_ms[j] > path_ms[last])
+			last = (int)j;
+	}
+	step_critical_ms += path_ms[last];
+	size_t path_start = step_path.size();
+	for (int i = last; i >= 0; i = previous[i])
+		step_path.push_back(systems[i]->name);
+	std::reverse(step_path.begin() + path_start, step_path.end());
+}
+
+void SystemScheduler::begin_step()
+{
+	step_start = std::chrono::steady_clock::now();
+	step_path.clear();
+	step_critical_ms = 0;
+	step_serial_ms = 0;
+}
+
+void SystemScheduler::end_step()
+{
+	totals.wall_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - step_start).count();
+	totals.serial_ms += step_serial_ms;
+	totals.critical_path_ms += step_critical_ms;
+	totals.steps++;
+	totals.critical_path.assign(step_path.begin(), step_path.end());
+}
+
+void SystemScheduler::reset_report()
+{
+	totals = Report();
+}
+
+void SystemScheduler::print_report(std::ostream &out) const
+{
+	if (totals.steps == 0)
+		return;
+	double steps = totals.steps;
+	out << std::fixed << std::setprecision(3) << "systems per step (" << totals.steps << " steps, "
+		<< pool.worker_count() << " workers): wall " << totals.wall_ms / steps << " ms, serial "
+		<< totals.serial_ms / steps << " ms, critical path " << totals.critical_path_ms / steps << " ms" << std::endl;
+	out << "last critical path:";
+	for (size_t i = 0; i < totals.critical_path.size(); i++)
+		out << (i == 0 ? " " : " > ") << totals.critical_path[i];
+	out << std::defaultfloat << std::endl;
+}
+
+void SystemScheduler::print_graph(std::ostream &out) const
+{
+	for (size_t j = 0; j < systems.size(); j++)
+	{
+		out << "[" << systems[j]->stage << "] " << systems[j]->name << " waits for:";
+		for (size_t i = 0; i < j; i++)
+		{
+			if (systems[i]->stage == systems[j]->stage && systems[i]->access.conflicts_with(systems[j]->access))
+				out << " " << systems[i]->name;
+		}
+		out << std::endl;
+	}
+}
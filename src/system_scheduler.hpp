@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "frame_manager.hpp"
+#include "telemetry.hpp"
+#include "thread_pool.hpp"
+#include "tinyECS/registry.hpp"
+
+class World;
+
+// What a system touches, so the scheduler knows which systems may run at the same time.
+// Resources are the registry's components (one bit each, as in registry().components_of) plus a few
+// kinds of game state outside the registry.
+struct SystemAccess
+{
+	// game state outside the registry, above the component bits
+	static constexpr uint64_t WORLD_STATE = uint64_t(1) << 63; // the World's game state and WorldSystem's (game screen, exp, ...)
+	static_assert(ECSRegistry::container_count < 63, "the resource bits sit above the component bits");
+
+	uint64_t reads = 0;
+	uint64_t writes = 0;
+	// creates entities, adds or removes components, or records into registry().deferred; these share the
+	// entity allocator, the membership mask and the command buffer, so two of them never overlap
+	bool structural = false;
+
+	template <typename... Ts>
+	SystemAccess &read()
+	{
+		reads |= (ECSRegistry::component_bit<Ts>() | ...);
+		return *this;
+	}
+	template <typename... Ts>
+	SystemAccess &write()
+	{
+		writes |= (ECSRegistry::component_bit<Ts>() | ...);
+		return *this;
+	}
+	SystemAccess &read_world()
+	{
+		reads |= WORLD_STATE;
+		return *this;
+	}
+	SystemAccess &write_world()
+	{
+		writes |= WORLD_STATE;
+		return *this;
+	}
+	// Systems that destroy entities remove components from every container
+	SystemAccess &write_all_components()
+	{
+		writes |= ~WORLD_STATE;
+		structural = true;
+		return *this;
+	}
+	SystemAccess &add_components()
+	{
+		structural = true;
+		return *this;
+	}
+
+	bool conflicts_with(const SystemAccess &other) const
+	{
+		return (structural && other.structural) || (writes & (other.reads | other.writes)) != 0 ||
+			   (other.writes & reads) != 0;
+	}
+};
+
+// Runs the systems of a simulation step as a task graph on a thread pool. Systems are registered in
+// the order a serial loop would call them; a system waits for every earlier system it conflicts
+// with (see SystemAccess) and runs concurrently with the rest. Systems are grouped in stages, and
+// run(stage) is a barrier: it returns once the stage is done, after applying registry().deferred.
+//
+// Every run records how long each system took; the critical path is the chain of dependent systems
+// with the largest total, i.e. the shortest the stage could take with unlimited threads. The times
+// of each system over the whole session are also kept in a histogram, see for_each_system.
+class SystemScheduler
+{
+public:
+	struct Report
+	{
+		double wall_ms = 0;			 // time from the start of the first stage to the end of the last
+		double serial_ms = 0;		 // sum of all system times, what a single thread would take
+		double critical_path_ms = 0; // sum over stages of the longest dependency chain
+		int steps = 0;
+		std::vector<const char *> critical_path; // systems on the critical path of the last step
+	};
+
+	// Systems run on the threads of pool, with world bound to them (see World::Scope)
+	SystemScheduler(ThreadPool &pool, World &world);
+
+	// Adds a system that runs on every frame_manager.can_update() step, with the time of frame_manager
+	void add(int stage, const char *name, FrameManager &frame_manager, SystemAccess access, std::function<void(float)> step);
+
+	// Runs the due systems of stage and applies the structural changes they recorded
+	void run(int stage);
+
+	// Starts / finishes the timing of one simulation step (all its stages)
+	void begin_step();
+	void end_step();
+
+	// Totals since the last reset_report()
+	const Report &report() const { return totals; }
+	void reset_report();
+	void print_report(std::ostream &out) const;
+
+	// Calls f(name, histogram) for every system, with the times of all its runs so far
+	template <typename F>
+	void for_each_system(F f) const
+	{
+		for (const auto &system : systems)
+			f(system->name, system->histogram);
+	}
+
+	// Which registered systems a system waits for, for debugging the access declarations
+	void print_graph(std::ostream &out) const;
+
+private:
+	struct System
+	{
+		int stage;
+		const char *name;
+		FrameManager *frame_manager;
+		SystemAccess access;
+		std::function<void(float)> step;
+		// state of the current run
+		bool due = false;
+		float elapsed_ms = 0;
+		std::atomic<int> waiting_for{0};
+		std::vector<int> dependents;
+		double start_ms = 0;
+		double duration_ms = 0;
+		SystemScheduler *scheduler = nullptr;
+		// every run, written only by the thread running the system
+		LatencyHistogram histogram;
+	};
+
+	ThreadPool &pool;
+	World &world;
+	std::vector<std::unique_ptr<System>> systems;
+	std::atomic<int> remaining{0};
+	std::vector<System *> roots; // the due systems of the current run that wait for nothing
+	std::chrono::steady_clock::time_point epoch;
+	std::chrono::steady_clock::time_point step_start;
+	std::vector<const char *> step_path;
+	double step_critical_ms = 0;
+	double step_serial_ms = 0;
+	// scratch for the critical path, kept to avoid allocating every run
+	std::vector<double> scratch_path_ms;
+	std::vector<int> scratch_previous;
+	Report totals;
+
+	double now_ms() const;
+	void submit(System &system);
+	static void run_system(void *arg);
+};
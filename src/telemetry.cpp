@@ -0,0 +1,133 @@
+// internal
+#include "telemetry.hpp"
+#include "system_scheduler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "../ext/json.hpp"
+using json = nlohmann::json;
+
+size_t LatencyHistogram::bucket_of(uint64_t us)
+{
+	if (us < SUB_BUCKETS)
+		return (size_t)us;
+	us = std::min(us, (uint64_t(1) << MAX_VALUE_BITS) - 1);
+	// shift so the value keeps SUB_BUCKET_BITS significant bits, the top one set
+	int shift = 1;
+	while ((us >> shift) >= SUB_BUCKETS)
+		shift++;
+	return (size_t)(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + ((us >> shift) - HALF_SUB_BUCKETS));
+}
+
+uint64_t LatencyHistogram::bucket_top(size_t bucket)
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+	int shift = (int)((bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS) + 1;
+	uint64_t sub_bucket = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+	return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(double ms)
+{
+	uint64_t us = ms > 0 ? (uint64_t)std::llround(ms * 1000.0) : 0;
+	counts[bucket_of(us)]++;
+	total++;
+	sum_us += (double)us;
+	max_us = std::max(max_us, us);
+}
+
+void LatencyHistogram::reset()
+{
+	*this = LatencyHistogram();
+}
+
+double LatencyHistogram::percentile_ms(double p) const
+{
+	if (total == 0)
+		return 0.0;
+	uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(p / 100.0 * (double)total));
+	uint64_t seen = 0;
+	for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+	{
+		seen += counts[bucket];
+		if (seen >= rank)
+			return std::min(bucket_top(bucket), max_us) / 1000.0;
+	}
+	return max_ms();
+}
+
+void FrameTelemetry::record_frame(double frame_ms)
+{
+	session.record(frame_ms);
+	window.record(frame_ms);
+	if (frame_ms > HITCH_MS)
+		hitches++;
+	if (frame_ms > SEVERE_HITCH_MS)
+		severe_hitches++;
+
+	window_elapsed_ms += frame_ms;
+	if (window_elapsed_ms >= WINDOW_MS)
+	{
+		std::snprintf(stats_line, sizeof(stats_line), "frame ms p50 %.1f  p95 %.1f  p99 %.1f  max %.1f  hitches %llu / %llu",
+					  window.percentile_ms(50), window.percentile_ms(95), window.percentile_ms(99), window.max_ms(),
+					  (unsigned long long)hitches, (unsigned long long)severe_hitches);
+		window.reset();
+		window_elapsed_ms = 0;
+	}
+}
+
+void FrameTelemetry::print_summary(std::ostream &out) const
+{
+	if (session.count() == 0)
+		return;
+	out << std::fixed << std::setprecision(2) << "frames: " << session.count() << ", frame time p50 "
+		<< session.percentile_ms(50) << " ms, p95 " << session.percentile_ms(95) << " ms, p99 "
+		<< session.percentile_ms(99) << " ms, max " << session.max_ms() << " ms, mean " << session.mean_ms()
+		<< " ms; hitches over " << HITCH_MS << " ms: " << hitches << ", over " << SEVERE_HITCH_MS << " ms: "
+		<< severe_hitches << std::defaultfloat << std::endl;
+}
+
+namespace
+{
+	json histogram_json(const LatencyHistogram &histogram)
+	{
+		return {
+			{"count", histogram.count()},
+			{"mean_ms", histogram.mean_ms()},
+			{"p50_ms", histogram.percentile_ms(50)},
+			{"p95_ms", histogram.percentile_ms(95)},
+			{"p99_ms", histogram.percentile_ms(99)},
+			{"max_ms", histogram.max_ms()},
+		};
+	}
+}
+
+bool FrameTelemetry::write_json(const std::string &path, const SystemScheduler &scheduler) const
+{
+	json systems = json::object();
+	scheduler.for_each_system([&](const char *name, const LatencyHistogram &histogram)
+							  { systems[name] = histogram_json(histogram); });
+	json out = {
+		{"frame", histogram_json(session)},
+		{"hitches", {{"threshold_ms", HITCH_MS}, {"count", hitches}}},
+		{"severe_hitches", {{"threshold_ms", SEVERE_HITCH_MS}, {"count", severe_hitches}}},
+		{"systems", systems},
+	};
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file)
+	{
+		std::cerr << "ERROR: cannot write the telemetry to " << path << std::endl;
+		return false;
+	}
+	file << std::setw(2) << out << std::endl;
+	std::cout << "Wrote frame telemetry to " << path << std::endl;
+	return bool(file);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class SystemScheduler;
+
+// Durations in log-linear buckets, as in HdrHistogram: every power of two is split in 32 equal
+// buckets, so a recorded value is off by at most 1/32 (3%) whatever its size, from 1 us to a minute,
+// in a fixed 5.5 KiB table. Recording is an index computation and an increment; percentiles walk
+// the table.
+class LatencyHistogram
+{
+public:
+	void record(double ms);
+	void reset();
+
+	uint64_t count() const { return total; }
+	double mean_ms() const { return total ? sum_us / total / 1000.0 : 0.0; }
+	double max_ms() const { return max_us / 1000.0; }
+	// The smallest duration that p percent of the recorded ones do not exceed (to the bucket's 3%)
+	double percentile_ms(double p) const;
+
+private:
+	static constexpr int SUB_BUCKET_BITS = 6;
+	static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+	static constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+	static constexpr int MAX_VALUE_BITS = 26; // 67 s in microseconds, longer ones are clamped
+	static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+	uint64_t counts[BUCKET_COUNT] = {};
+	uint64_t total = 0;
+	double sum_us = 0;
+	uint64_t max_us = 0;
+
+	static size_t bucket_of(uint64_t us);
+	// The largest value that falls in bucket
+	static uint64_t bucket_top(size_t bucket);
+};
+
+// Frame times of the game: their distribution over the session and over the last second, and the
+// hitches, frames that took longer than one (16.7 ms) or two (33.3 ms) refreshes of a 60 Hz display.
+// Shows a one-line summary on screen (see RenderSystem::stats_line) and writes the session's
+// numbers, with the per-system times of the scheduler, to a JSON file to compare builds.
+class FrameTelemetry
+{
+public:
+	static constexpr double HITCH_MS = 1000.0 / 60.0;
+	static constexpr double SEVERE_HITCH_MS = 2000.0 / 60.0;
+	// how often the on-screen line is refreshed, from the frames since the last refresh
+	static constexpr double WINDOW_MS = 1000.0;
+
+	void record_frame(double frame_ms);
+
+	// p50/p95/p99/max of the last window and the hitch counts, for the HUD
+	const char *get_stats_line() const { return stats_line; }
+
+	const LatencyHistogram &get_session() const { return session; }
+	uint64_t get_hitches() const { return hitches; }
+	uint64_t get_severe_hitches() const { return severe_hitches; }
+
+	void print_summary(std::ostream &out) const;
+	// The session's frame and system times as JSON; false if the file cannot be written
+	bool write_json(const std::string &path, const SystemScheduler &scheduler) const;
+
+private:
+	LatencyHistogram session;
+	LatencyHistogram window;
+	double window_elapsed_ms = 0;
+	uint64_t hitches = 0;
+	uint64_t severe_hitches = 0;
+	char stats_line[128] = "";
+};
@@ -0,0 +1,183 @@
+// Entry point of broadphase_test: runs BodyCollisions (see broadphase.hpp) on a crowd that moves,
+// grows and shrinks, and checks after every step that the broadphase has every pair of overlapping
+// boxes once, and that registry().collisions holds exactly the pairs PhysicsSystem::collides accepts,
+// once each and none left from an earlier step. It then writes them out and reads them back the way
+// WorldSystem saves and loads a game, the only code that reads Collision. Exits with a failure at the
+// first step that breaks any of these.
+//
+//   broadphase_test [--steps N] [--seed N]
+//
+// The steps pass no time, so that enemies are not pushed apart while the pairs are compared.
+
+// stdlib
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// internal
+#include "broadphase.hpp"
+#include "motion_kernels.hpp"
+#include "physics_system.hpp"
+#include "random.hpp"
+#include "world.hpp"
+
+namespace
+{
+	using IdPair = std::pair<unsigned int, unsigned int>;
+
+	IdPair id_pair(Entity a, Entity b)
+	{
+		return std::minmax(a.id(), b.id());
+	}
+
+	// The pairs of collisions, sorted
+	std::vector<IdPair> pairs_of(ComponentContainer<Collision> &collisions)
+	{
+		std::vector<IdPair> pairs;
+		for (size_t i = 0; i < collisions.size(); i++)
+			pairs.push_back(id_pair(collisions.entities[i], collisions.components[i].other));
+		std::sort(pairs.begin(), pairs.end());
+		return pairs;
+	}
+
+	// Whether the boxes SweepAndPrune puts around the bounding circles of a and b overlap
+	bool boxes_overlap(const Motion &a, const Motion &b)
+	{
+		float a_radius = length(abs(a.scale) / 2.f);
+		float b_radius = length(abs(b.scale) / 2.f);
+		return a.position.x - a_radius <= b.position.x + b_radius && b.position.x - b_radius <= a.position.x + a_radius &&
+			   a.position.y - a_radius <= b.position.y + b_radius && b.position.y - b_radius <= a.position.y + a_radius;
+	}
+
+	// Every pair of enemies and players whose boxes overlap, and those of them that collide, sorted
+	void find_pairs(std::vector<IdPair> &overlapping, std::vector<IdPair> &colliding)
+	{
+		std::vector<Entity> bodies = registry().enemies.entities;
+		bodies.insert(bodies.end(), registry().players.entities.begin(), registry().players.entities.end());
+		overlapping.clear();
+		colliding.clear();
+		for (size_t i = 0; i < bodies.size(); i++)
+		{
+			for (size_t j = i + 1; j < bodies.size(); j++)
+			{
+				const Motion &a = registry().motions.get(bodies[i]);
+				const Motion &b = registry().motions.get(bodies[j]);
+				if (boxes_overlap(a, b))
+					overlapping.push_back(id_pair(bodies[i], bodies[j]));
+				if (PhysicsSystem::collides(a, b))
+					colliding.push_back(id_pair(bodies[i], bodies[j]));
+			}
+		}
+		std::sort(overlapping.begin(), overlapping.end());
+		std::sort(colliding.begin(), colliding.end());
+	}
+
+	Entity create_walker(Rng &random, float side, float max_speed)
+	{
+		Entity entity;
+		registry().enemies.emplace(entity);
+		Motion &motion = registry().motions.emplace(entity);
+		motion.position = {random.uniform(0, side), random.uniform(0, side)};
+		float angle = random.uniform(0, 2 * M_PI);
+		motion.velocity = vec2(std::cos(angle), std::sin(angle)) * random.uniform(0, max_speed);
+		motion.scale = {ENEMY_WIDTH, ENEMY_HEIGHT};
+		return entity;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int steps = 600;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--steps") && has_value)
+			steps = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--steps N] [--seed N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	World world;
+	World::Scope scope(world);
+	Rng random(seed);
+	const float side = 800.f;
+	const float max_speed = 600.f;
+	for (int i = 0; i < 300; i++)
+		create_walker(random, side, max_speed);
+	Entity player;
+	registry().players.emplace(player);
+	Motion &player_motion = registry().motions.emplace(player);
+	player_motion.position = {side / 2, side / 2};
+	player_motion.scale = {PLAYER_WIDTH, PLAYER_HEIGHT};
+
+	const float step_ms = 1000.f / 60.f;
+	BodyCollisions body_collisions;
+	ComponentContainer<Motion> &motions = registry().motions;
+	for (int step = 1; step <= steps; step++)
+	{
+		integrate_motions(motions.components.data(), motions.size(), step_ms / 1000.f);
+		for (Motion &motion : motions.components)
+		{
+			if ((motion.position.x < 0 && motion.velocity.x < 0) || (motion.position.x > side && motion.velocity.x > 0))
+				motion.velocity.x = -motion.velocity.x;
+			if ((motion.position.y < 0 && motion.velocity.y < 0) || (motion.position.y > side && motion.velocity.y > 0))
+				motion.velocity.y = -motion.velocity.y;
+		}
+		// a few die and a few spawn every step, and now and then a wave large enough to sort from scratch
+		for (int i = 0; i < 3 && !registry().enemies.entities.empty(); i++)
+			registry().remove_all_components_of(registry().enemies.entities[random.below((uint32_t)registry().enemies.size())]);
+		for (int i = 0; i < (step % 200 == 0 ? 200 : 3); i++)
+			create_walker(random, side, max_speed);
+
+		body_collisions.step(0.f);
+
+		std::vector<IdPair> overlapping, expected;
+		find_pairs(overlapping, expected);
+		const SweepAndPrune &broadphase = body_collisions.get_broadphase();
+		std::vector<IdPair> found;
+		for (SweepAndPrune::Pair pair : broadphase.get_pairs())
+			found.push_back(id_pair(broadphase.get_entity(pair.a), broadphase.get_entity(pair.b)));
+		std::sort(found.begin(), found.end());
+		if (found != overlapping)
+		{
+			std::cerr << "FAILED at step " << step << ": the broadphase has " << found.size() << " pairs, "
+					  << overlapping.size() << " boxes overlap" << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::vector<IdPair> recorded = pairs_of(registry().collisions);
+		if (recorded != expected || body_collisions.get_collision_count() != expected.size())
+		{
+			std::cerr << "FAILED at step " << step << ": " << recorded.size() << " collisions recorded ("
+					  << body_collisions.get_collision_count() << " counted), " << expected.size() << " expected" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		// WorldSystem::saveGame writes the container, loadGame reads it back entry by entry
+		json saved = registry().collisions.toJSON();
+		ComponentContainer<Collision> loaded;
+		for (const json &collision : saved)
+		{
+			Entity e = Entity(collision["entity"].get<int>());
+			Entity other = Entity(collision["other"].get<int>());
+			loaded.emplace_with_duplicates(e, other);
+		}
+		if (pairs_of(loaded) != expected)
+		{
+			std::cerr << "FAILED at step " << step << ": " << pairs_of(loaded).size() << " collisions loaded, "
+					  << expected.size() << " saved" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	std::cout << "broadphase_test: " << steps << " steps passed" << std::endl;
+	return EXIT_SUCCESS;
+}
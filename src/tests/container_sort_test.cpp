@@ -0,0 +1,98 @@
+// Entry point of container_sort_test: sorts component containers (see ComponentContainer::sort in
+// tinyECS/tiny_ecs.hpp) and checks that every entity still maps to its own component.
+// Exits with a failure and prints the mismatches if one does not.
+
+// stdlib
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// internal
+#include "tinyECS/components.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool condition, const char *what, unsigned int id)
+	{
+		if (condition)
+			return;
+		std::cerr << "FAILED: " << what << " (entity " << id << ")" << std::endl;
+		failures++;
+	}
+
+	// Gives each entity a Motion at x = its id, sorts with less and checks order and lookups
+	template <typename Less>
+	void check_sort(const char *name, Less less)
+	{
+		ComponentContainer<Motion> motions;
+		std::vector<Entity> entities;
+		// index 0 is the null entity; insert in an order the comparisons below do not match
+		for (unsigned int i = 1; i <= 200; i++)
+		{
+			Entity e((int)((i * 37) % 211));
+			entities.push_back(e);
+			motions.emplace(e).position.x = (float)e.id();
+		}
+		motions.sort(less);
+
+		for (size_t i = 1; i < motions.entities.size(); i++)
+			check(!less(motions.entities[i], motions.entities[i - 1]), name, motions.entities[i].id());
+		for (Entity e : entities)
+		{
+			check(motions.has(e), name, e.id());
+			check(motions.get(e).position.x == (float)e.id(), name, e.id());
+		}
+		for (size_t i = 0; i < motions.size(); i++)
+			check(motions.components[i].position.x == (float)motions.entities[i].id(), name, motions.entities[i].id());
+	}
+}
+
+int main()
+{
+	check_sort("ascending ids", [](Entity a, Entity b) { return a.id() < b.id(); });
+	check_sort("descending ids", [](Entity a, Entity b) { return a.id() > b.id(); });
+	check_sort("odd ids first", [](Entity a, Entity b) { return (a.id() & 1) > (b.id() & 1); });
+
+	// the older copy left by emplace_with_duplicates keeps its value, the index the newest
+	{
+		ComponentContainer<Motion> motions;
+		Entity a(5), b(3);
+		motions.emplace(a).position.x = 1;
+		motions.emplace(b).position.x = 2;
+		motions.emplace_with_duplicates(a).position.x = 3;
+		motions.sort([](Entity x, Entity y) { return x.id() < y.id(); });
+		check(motions.get(a).position.x == 3, "duplicates: the index points at the newest copy", a.id());
+		check(motions.get(b).position.x == 2, "duplicates: other entities keep their component", b.id());
+		float older = 0;
+		for (size_t i = 0; i < motions.size(); i++)
+		{
+			if (motions.entities[i].id() == a.id() && !motions.is_indexed(i))
+				older = motions.components[i].position.x;
+		}
+		check(older == 1, "duplicates: the older copy keeps its value", a.id());
+	}
+
+	// tags have no payload, only the entities and the index move
+	{
+		ComponentContainer<MoveWithCamera> tags;
+		for (unsigned int i = 1; i <= 50; i++)
+			tags.emplace(Entity((int)(51 - i)));
+		tags.sort([](Entity x, Entity y) { return x.id() < y.id(); });
+		for (unsigned int i = 1; i <= 50; i++)
+		{
+			check(tags.has(Entity((int)i)), "tags: every entity is still tagged", i);
+			check(tags.entities[i - 1].id() == i, "tags: sorted", i);
+		}
+	}
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " checks failed" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "container_sort_test: all checks passed" << std::endl;
+	return EXIT_SUCCESS;
+}
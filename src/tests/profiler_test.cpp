@@ -0,0 +1,111 @@
+// Entry point of profiler_test: records scopes as if long after the profiler's epoch, writes them
+// with Profiler::write_chrome_trace and reads the file back, checking that every timestamp and
+// duration comes back to the nanosecond. Exits with a failure if one does not.
+//
+//   profiler_test [--trace PATH]
+//
+// The trace goes to profiler_test.json in the working directory unless PATH is given.
+
+// stdlib
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+// internal
+#include "../../ext/json.hpp"
+#include "profiler.hpp"
+
+using json = nlohmann::json;
+
+namespace
+{
+	struct Scope
+	{
+		const char *name;
+		uint64_t start_ns;
+		uint64_t duration_ns;
+	};
+
+	// From the first microsecond to a day into the run; the default ostream format kept 6 digits,
+	// so everything after a second came out as e.g. 1.25123e+08
+	const Scope SCOPES[] = {
+		{"start", 1, 999},
+		{"second", 1000000007, 1500},
+		{"two_minutes", 125123456789, 1500},
+		{"long_frame", 125123456789, 16666667},
+		{"day", 86400000000001, 10},
+	};
+}
+
+int main(int argc, char *argv[])
+{
+	std::string path = "profiler_test.json";
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--trace") && has_value)
+			path = argv[++i];
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--trace PATH]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	Profiler::clear();
+	for (const Scope &scope : SCOPES)
+		Profiler::record(scope.name, scope.start_ns, scope.start_ns + scope.duration_ns);
+	if (!Profiler::write_chrome_trace(path))
+	{
+		std::cerr << "FAILED: cannot write " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream in(path);
+	std::stringstream text;
+	text << in.rdbuf();
+	if (text.str().find("e+") != std::string::npos)
+	{
+		std::cerr << "FAILED: " << path << " has a timestamp in scientific notation" << std::endl;
+		return EXIT_FAILURE;
+	}
+	json trace = json::parse(text.str());
+
+	int failures = 0;
+	size_t found = 0;
+	for (const json &event : trace["traceEvents"])
+	{
+		if (event["ph"] != "X")
+			continue;
+		for (const Scope &scope : SCOPES)
+		{
+			if (event["name"] != scope.name)
+				continue;
+			found++;
+			// microseconds with three decimals, so rounding to whole nanoseconds gives them back
+			uint64_t start_ns = (uint64_t)std::llround(event["ts"].get<double>() * 1000.0);
+			uint64_t duration_ns = (uint64_t)std::llround(event["dur"].get<double>() * 1000.0);
+			if (start_ns != scope.start_ns || duration_ns != scope.duration_ns)
+			{
+				std::cerr << "FAILED: " << scope.name << " written at " << event["ts"] << " for " << event["dur"]
+						  << " us, recorded at " << scope.start_ns << " for " << scope.duration_ns << " ns" << std::endl;
+				failures++;
+			}
+		}
+	}
+	if (found != std::size(SCOPES))
+	{
+		std::cerr << "FAILED: " << found << " of " << std::size(SCOPES) << " scopes in the trace" << std::endl;
+		failures++;
+	}
+	if (failures)
+		return EXIT_FAILURE;
+	std::cout << "profiler_test: " << found << " scopes passed" << std::endl;
+	return EXIT_SUCCESS;
+}
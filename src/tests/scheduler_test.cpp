@@ -0,0 +1,127 @@
+// Entry point of scheduler_test: steps a SystemScheduler (see system_scheduler.hpp) for many ticks on
+// several workers and checks that every due system runs exactly once per run, after the systems
+// it waits for. Exits with a failure at the first tick that breaks either.
+//
+//   scheduler_test [--workers N] [--ticks N]
+//
+// The systems mirror the shape of Simulation's: some conflict and run in a chain, some run on
+// every second or third tick only, the rest run alongside. A system submitted twice used to make
+// run() wait forever, so ctest also runs this with a timeout.
+
+// stdlib
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// internal
+#include "system_scheduler.hpp"
+#include "world.hpp"
+
+namespace
+{
+	struct TestSystem
+	{
+		const char *name;
+		int interval;
+		SystemAccess access;
+		std::vector<int> waits_for; // earlier systems of the same stage it conflicts with
+		FrameManager frame_manager;
+		std::atomic<int> runs{0};
+		std::atomic<int> order_errors{0};
+
+		TestSystem(const char *name, int interval, SystemAccess access)
+			: name(name), interval(interval), access(access), frame_manager(interval)
+		{
+		}
+	};
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int worker_count = 3;
+	int ticks = 20000;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--workers") && has_value)
+			worker_count = (unsigned int)std::max(0, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--ticks") && has_value)
+			ticks = std::max(1, std::atoi(argv[++i]));
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--workers N] [--ticks N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	World world;
+	World::Scope scope(world);
+	ThreadPool pool(worker_count);
+	SystemScheduler scheduler(pool, world);
+
+	// one stage: a chain through Motion, with independent systems registered between its links
+	std::vector<std::unique_ptr<TestSystem>> systems;
+	systems.push_back(std::make_unique<TestSystem>("integrate", 1, SystemAccess().write<Motion>()));
+	systems.push_back(std::make_unique<TestSystem>("enemies", 1, SystemAccess().write<Enemy>()));
+	systems.push_back(std::make_unique<TestSystem>("towers", 3, SystemAccess().write<Tower>()));
+	systems.push_back(std::make_unique<TestSystem>("follow", 1, SystemAccess().read<Motion>().write<Camera>()));
+	systems.push_back(std::make_unique<TestSystem>("texts", 2, SystemAccess().write<Text>()));
+	systems.push_back(std::make_unique<TestSystem>("collide", 1, SystemAccess().read<Motion>().write<Collision>()));
+	systems.push_back(std::make_unique<TestSystem>("separate", 2, SystemAccess().write<Motion, Enemy>()));
+	systems.push_back(std::make_unique<TestSystem>("render", 1, SystemAccess().read<Motion, RenderRequest>()));
+	for (size_t j = 0; j < systems.size(); j++)
+	{
+		for (size_t i = 0; i < j; i++)
+		{
+			if (systems[i]->access.conflicts_with(systems[j]->access))
+				systems[j]->waits_for.push_back((int)i);
+		}
+	}
+
+	for (auto &owned : systems)
+	{
+		TestSystem *system = owned.get();
+		scheduler.add(0, system->name, system->frame_manager, system->access, [system, &systems](float) {
+			// every system it waits for that is due this tick has run once more than it so far
+			int tick_runs = system->runs + 1;
+			for (int earlier : system->waits_for)
+			{
+				const TestSystem &other = *systems[earlier];
+				if (other.runs < tick_runs * system->interval / other.interval)
+					system->order_errors++;
+			}
+			// some work, so that the workers overlap
+			volatile float sink = 0;
+			for (int i = 0; i < 200; i++)
+				sink = sink + (float)i;
+			system->runs++;
+		});
+	}
+
+	for (int tick = 1; tick <= ticks; tick++)
+	{
+		for (auto &system : systems)
+			system->frame_manager.tick(1000.f / 60.f);
+		scheduler.begin_step();
+		scheduler.run(0);
+		scheduler.end_step();
+
+		for (auto &system : systems)
+		{
+			int expected = tick / system->interval;
+			if (system->runs != expected || system->order_errors != 0)
+			{
+				std::cerr << "FAILED at tick " << tick << ": " << system->name << " ran " << system->runs
+						  << " times, expected " << expected << ", " << system->order_errors
+						  << " times before a system it waits for" << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	std::cout << "scheduler_test: " << ticks << " ticks on " << worker_count << " workers passed" << std::endl;
+	return EXIT_SUCCESS;
+}
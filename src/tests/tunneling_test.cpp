@@ -0,0 +1,121 @@
+// Entry point of tunneling_test: fires projectiles at 1000 px/s through two 20 px enemies in a row
+// and steps PhysicsSystem at 60, 30, 20 and 10 Hz until each shot is gone, checking that every shot
+// hits the near enemy and none passes through it or hits the far one first. Exits with a failure
+// if one does.
+//
+//   tunneling_test [--shots N]
+//
+// Each step rate fires N shots (default 200), spread over where the steps fall along the way and
+// over offsets across the targets up to just inside their reach. Tested only where they end a
+// step, 6 of these shots hit the far enemy at 60 Hz, and at 10 Hz 108 passed through both.
+
+// stdlib
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// internal
+#include "physics_system.hpp"
+#include "world.hpp"
+
+namespace
+{
+	const float SHOT_SPEED = 1000.f;  // px/s
+	const float TARGET_SIZE = 20.f;	  // px, the width and height of both enemies
+	const float TARGET_GAP = 60.f;	  // px between their centres, so no circle reaches both
+	const float PROJECTILE_SIZE = 10.f; // as TowerSystem fires them
+
+	enum class Outcome
+	{
+		NEAR_HIT,
+		FAR_HIT,
+		MISSED,
+	};
+
+	Entity create_target(vec2 position)
+	{
+		Entity entity;
+		registry().enemies.emplace(entity);
+		Motion &motion = registry().motions.emplace(entity);
+		motion.position = position;
+		motion.scale = {TARGET_SIZE, TARGET_SIZE};
+		return entity;
+	}
+
+	// Fires one shot along +x from start, offset across the targets, and steps physics every step_ms
+	// until it is gone or well past both targets
+	Outcome fire(float step_ms, float start, float offset)
+	{
+		World world;
+		World::Scope scope(world);
+		world.game_screen = GAME_SCREEN_ID::PLAYING;
+		Entity screen;
+		registry().screenStates.emplace(screen);
+		PhysicsSystem physics;
+
+		vec2 near_position = {500.f, 500.f};
+		Entity near_target = create_target(near_position);
+		Entity far_target = create_target(near_position + vec2(TARGET_GAP, 0.f));
+		Entity projectile;
+		registry().projectiles.emplace(projectile).speed = SHOT_SPEED;
+		Motion &motion = registry().motions.emplace(projectile);
+		motion.position = {start, near_position.y + offset};
+		motion.velocity = {SHOT_SPEED, 0.f};
+		motion.scale = {PROJECTILE_SIZE, PROJECTILE_SIZE};
+
+		float end = near_position.x + TARGET_GAP + 200.f;
+		while (registry().projectiles.has(projectile) && registry().motions.get(projectile).position.x < end)
+			physics.step(step_ms);
+
+		// a projectile is gone after its first hit, so the far enemy is never touched when all is well
+		if (registry().statuses.has(far_target))
+			return Outcome::FAR_HIT;
+		return registry().statuses.has(near_target) ? Outcome::NEAR_HIT : Outcome::MISSED;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int shots = 200;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--shots") && has_value)
+			shots = std::max(1, std::atoi(argv[++i]));
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--shots N]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	// PhysicsSystem::collides: the centres closer than the larger circle, the target's
+	float reach = length(vec2(TARGET_SIZE, TARGET_SIZE) / 2.f);
+	bool failed = false;
+	for (float step_ms : {1000.f / 60.f, 1000.f / 30.f, 1000.f / 20.f, 1000.f / 10.f})
+	{
+		float step_px = SHOT_SPEED * step_ms / 1000.f;
+		int far_hits = 0;
+		int misses = 0;
+		for (int shot = 0; shot < shots; shot++)
+		{
+			// the starts cover one step's way, the offsets (in another order) the targets' reach
+			float start = 200.f + step_px * shot / shots;
+			float offset = 0.95f * reach * (2.f * ((shot * 7) % shots) / shots - 1.f);
+			Outcome outcome = fire(step_ms, start, offset);
+			far_hits += outcome == Outcome::FAR_HIT;
+			misses += outcome == Outcome::MISSED;
+		}
+		std::cout << std::fixed << std::setprecision(1) << "tunneling_test: " << step_ms << " ms steps, " << shots
+				  << " shots: " << misses << " passed through, " << far_hits << " hit the far enemy" << std::endl;
+		failed = failed || misses > 0 || far_hits > 0;
+	}
+	if (failed)
+	{
+		std::cerr << "FAILED: projectiles tunnelled through the near enemy" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+// internal
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+// index of the queue owned by the current thread, or ~0u for threads outside the pool
+static thread_local const ThreadPool *current_pool = nullptr;
+static thread_local unsigned int current_queue = ~0u;
+
+ThreadPool::ThreadPool(unsigned int worker_count)
+{
+	for (unsigned int i = 0; i <= worker_count; i++)
+		queues.push_back(std::make_unique<Queue>());
+	for (unsigned int i = 0; i < worker_count; i++)
+		workers.emplace_back([this, i]() { worker_loop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread &worker : workers)
+		worker.join();
+}
+
+unsigned int ThreadPool::default_worker_count()
+{
+	unsigned int cores = std::thread::hardware_concurrency();
+	return cores > 1 ? std::min(cores - 1, 7u) : 0;
+}
+
+unsigned int ThreadPool::home_queue() const
+{
+	if (current_pool == this)
+		return current_queue;
+	return (unsigned int)queues.size() - 1;
+}
+
+bool ThreadPool::push(Queue &queue, Job job)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.count == QUEUE_CAPACITY)
+		return false;
+	queue.jobs[(queue.head + queue.count) % QUEUE_CAPACITY] = job;
+	queue.count++;
+	return true;
+}
+
+bool ThreadPool::pop_back(Queue &queue, Job &job)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.count == 0)
+		return false;
+	queue.count--;
+	job = queue.jobs[(queue.head + queue.count) % QUEUE_CAPACITY];
+	return true;
+}
+
+bool ThreadPool::steal_front(Queue &queue, Job &job)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.count == 0)
+		return false;
+	job = queue.jobs[queue.head];
+	queue.head = (queue.head + 1) % QUEUE_CAPACITY;
+	queue.count--;
+	return true;
+}
+
+bool ThreadPool::take(unsigned int home, Job &job)
+{
+	bool found = pop_back(*queues[home], job);
+	for (unsigned int i = 1; !found && i < queues.size(); i++)
+		found = steal_front(*queues[(home + i) % queues.size()], job);
+	if (found)
+		queued--;
+	return found;
+}
+
+void ThreadPool::submit(Job job)
+{
+	queued++;
+	if (!push(*queues[home_queue()], job))
+	{
+		// queue full: run it right away rather than block
+		queued--;
+		job.run(job.arg);
+		return;
+	}
+	if (!workers.empty())
+	{
+		// take the lock so a worker about to sleep cannot miss the notification
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+	}
+	wake.notify_one();
+}
+
+void ThreadPool::worker_loop(unsigned int index)
+{
+	current_pool = this;
+	current_queue = index;
+	while (true)
+	{
+		Job job;
+		if (take(index, job))
+		{
+			job.run(job.arg);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [this]() { return stopping || queued > 0; });
+		if (stopping)
+			return;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A small work-stealing thread pool. Every worker (and the thread that submits, usually the main
+// thread) owns a queue: a thread pushes and pops at the back of its own queue, and steals from the
+// front of the others when it runs dry. Jobs are a function pointer and an argument, so submitting
+// never allocates.
+class ThreadPool
+{
+public:
+	struct Job
+	{
+		void (*run)(void *arg);
+		void *arg;
+	};
+
+	// worker_count threads besides the caller; 0 runs every job on the thread that waits for it
+	explicit ThreadPool(unsigned int worker_count);
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	// A worker count that leaves one core for the main thread
+	static unsigned int default_worker_count();
+
+	unsigned int worker_count() const { return (unsigned int)workers.size(); }
+
+	// Queues a job on the calling thread's queue
+	void submit(Job job);
+
+	// Runs queued jobs on the calling thread until done() returns true
+	template <typename Done>
+	void help_until(Done &&done)
+	{
+		while (!done())
+		{
+			Job job;
+			if (take(home_queue(), job))
+				job.run(job.arg);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+private:
+	static constexpr unsigned int QUEUE_CAPACITY = 256;
+
+	// fixed-size ring buffer, guarded by its own lock
+	struct Queue
+	{
+		std::mutex mutex;
+		Job jobs[QUEUE_CAPACITY];
+		unsigned int head = 0; // front, where thieves take
+		unsigned int count = 0;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues; // one per worker, the last one for outside threads
+	std::vector<std::thread> workers;
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::atomic<int> queued{0};
+	std::atomic<bool> stopping{false};
+
+	unsigned int home_queue() const;
+	bool push(Queue &queue, Job job);
+	bool pop_back(Queue &queue, Job &job);
+	bool steal_front(Queue &queue, Job &job);
+	// own queue first, then the others
+	bool take(unsigned int home, Job &job);
+	void worker_loop(unsigned int index);
+};
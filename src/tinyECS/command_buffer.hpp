@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "tiny_ecs.hpp"
+
+// Records structural changes (adding or removing components, destroying entities) so that a system
+// can make them while it is iterating a container, and applies them later in one pass, in the order
+// they were recorded. Until then every entity keeps all its components, so loops neither skip the
+// entity swapped into a removed slot nor hold references into a container that just shrank.
+//
+// The registry owns one buffer (registry.deferred); systems that record into it apply it with
+// registry.flush_deferred() at the end of their step.
+class CommandBuffer
+{
+	enum class CommandType
+	{
+		EMPLACE,
+		REMOVE,
+		DESTROY
+	};
+
+	struct Command
+	{
+		CommandType type;
+		Entity entity;
+		void *container;						   // REMOVE only
+		void (*remove)(void *container, Entity e); // REMOVE only, calls ComponentContainer::remove of the right type
+		std::function<void()> emplace;			   // EMPLACE only, inserts the recorded component
+	};
+
+	std::vector<Command> commands;
+
+public:
+	// Adds a component to e when the buffer is applied, replacing the one e has by then (if any).
+	// Skipped if e was destroyed in the meantime.
+	template <typename Component, typename... Args>
+	void emplace(ComponentContainer<Component> &container, Entity e, Args &&...args)
+	{
+		ComponentContainer<Component> *target = &container;
+		commands.push_back({CommandType::EMPLACE, e, nullptr, nullptr,
+							[target, e, component = Component(std::forward<Args>(args)...)]() mutable
+							{
+								if (Component *existing = target->try_get(e))
+									*existing = std::move(component);
+								else
+									target->insert(e, std::move(component));
+							}});
+	}
+
+	// Removes the component of e from container when the buffer is applied
+	template <typename Component>
+	void remove(ComponentContainer<Component> &container, Entity e)
+	{
+		commands.push_back({CommandType::REMOVE, e, &container,
+							[](void *target, Entity entity)
+							{ static_cast<ComponentContainer<Component> *>(target)->remove(entity); },
+							nullptr});
+	}
+
+	// Removes all components of e and releases its handle when the buffer is applied.
+	// Destroying the same entity twice is harmless, the second one finds a stale handle.
+	void destroy(Entity e)
+	{
+		commands.push_back({CommandType::DESTROY, e, nullptr, nullptr, nullptr});
+	}
+
+	// Drops all recorded commands without applying them (e.g. when the whole registry is cleared)
+	void clear() { commands.clear(); }
+
+	bool empty() const { return commands.empty(); }
+	size_t size() const { return commands.size(); }
+
+	// Applies and clears all recorded commands, skipping those for entities that entities no longer
+	// holds; destroy_entity performs a DESTROY
+	template <typename DestroyFunc>
+	void flush(const EntityAllocator &entities, DestroyFunc &&destroy_entity)
+	{
+		// commands may be recorded while flushing (e.g. by destroy_entity), they are applied in this pass too
+		for (size_t i = 0; i < commands.size(); i++)
+		{
+			Command command = std::move(commands[i]);
+			switch (command.type)
+			{
+			case CommandType::EMPLACE:
+				if (entities.is_alive(command.entity))
+					command.emplace();
+				break;
+			case CommandType::REMOVE:
+				command.remove(command.container, command.entity);
+				break;
+			case CommandType::DESTROY:
+				destroy_entity(command.entity);
+				break;
+			}
+		}
+		commands.clear();
+	}
+};
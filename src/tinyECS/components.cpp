@@ -5,6 +5,7 @@
 #include "../ext/stb_image/stb_image.h"
 
 // stlib
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -118,3 +119,80 @@ bool Mesh::loadFromOBJFile(std::string obj_path, std::vector<ColoredVertex>& out
 
 	return true;
 }
+
+// Makes node the node of triangles order[first, first + count) (indices of triangles in corners,
+// three corners each), splitting them in halves around the median of their centres along the longer
+// side of its box until the leaves are small. Reorders order so that every node's triangles are
+// together
+static void build_bvh(const std::vector<vec2> &corners, std::vector<uint32_t> &order, std::vector<Mesh::BVHNode> &bvh,
+					  uint32_t node, uint32_t first, uint32_t count)
+{
+	vec2 min_corner = corners[order[first] * 3];
+	vec2 max_corner = min_corner;
+	for (uint32_t i = first; i < first + count; i++)
+	{
+		for (uint32_t corner = 0; corner < 3; corner++)
+		{
+			min_corner = glm::min(min_corner, corners[order[i] * 3 + corner]);
+			max_corner = glm::max(max_corner, corners[order[i] * 3 + corner]);
+		}
+	}
+	bvh[node] = {min_corner, max_corner, first * 3, count};
+	if (count <= Mesh::BVH_LEAF_TRIANGLES)
+		return;
+
+	int axis = max_corner.x - min_corner.x >= max_corner.y - min_corner.y ? 0 : 1;
+	auto centre = [&](uint32_t triangle)
+	{
+		return corners[triangle * 3][axis] + corners[triangle * 3 + 1][axis] + corners[triangle * 3 + 2][axis];
+	};
+	std::nth_element(order.begin() + first, order.begin() + first + count / 2, order.begin() + first + count,
+					 [&](uint32_t a, uint32_t b) { return centre(a) < centre(b); });
+	uint32_t children = (uint32_t)bvh.size();
+	bvh.resize(bvh.size() + 2);
+	bvh[node].first = children;
+	bvh[node].count = 0;
+	build_bvh(corners, order, bvh, children, first, count / 2);
+	build_bvh(corners, order, bvh, children + 1, first + count / 2, count - count / 2);
+}
+
+void Mesh::build_collision_data()
+{
+	triangles.clear();
+	bvh.clear();
+	for (size_t i = 0; i + 2 < vertex_indices.size(); i += 3)
+	{
+		for (size_t corner = 0; corner < 3; corner++)
+			triangles.push_back(vec2(vertices[vertex_indices[i + corner]].position));
+	}
+	if (triangles.empty())
+	{
+		local_min = local_max = bounding_center = {0, 0};
+		bounding_radius = 0;
+		return;
+	}
+
+	local_min = local_max = triangles[0];
+	for (vec2 corner : triangles)
+	{
+		local_min = glm::min(local_min, corner);
+		local_max = glm::max(local_max, corner);
+	}
+	bounding_center = (local_min + local_max) / 2.f;
+	bounding_radius = 0;
+	for (vec2 corner : triangles)
+		bounding_radius = std::max(bounding_radius, length(corner - bounding_center));
+
+	uint32_t triangle_count = (uint32_t)(triangles.size() / 3);
+	if (triangle_count < BVH_MIN_TRIANGLES)
+		return;
+	std::vector<uint32_t> order(triangle_count);
+	for (uint32_t i = 0; i < triangle_count; i++)
+		order[i] = i;
+	bvh.resize(1);
+	build_bvh(triangles, order, bvh, 0, 0, triangle_count);
+	std::vector<vec2> corners = std::move(triangles);
+	triangles.clear();
+	for (uint32_t triangle : order)
+		triangles.insert(triangles.end(), corners.begin() + triangle * 3, corners.begin() + triangle * 3 + 3);
+}
@@ -2,6 +2,7 @@
 #include "common.hpp"
 #include <vector>
 #include <unordered_map>
+#include "memory.hpp"
 #include "../ext/stb_image/stb_image.h"
 #include "plants.hpp"
 
@@ -73,7 +74,7 @@ struct Status
 
 struct StatusComponent
 {
-    std::vector<Status> active_statuses;
+    SmallVector<Status, 4> active_statuses;
     json toJSON() const
     {
         json statusesJson = json::array();
@@ -167,13 +168,12 @@ struct Player
     }
 };
 
+// Tag, the health of a zombie is in its Enemy component
 struct Zombie
 {
-    float health;
     json toJSON() const
     {
-        return json{
-            {"health", health}};
+        return json{};
     }
 };
 
@@ -196,7 +196,7 @@ struct Skeleton
     float stop_distance = 200.f;        // Distance to stop moving
     float attack_cooldown_ms = 10000.f; // Attack cooldown time
     float cooldown_timer_ms = 0.f;      // Current cooldown timer
-    Entity target = {};                 // Current target
+    Entity target = Entity::null();     // Current target
     bool is_attacking = false;          // Is currently attacking
     float health = SKELETON_HEALTH;     // Health of the skeleton
 
@@ -238,7 +238,7 @@ struct OrcRider
     };
 
     State current_state = State::IDLE;
-    Entity target = {};
+    Entity target = Entity::null();
 
     float detection_range = 100000.0f; // Range to start walking towards player
     float hunt_range = 500.0f;        // Range to start hunting behavior
@@ -279,7 +279,7 @@ struct OrcRider
 
 struct Arrow
 {
-    Entity source = {};          // Source entity that fired the arrow
+    Entity source = Entity::null(); // Source entity that fired the arrow
     float damage = 15.f;         // Damage value
     float lifetime_ms = 2000.f;  // Lifetime in milliseconds
     float speed = 250.f;         // Flight speed
@@ -305,7 +305,7 @@ struct ZombieSpawn
 
 struct Projectile
 {
-    Entity source = {};          // The tower that fired this projectile
+    Entity source = Entity::null(); // The tower that fired this projectile
     float damage = 10.f;         // Damage taken from tower
     float speed = 200.f;         // Projectile speed
     float lifetime_ms = 2000.f;  // How long the projectile lasts
@@ -420,7 +420,7 @@ struct Collision
 {
     // Note, the first object is stored in the ECS container.entities
     Entity other; // the second object involved in the collision
-    Collision(Entity &other) { this->other = other; };
+    Collision(Entity &other) : other(other) {};
     json toJSON() const
     {
         return json{
@@ -565,6 +565,28 @@ struct Mesh
     vec2 original_size = {1, 1};
     std::vector<ColoredVertex> vertices;
     std::vector<uint16_t> vertex_indices;
+
+    // Collision data, in the units of vertices (a Motion places them at position + scale * vertex),
+    // made by build_collision_data once the mesh is loaded
+    struct BVHNode
+    {
+        vec2 min;
+        vec2 max;
+        uint32_t first; // a leaf's first corner in triangles, an inner node's first child in bvh
+        uint32_t count; // a leaf's triangles, 0 for an inner node (children at first and first + 1)
+    };
+    // meshes with fewer triangles are tested one triangle after the other
+    static constexpr size_t BVH_MIN_TRIANGLES = 16;
+    static constexpr size_t BVH_LEAF_TRIANGLES = 4;
+    vec2 local_min = {0, 0}; // box around the vertices
+    vec2 local_max = {0, 0};
+    vec2 bounding_center = {0, 0}; // circle around them
+    float bounding_radius = 0;
+    std::vector<vec2> triangles; // the corners of each triangle, three after another, in BVH order
+    std::vector<BVHNode> bvh;    // root first; empty under BVH_MIN_TRIANGLES
+
+    // Fills the collision data from vertices and vertex_indices
+    void build_collision_data();
     json toJSON() const
     {
         json vertices_json = json::array();
@@ -662,10 +684,10 @@ struct ParticleGenerator
     unsigned int amount;           // Maximum number of particles
     float spawnInterval;           // Time between spawning particles
     float timer;                   // Current timer
-    std::vector<Entity> particles; // List of particle entities
+    SmallVector<Entity, 16> particles; // List of particle entities
     bool isActive;                 // Whether generator is active
     float duration_ms;             // How long this generator remains active (-1 for infinite)
-    Entity follow_entity = Entity(); // Entity to follow (if any) - Fixed NULL to Entity()
+    Entity follow_entity = Entity::null(); // Entity to follow (if any)
     float max_visible_distance = 800.0f; // Maximum distance from player to be visible
     
     ParticleGenerator()
@@ -680,7 +702,7 @@ struct ParticleGenerator
 
 // Text
 struct Text {
-	std::string text;
+	SmallString<32> text;
 	vec2 pos;
 	float size;
 	vec3 color = vec3(0.0f, 0.0f, 0.0f);
@@ -704,9 +726,9 @@ struct CG
 struct Squad
 {
     int squad_id;
-    std::vector<Entity> archers;
-    std::vector<Entity> orcs;
-    std::vector<Entity> knights;
+    SmallVector<Entity, 8> archers;
+    SmallVector<Entity, 8> orcs;
+    SmallVector<Entity, 8> knights;
     vec2 formation_center;
     vec2 last_player_pos = {0, 0}; // Used to track player movement
     float coordination_timer = 0.f;
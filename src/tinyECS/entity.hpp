@@ -1,17 +1,27 @@
 #pragma once
 
+#include <vector>
+#include <assert.h>
+
 // Unique identifier for all entities
+// The 32-bit handle is split into an index (low bits) and a generation (high bits). Indices of
+// destroyed entities are recycled through a free-list, and the generation is bumped on every
+// recycle so that handles kept around after a destroy no longer match the new owner of the index.
 class Entity
 {
+public:
+    static constexpr unsigned int INDEX_BITS = 20;
+    static constexpr unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr unsigned int GENERATION_BITS = 32 - INDEX_BITS;
+    static constexpr unsigned int GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+private:
     unsigned int m_id;
-    static unsigned int id_count; // defaults to 0 (invalid), need to init 1
 
 public:
-    Entity()
-    {
-        // ensure that each entity gets a unique ID
-        m_id = id_count++; // assign and increment
-    }
+    // A new entity of the registry bound to the calling thread (see registry()), re-using the
+    // indices of destroyed entities first
+    Entity();
 
     Entity(int id)
     {
@@ -22,11 +32,80 @@ public:
     {
     }
 
+    // The null handle (index 0), never handed out by the default constructor and allocates nothing
+    static Entity null() { return Entity(0); }
+    bool is_null() const { return index() == 0; }
+
     operator unsigned int() { return m_id; } // enables automatic casting to int
 
     unsigned int id() const { return m_id; }
+    unsigned int index() const { return m_id & INDEX_MASK; }
+    unsigned int generation() const { return m_id >> INDEX_BITS; }
+};
 
-    static void overrideIDCount(int count) { id_count = count; }
-    static int get_id_count() { return id_count; }
+// Hands out the entities of one registry: the indices in use, a free-list of destroyed ones and the
+// current generation of every index. Each registry has its own, so entities of different worlds
+// are numbered independently.
+class EntityAllocator
+{
+public:
+    Entity allocate()
+    {
+        unsigned int index;
+        if (!free_indices.empty())
+        {
+            index = free_indices.back();
+            free_indices.pop_back();
+        }
+        else
+        {
+            index = id_count++; // assign and increment
+            assert(index <= Entity::INDEX_MASK && "Ran out of entity indices");
+        }
+        if (index >= generations.size())
+            generations.resize(index + 1, 0);
+        return Entity((int)((generations[index] << Entity::INDEX_BITS) | index));
+    }
+
+    // Returns the index of e to the free-list. Releasing a stale or null handle does nothing.
+    void release(Entity e)
+    {
+        unsigned int index = e.index();
+        if (index == 0 || index >= id_count)
+            return;
+        if (index >= generations.size())
+            generations.resize(index + 1, 0);
+        // handles restored from a save file carry a generation the table does not know yet
+        if (generations[index] != UNKNOWN_GENERATION && e.generation() != generations[index])
+            return;
+        generations[index] = (e.generation() + 1) & Entity::GENERATION_MASK;
+        free_indices.push_back(index);
+    }
+
+    // False once e has been released (destroyed), or for the null handle
+    bool is_alive(Entity e) const
+    {
+        unsigned int index = e.index();
+        if (index == 0 || index >= id_count)
+            return false;
+        if (index >= generations.size() || generations[index] == UNKNOWN_GENERATION)
+            return true;
+        return generations[index] == e.generation();
+    }
+
+    // Used when loading a save file: every index below count may be referenced by a loaded handle,
+    // so fresh indices start at count and nothing is recycled until those entities are destroyed.
+    void overrideIDCount(int count)
+    {
+        id_count = count;
+        free_indices.clear();
+        generations.assign(count, UNKNOWN_GENERATION);
+    }
+    int get_id_count() const { return id_count; }
 
-};
\ No newline at end of file
+private:
+    unsigned int id_count = 1; // next never-used index; 0 is the null handle
+    std::vector<unsigned int> free_indices; // indices of destroyed entities, ready for re-use
+    std::vector<unsigned int> generations;  // current generation of every index handed out
+    static constexpr unsigned int UNKNOWN_GENERATION = ~0u; // index restored from a save file
+};
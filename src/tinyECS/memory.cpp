@@ -0,0 +1,176 @@
+// internal
+#include "memory.hpp"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+static std::atomic<uint64_t> heap_allocations{0};
+static uint64_t pool_fresh_blocks = 0;
+static uint64_t pool_reused_blocks = 0;
+static thread_local uint64_t arena_overflows = 0;
+static thread_local size_t arena_high_water = 0;
+
+thread_local FrameArena frame_arena(64 * 1024);
+
+#if defined(FARMER_DEFENSE_COUNT_ALLOCS)
+// Replaces the global operator new / delete to count every heap allocation made through them.
+// The array and nothrow forms forward to these.
+void *operator new(size_t size)
+{
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void *p = std::malloc(size == 0 ? 1 : size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+#endif
+
+MemoryStats memory_stats()
+{
+	MemoryStats stats;
+	stats.heap_allocations = heap_allocations.load(std::memory_order_relaxed);
+	stats.pool_fresh_blocks = pool_fresh_blocks;
+	stats.pool_reused_blocks = pool_reused_blocks;
+	stats.arena_overflows = arena_overflows;
+	stats.arena_high_water = arena_high_water;
+	return stats;
+}
+
+bool memory_counts_heap_allocations()
+{
+#if defined(FARMER_DEFENSE_COUNT_ALLOCS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+BlockPool &component_pool()
+{
+	// constructed on first use, components may be created during static initialization
+	static BlockPool *pool = new BlockPool();
+	return *pool;
+}
+
+size_t BlockPool::class_of(size_t bytes)
+{
+	size_t size_class = 0;
+	while ((MIN_BLOCK << size_class) < bytes)
+		size_class++;
+	return size_class;
+}
+
+void *BlockPool::allocate(size_t &bytes)
+{
+	size_t size_class = class_of(bytes);
+	if (size_class >= CLASS_COUNT)
+	{
+		// too large to pool
+		std::lock_guard<std::mutex> lock(mutex);
+		pool_fresh_blocks++;
+		return ::operator new(bytes);
+	}
+	bytes = MIN_BLOCK << size_class;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (FreeBlock *block = free_lists[size_class])
+	{
+		free_lists[size_class] = block->next;
+		pool_reused_blocks++;
+		return block;
+	}
+	pool_fresh_blocks++;
+	return ::operator new(bytes);
+}
+
+void BlockPool::deallocate(void *block, size_t bytes)
+{
+	size_t size_class = class_of(bytes);
+	if (size_class >= CLASS_COUNT)
+	{
+		// oversized blocks are not recycled
+		::operator delete(block);
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	FreeBlock *free_block = static_cast<FreeBlock *>(block);
+	free_block->next = free_lists[size_class];
+	free_lists[size_class] = free_block;
+}
+
+FrameArena::FrameArena(size_t capacity)
+	: buffer(static_cast<char *>(std::malloc(capacity))), size(capacity)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	for (void *block : overflow)
+		std::free(block);
+	std::free(buffer);
+}
+
+void *FrameArena::allocate(size_t bytes, size_t alignment)
+{
+	size_t start = (offset + alignment - 1) & ~(alignment - 1);
+	if (start + bytes <= size)
+	{
+		offset = start + bytes;
+		arena_high_water = std::max(arena_high_water, offset + overflow_bytes);
+		return buffer + start;
+	}
+	// out of space for this frame: serve it from the heap and grow the buffer on the next reset
+	arena_overflows++;
+	overflow_bytes += bytes + alignment;
+	arena_high_water = std::max(arena_high_water, offset + overflow_bytes);
+	void *block = std::malloc(bytes + alignment);
+	overflow.push_back(block);
+	uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	return reinterpret_cast<void *>(aligned);
+}
+
+const char *FrameArena::format(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	va_list measure;
+	va_copy(measure, args);
+	int length = std::vsnprintf(nullptr, 0, fmt, measure);
+	va_end(measure);
+	if (length < 0)
+	{
+		va_end(args);
+		return "";
+	}
+	char *text = static_cast<char *>(allocate(length + 1, 1));
+	std::vsnprintf(text, length + 1, fmt, args);
+	va_end(args);
+	return text;
+}
+
+void FrameArena::reset()
+{
+	if (!overflow.empty())
+	{
+		for (void *block : overflow)
+			std::free(block);
+		overflow.clear();
+		size_t grown = size + overflow_bytes;
+		std::free(buffer);
+		buffer = static_cast<char *>(std::malloc(grown));
+		size = grown;
+		overflow_bytes = 0;
+	}
+	offset = 0;
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Allocation strategies for component data that would otherwise live in its own std::vector or
+// std::string, and the counters that show how often the game still reaches the global allocator.
+//
+// - SmallVector / SmallString keep their first N elements inside the component. Longer ones move
+//   into blocks of the component pool, which are recycled, never returned to the system, so a
+//   game that has warmed up keeps reusing the same blocks.
+// - frame_arena is a linear allocator reset at the start of every frame, for data that only lives
+//   for one frame (e.g. the strings formatted for the HUD).
+
+// Counters for the game's memory use, see memory_stats()
+struct MemoryStats
+{
+	uint64_t heap_allocations = 0;	 // calls to the global operator new, only counted when built with FARMER_DEFENSE_COUNT_ALLOCS
+	uint64_t pool_fresh_blocks = 0;	 // component pool blocks taken from the heap
+	uint64_t pool_reused_blocks = 0; // component pool blocks recycled from the free lists
+	uint64_t arena_overflows = 0;	 // frame arena requests that did not fit and went to the heap, on the calling thread
+	size_t arena_high_water = 0;	 // most frame arena bytes used in one frame, on the calling thread
+};
+MemoryStats memory_stats();
+// True if heap_allocations is counted
+bool memory_counts_heap_allocations();
+
+// Fixed-size blocks in power-of-two size classes, each with a free list
+class BlockPool
+{
+public:
+	static constexpr size_t MIN_BLOCK = 32;
+	static constexpr size_t CLASS_COUNT = 12; // 32 B .. 64 KiB, larger requests go to the heap
+
+	// Returns a block of at least bytes; bytes is raised to the size actually reserved
+	void *allocate(size_t &bytes);
+	// Gives back a block returned by allocate, with the size allocate reported
+	void deallocate(void *block, size_t bytes);
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+	FreeBlock *free_lists[CLASS_COUNT] = {};
+	std::mutex mutex;
+
+	static size_t class_of(size_t bytes);
+};
+
+// The pool shared by all components, of every world. It is never destroyed, so containers may give
+// their blocks back at any time, static destruction included.
+BlockPool &component_pool();
+
+// Linear allocator: allocations are a pointer bump, everything is released at once by reset()
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity);
+	~FrameArena();
+	FrameArena(const FrameArena &) = delete;
+	FrameArena &operator=(const FrameArena &) = delete;
+
+	void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T *allocate_array(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "the arena never runs destructors");
+		T *array = static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+		std::uninitialized_value_construct_n(array, count);
+		return array;
+	}
+
+	// printf into the arena; the string is valid until the next reset()
+	const char *format(const char *fmt, ...);
+
+	// Releases all allocations. If the last frame overflowed, the buffer grows to fit it.
+	void reset();
+
+	size_t used() const { return offset; }
+	size_t capacity() const { return size; }
+
+private:
+	char *buffer;
+	size_t size;
+	size_t offset = 0;
+	size_t overflow_bytes = 0;
+	std::vector<void *> overflow; // blocks of requests that did not fit, freed by reset()
+};
+
+// One frame's worth of scratch memory, reset by the loop driving the game. One per thread, so games
+// driven from different threads (see World) each have their own
+extern thread_local FrameArena frame_arena;
+
+// A vector storing up to N elements inline, and more in blocks of the component pool
+template <typename T, size_t N>
+class SmallVector
+{
+public:
+	using value_type = T;
+	using iterator = T *;
+	using const_iterator = const T *;
+
+	SmallVector() = default;
+	SmallVector(std::initializer_list<T> values)
+	{
+		reserve(values.size());
+		for (const T &value : values)
+			push_back(value);
+	}
+	SmallVector(const SmallVector &other)
+	{
+		reserve(other.m_size);
+		std::uninitialized_copy(other.begin(), other.end(), m_data);
+		m_size = other.m_size;
+	}
+	SmallVector(SmallVector &&other) noexcept { take(other); }
+	SmallVector &operator=(const SmallVector &other)
+	{
+		if (this != &other)
+		{
+			clear();
+			reserve(other.m_size);
+			std::uninitialized_copy(other.begin(), other.end(), m_data);
+			m_size = other.m_size;
+		}
+		return *this;
+	}
+	SmallVector &operator=(SmallVector &&other) noexcept
+	{
+		if (this != &other)
+		{
+			clear();
+			release();
+			take(other);
+		}
+		return *this;
+	}
+	~SmallVector()
+	{
+		clear();
+		release();
+	}
+
+	T *begin() { return m_data; }
+	T *end() { return m_data + m_size; }
+	const T *begin() const { return m_data; }
+	const T *end() const { return m_data + m_size; }
+	T *data() { return m_data; }
+	const T *data() const { return m_data; }
+	size_t size() const { return m_size; }
+	size_t capacity() const { return m_capacity; }
+	bool empty() const { return m_size == 0; }
+	bool is_inline() const { return m_data == inline_data(); }
+
+	T &operator[](size_t i) { return m_data[i]; }
+	const T &operator[](size_t i) const { return m_data[i]; }
+	T &front() { return m_data[0]; }
+	T &back() { return m_data[m_size - 1]; }
+	const T &front() const { return m_data[0]; }
+	const T &back() const { return m_data[m_size - 1]; }
+
+	void reserve(size_t capacity)
+	{
+		if (capacity > m_capacity)
+			grow(capacity);
+	}
+
+	template <typename... Args>
+	T &emplace_back(Args &&...args)
+	{
+		if (m_size == m_capacity)
+			grow(m_capacity * 2);
+		T *slot = new (m_data + m_size) T(std::forward<Args>(args)...);
+		m_size++;
+		return *slot;
+	}
+	void push_back(const T &value) { emplace_back(value); }
+	void push_back(T &&value) { emplace_back(std::move(value)); }
+	void pop_back() { m_data[--m_size].~T(); }
+
+	T *erase(const T *position) { return erase(position, position + 1); }
+	T *erase(const T *first, const T *last)
+	{
+		T *from = m_data + (first - m_data);
+		T *to = m_data + (last - m_data);
+		T *new_end = std::move(to, end(), from);
+		std::destroy(new_end, end());
+		m_size = new_end - m_data;
+		return from;
+	}
+
+	// Keeps the storage, a SmallVector that has grown once does not allocate again
+	void clear()
+	{
+		std::destroy(begin(), end());
+		m_size = 0;
+	}
+
+	bool operator==(const SmallVector &other) const
+	{
+		return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+	}
+	bool operator!=(const SmallVector &other) const { return !(*this == other); }
+
+private:
+	T *m_data = inline_data();
+	size_t m_size = 0;
+	size_t m_capacity = N;
+	size_t m_block_bytes = 0; // size of the pool block holding m_data, 0 while inline
+	alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+	T *inline_data() { return reinterpret_cast<T *>(m_inline); }
+	const T *inline_data() const { return reinterpret_cast<const T *>(m_inline); }
+
+	void grow(size_t capacity)
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "pool blocks are only aligned for fundamental types");
+		size_t bytes = std::max(capacity, N * 2) * sizeof(T);
+		T *block = static_cast<T *>(component_pool().allocate(bytes));
+		std::uninitialized_move(begin(), end(), block);
+		std::destroy(begin(), end());
+		release();
+		m_data = block;
+		m_capacity = bytes / sizeof(T);
+		m_block_bytes = bytes;
+	}
+
+	// Frees the pool block (if any) of an empty vector, making it inline again
+	void release()
+	{
+		if (m_block_bytes != 0)
+			component_pool().deallocate(m_data, m_block_bytes);
+		m_data = inline_data();
+		m_capacity = N;
+		m_block_bytes = 0;
+	}
+
+	// Moves the contents of other into this empty, inline vector
+	void take(SmallVector &other)
+	{
+		if (other.m_block_bytes != 0)
+		{
+			// steal the block
+			m_data = other.m_data;
+			m_capacity = other.m_capacity;
+			m_block_bytes = other.m_block_bytes;
+			m_size = other.m_size;
+			other.m_data = other.inline_data();
+			other.m_capacity = N;
+			other.m_block_bytes = 0;
+			other.m_size = 0;
+		}
+		else
+		{
+			std::uninitialized_move(other.begin(), other.end(), m_data);
+			m_size = other.m_size;
+			other.clear();
+		}
+	}
+};
+
+// A string storing up to N - 1 characters inline (the last byte is the terminator), and longer
+// ones in the component pool. Converts to std::string_view for reading.
+template <size_t N>
+class SmallString
+{
+public:
+	SmallString() { chars.push_back('\0'); }
+	SmallString(std::string_view text) { assign(text); }
+	SmallString(const char *text) { assign(text); }
+	SmallString(const std::string &text) { assign(text); }
+
+	SmallString &operator=(std::string_view text)
+	{
+		assign(text);
+		return *this;
+	}
+	SmallString &operator=(const char *text) { return *this = std::string_view(text); }
+	SmallString &operator=(const std::string &text) { return *this = std::string_view(text); }
+
+	const char *c_str() const { return chars.data(); }
+	const char *data() const { return chars.data(); }
+	size_t size() const { return chars.size() - 1; }
+	bool empty() const { return size() == 0; }
+	const char *begin() const { return chars.begin(); }
+	const char *end() const { return chars.end() - 1; }
+
+	operator std::string_view() const { return std::string_view(data(), size()); }
+	std::string str() const { return std::string(data(), size()); }
+
+	bool operator==(const SmallString &other) const { return chars == other.chars; }
+	bool operator!=(const SmallString &other) const { return !(chars == other.chars); }
+	bool operator==(std::string_view other) const { return std::string_view(*this) == other; }
+	bool operator==(const char *other) const { return std::string_view(*this) == other; }
+
+private:
+	SmallVector<char, N> chars;
+
+	void assign(std::string_view text)
+	{
+		chars.clear();
+		chars.reserve(text.size() + 1);
+		for (char c : text)
+			chars.push_back(c);
+		chars.push_back('\0');
+	}
+};
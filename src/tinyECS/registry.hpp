@@ -1,7 +1,15 @@
 #pragma once
 #include <vector>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <cstdio>
+#include <typeinfo>
+#include <iterator>
 
 #include "tiny_ecs.hpp"
+#include "view.hpp"
+#include "command_buffer.hpp"
 #include "components.hpp"
 
 class ECSRegistry
@@ -9,8 +17,6 @@ class ECSRegistry
 	
 
 public:
-// callbacks to remove a particular or all entities in the system
-	std::vector<ContainerInterface*> registry_list;
 	ComponentContainer<Attack> attacks;
 	ComponentContainer<Motion> motions;
 	ComponentContainer<Collision> collisions;
@@ -64,75 +70,265 @@ public:
 
 	ComponentContainer<ElectricityData> customData;
 
-	// constructor that adds all containers for looping over them
+	// structural changes recorded while iterating, applied by flush_deferred()
+	CommandBuffer deferred;
+
+	// the entities of this registry, see Entity()
+	EntityAllocator entities;
+
+	// Every container, in save-file order: the position of a container is its key in the save file
+	// and its bit in the membership mask. Append new component types at the end to keep old saves loadable.
+	static constexpr auto containers = std::make_tuple(
+		&ECSRegistry::screenStates,         // 0
+		&ECSRegistry::attacks,              // 1
+		&ECSRegistry::motions,              // 2
+		&ECSRegistry::collisions,           // 3
+		&ECSRegistry::meshPtrs,             // 4
+		&ECSRegistry::dimensions,           // 5
+		&ECSRegistry::renderRequests,       // 6
+		&ECSRegistry::colors,               // 7
+		&ECSRegistry::towers,               // 8
+		&ECSRegistry::gridLines,            // 9
+		&ECSRegistry::zombies,              // 10
+		&ECSRegistry::zombieSpawns,         // 11
+		&ECSRegistry::players,              // 12
+		&ECSRegistry::statuses,             // 13
+		&ECSRegistry::states,               // 14
+		&ECSRegistry::animations,           // 15
+		&ECSRegistry::deaths,               // 16
+		&ECSRegistry::cooldowns,            // 17
+		&ECSRegistry::deathAnimations,      // 18
+		&ECSRegistry::hitEffects,           // 19
+		&ECSRegistry::projectiles,          // 20
+		&ECSRegistry::cameras,              // 21
+		&ECSRegistry::skeletons,            // 22
+		&ECSRegistry::arrows,               // 23
+		&ECSRegistry::visualScales,         // 24
+		&ECSRegistry::enemies,              // 25
+		&ECSRegistry::inventorys,           // 26
+		&ECSRegistry::seeds,                // 27
+		&ECSRegistry::moveWithCameras,      // 28
+		&ECSRegistry::mapTiles,             // 29
+		&ECSRegistry::particles,            // 30
+		&ECSRegistry::particleGenerators,   // 31
+		&ECSRegistry::texts,                // 32
+		&ECSRegistry::cgs,                  // 33
+		&ECSRegistry::buttons,              // 34
+		&ECSRegistry::plantAnimations,      // 35
+		&ECSRegistry::orcRiders,            // 36
+		&ECSRegistry::squads,               // 37
+		&ECSRegistry::slowEffects,          // 38
+		&ECSRegistry::customData,           // 39
+		&ECSRegistry::scorchedEarths,       // 40
+		&ECSRegistry::tutorialTiles,        // 41
+		&ECSRegistry::tutorialSigns,        // 42
+		&ECSRegistry::toolbars              // 43
+	);
+	static constexpr size_t container_count = std::tuple_size_v<decltype(containers)>;
+	static_assert(container_count <= 64, "the membership mask has one bit per component type");
+	// member names of the containers, in the same order
+	static constexpr const char *container_names[] = {
+		"screenStates",
+		"attacks",
+		"motions",
+		"collisions",
+		"meshPtrs",
+		"dimensions",
+		"renderRequests",
+		"colors",
+		"towers",
+		"gridLines",
+		"zombies",
+		"zombieSpawns",
+		"players",
+		"statuses",
+		"states",
+		"animations",
+		"deaths",
+		"cooldowns",
+		"deathAnimations",
+		"hitEffects",
+		"projectiles",
+		"cameras",
+		"skeletons",
+		"arrows",
+		"visualScales",
+		"enemies",
+		"inventorys",
+		"seeds",
+		"moveWithCameras",
+		"mapTiles",
+		"particles",
+		"particleGenerators",
+		"texts",
+		"cgs",
+		"buttons",
+		"plantAnimations",
+		"orcRiders",
+		"squads",
+		"slowEffects",
+		"customData",
+		"scorchedEarths",
+		"tutorialTiles",
+		"tutorialSigns",
+		"toolbars"
+	};
+	static_assert(std::size(container_names) == container_count, "every container needs a name");
+
+	// bit i is set in membership[e.index()] while e has a component in container i
+	std::vector<uint64_t> membership;
+
+	// Containers with change tracking, see ComponentContainer::changed_since. Their writers stamp
+	// changes through modify() / mark_changed(): motions when the position, angle or scale is set or
+	// integration moves them (not for a new velocity alone), render requests when the texture
+	// changes, towers when their state or health does (not their attack countdown); texts are only
+	// ever added and removed
+	static constexpr auto versioned_containers = std::make_tuple(
+		&ECSRegistry::motions,
+		&ECSRegistry::renderRequests,
+		&ECSRegistry::towers,
+		&ECSRegistry::texts
+	);
+	// clock of the change tracking; a consumer that has handled all changes stores change_tick and
+	// later asks changed_since(stored) for what happened since
+	uint32_t change_tick = 1;
+
 	ECSRegistry() {
-		registry_list.push_back(&screenStates); //0
-		registry_list.push_back(&attacks);//1
-		registry_list.push_back(&motions);//2
-		registry_list.push_back(&collisions);//3
-		registry_list.push_back(&meshPtrs);//4
-		registry_list.push_back(&dimensions);//5
-		registry_list.push_back(&renderRequests);//6
-		registry_list.push_back(&colors);//7
-		registry_list.push_back(&towers);//8
-		registry_list.push_back(&gridLines);//9
-		registry_list.push_back(&zombies);//10
-		registry_list.push_back(&zombieSpawns);//11
-		registry_list.push_back(&players);//12
-		registry_list.push_back(&statuses);//13
-		registry_list.push_back(&states);//14
-		registry_list.push_back(&animations);//15
-		registry_list.push_back(&deaths);//16
-		registry_list.push_back(&cooldowns);//17
-		registry_list.push_back(&deathAnimations);//18
-		registry_list.push_back(&hitEffects);//19
-		registry_list.push_back(&projectiles);//20
-		registry_list.push_back(&cameras);//21
-		registry_list.push_back(&skeletons);//22
-		registry_list.push_back(&arrows);//23
-		registry_list.push_back(&visualScales);//24
-		registry_list.push_back(&enemies);//25
-		registry_list.push_back(&inventorys);//26
-		registry_list.push_back(&seeds);//27
-		registry_list.push_back(&moveWithCameras);//28
-		registry_list.push_back(&mapTiles);//29
-		registry_list.push_back(&particles);//30
-		registry_list.push_back(&particleGenerators);//31
-		registry_list.push_back(&texts); //32
-		registry_list.push_back(&cgs); //33
-		registry_list.push_back(&buttons); //34
-		registry_list.push_back(&plantAnimations); //35
-		registry_list.push_back(&orcRiders); //36
-		registry_list.push_back(&squads); //37
-		registry_list.push_back(&slowEffects); //38
-		registry_list.push_back(&customData); //39
+		for_each_container([this](auto &container, size_t i) {
+			container.track_membership(&membership, uint64_t(1) << i);
+		});
+		std::apply([this](auto... versioned) { ((this->*versioned).track_changes(&change_tick), ...); }, versioned_containers);
+	}
+
+	// sync point once per frame: later changes are stamped with the next tick
+	void advance_tick() {
+		change_tick++;
+	}
+
+	// the container holding components of type T, e.g. container<Motion>() is motions
+	template <typename T>
+	ComponentContainer<T>& container() {
+		return this->*std::get<ComponentContainer<T> ECSRegistry::*>(containers);
+	}
+
+	// all entities that have every component in Cs and none of the excluded ones, see View
+	template <typename... Cs, typename... Es>
+	View<std::tuple<Cs...>, std::tuple<Es...>> view(exclude_t<Es...> = {}) {
+		return View<std::tuple<Cs...>, std::tuple<Es...>>(container<Cs>()..., container<Es>()...);
+	}
+
+	// calls func(container, index) for every container, in save-file order
+	template <typename Func>
+	void for_each_container(Func &&func) {
+		for_each_container(func, std::make_index_sequence<container_count>{});
+	}
+
+	// bitmask of the containers e has components in
+	uint64_t components_of(Entity e) const {
+		return e.index() < membership.size() ? membership[e.index()] : 0;
+	}
+
+	// the bit of the container of T in components_of
+	template <typename T>
+	static constexpr uint64_t component_bit() {
+		return uint64_t(1) << container_index<T>();
+	}
+
+	// Tests several components of e with one mask instead of one container lookup each, e.g.
+	//     registry.has_none<TutorialSign, TutorialTile>(e)
+	// The mask is kept per index, so e must be a live handle (as any entity taken from a container is).
+	template <typename... Ts>
+	bool has_all(Entity e) const {
+		constexpr uint64_t mask = (component_bit<Ts>() | ...);
+		return (components_of(e) & mask) == mask;
+	}
+	template <typename... Ts>
+	bool has_any(Entity e) const {
+		return (components_of(e) & (component_bit<Ts>() | ...)) != 0;
+	}
+	template <typename... Ts>
+	bool has_none(Entity e) const {
+		return !has_any<Ts...>(e);
 	}
 
 	void clear_all_components() {
-		for (ContainerInterface* reg : registry_list) {
-			if (!dynamic_cast<ComponentContainer<ScreenState>*>(reg))    //do not remove screenstate
-				reg->clear();
-		}
+		deferred.clear();
+		for_each_container([](auto &container, size_t) {
+			using Component = typename std::decay_t<decltype(container)>::component_type;
+			if constexpr (!std::is_same_v<Component, ScreenState>)    //do not remove screenstate
+				container.clear();
+		});
 	}
 
 	void list_all_components() {
 		printf("Debug info on all registry entries:\n");
-		for (ContainerInterface* reg : registry_list)
-			if (reg->size() > 0)
-				printf("%4d components of type %s\n", (int)reg->size(), typeid(*reg).name());
+		for_each_container([](auto &container, size_t i) {
+			if (container.size() > 0) {
+				ContainerStats stats = container.stats();
+				printf("%4d components in %s (capacity %d, %d bytes)\n", (int)stats.size, container_names[i], (int)stats.capacity,
+					   (int)(stats.payload_bytes + stats.index_bytes + stats.tracking_bytes));
+			}
+		});
 	}
 
 	void list_all_components_of(Entity e) {
 		printf("Debug info on components of entity %u:\n", (unsigned int)e);
-		for (ContainerInterface* reg : registry_list)
-			if (reg->has(e))
-				printf("type %s\n", typeid(*reg).name());
+		for_each_container([e](auto &container, size_t) {
+			using Component = typename std::decay_t<decltype(container)>::component_type;
+			if (container.has(e))
+				printf("type %s\n", typeid(Component).name());
+		});
 	}
 
 	void remove_all_components_of(Entity e) {
-		for (ContainerInterface* reg : registry_list)
-			reg->remove(e);
+		// only the containers e is actually in
+		uint64_t mask = components_of(e);
+		if (mask != 0)
+			remove_masked(e, mask, std::make_index_sequence<container_count>{});
+		// the entity is gone, its index can be handed out again under a new generation
+		entities.release(e);
+	}
+
+	// sync point: applies everything recorded in deferred
+	void flush_deferred() {
+		deferred.flush(entities, [this](Entity e) { remove_all_components_of(e); });
+	}
+
+	// Makes r the registry that registry() returns on the calling thread, and returns the one bound
+	// before (to restore it). A registry is only ever used by the threads it is bound to.
+	static ECSRegistry *bind(ECSRegistry *r) {
+		ECSRegistry *previous = bound;
+		bound = r;
+		return previous;
+	}
+
+private:
+	static inline thread_local ECSRegistry *bound = nullptr;
+	friend ECSRegistry &registry();
+
+	template <typename T, size_t I = 0>
+	static constexpr size_t container_index() {
+		static_assert(I < container_count, "T has no container in the registry");
+		if constexpr (std::is_same_v<std::tuple_element_t<I, std::remove_const_t<decltype(containers)>>, ComponentContainer<T> ECSRegistry::*>)
+			return I;
+		else
+			return container_index<T, I + 1>();
+	}
+
+	template <typename Func, size_t... Is>
+	void for_each_container(Func &func, std::index_sequence<Is...>) {
+		(func(this->*std::get<Is>(containers), Is), ...);
+	}
+
+	template <size_t... Is>
+	void remove_masked(Entity e, uint64_t mask, std::index_sequence<Is...>) {
+		((mask & (uint64_t(1) << Is) ? (this->*std::get<Is>(containers)).remove(e) : void()), ...);
 	}
 };
 
-extern ECSRegistry registry;
\ No newline at end of file
+// The registry bound to the calling thread (see ECSRegistry::bind), i.e. the one of the world it is
+// simulating. Each World binds its own, so several games can run in one process, one per thread.
+inline ECSRegistry &registry() {
+	assert(ECSRegistry::bound && "no registry bound to this thread");
+	return *ECSRegistry::bound;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+// internal
+#include "registry_monitor.hpp"
+
+#include <iostream>
+
+RegistryMonitor::RegistryMonitor(ECSRegistry &registry)
+	: registry(registry)
+{
+	latest.resize(ECSRegistry::container_count);
+	for (size_t i = 0; i < latest.size(); i++)
+		latest[i].name = ECSRegistry::container_names[i];
+}
+
+const std::vector<RegistryMonitor::ContainerReport> &RegistryMonitor::sample(double seconds)
+{
+	session_seconds += seconds;
+	registry.for_each_container([&](auto &container, size_t i) {
+		ContainerReport &report = latest[i];
+		ContainerStats stats = container.stats();
+		if (seconds > 0)
+		{
+			report.adds_per_second = (stats.total_added - report.stats.total_added) / seconds;
+			report.removes_per_second = (stats.total_removed - report.stats.total_removed) / seconds;
+		}
+		report.stats = stats;
+	});
+	return latest;
+}
+
+const RegistryMonitor::ContainerReport *RegistryMonitor::report(const std::string &name) const
+{
+	for (const ContainerReport &report : latest)
+	{
+		if (name == report.name)
+			return &report;
+	}
+	return nullptr;
+}
+
+size_t RegistryMonitor::total_bytes() const
+{
+	size_t bytes = 0;
+	for (const ContainerReport &report : latest)
+		bytes += report.stats.payload_bytes + report.stats.index_bytes + report.stats.tracking_bytes;
+	return bytes;
+}
+
+void RegistryMonitor::reset_peaks()
+{
+	registry.for_each_container([](auto &container, size_t) { container.reset_peak(); });
+}
+
+void RegistryMonitor::dump_to(const std::string &path_prefix, float interval_ms)
+{
+	dump_prefix = path_prefix;
+	dump_interval_ms = interval_ms;
+	since_dump_ms = 0;
+	csv.open(dump_prefix + ".csv", std::ios::trunc);
+	if (!csv)
+	{
+		std::cerr << "ERROR: cannot write registry stats to " << dump_prefix << ".csv" << std::endl;
+		dump_interval_ms = 0;
+		return;
+	}
+	write_csv_header(csv);
+}
+
+void RegistryMonitor::step(float elapsed_ms)
+{
+	if (dump_interval_ms <= 0)
+		return;
+	since_dump_ms += elapsed_ms;
+	if (since_dump_ms < dump_interval_ms)
+		return;
+	sample(since_dump_ms / 1000.0);
+	since_dump_ms = 0;
+	dump();
+}
+
+void RegistryMonitor::dump()
+{
+	write_csv_rows(csv);
+	csv.flush();
+	std::ofstream json_file(dump_prefix + ".json", std::ios::trunc);
+	write_json(json_file);
+}
+
+void RegistryMonitor::write_csv_header(std::ostream &out) const
+{
+	out << "seconds,container,size,capacity,peak_size,shadowed,payload_bytes,index_bytes,tracking_bytes,"
+		   "index_load_factor,total_added,total_removed,adds_per_second,removes_per_second\n";
+}
+
+void RegistryMonitor::write_csv_rows(std::ostream &out) const
+{
+	for (const ContainerReport &report : latest)
+	{
+		const ContainerStats &stats = report.stats;
+		out << session_seconds << ',' << report.name << ',' << stats.size << ',' << stats.capacity << ','
+			<< stats.peak_size << ',' << stats.shadowed << ',' << stats.payload_bytes << ',' << stats.index_bytes << ','
+			<< stats.tracking_bytes << ',' << stats.index_load_factor << ',' << stats.total_added << ','
+			<< stats.total_removed << ',' << report.adds_per_second << ',' << report.removes_per_second << '\n';
+	}
+}
+
+void RegistryMonitor::write_json(std::ostream &out) const
+{
+	json containers = json::array();
+	for (const ContainerReport &report : latest)
+	{
+		const ContainerStats &stats = report.stats;
+		containers.push_back(json{
+			{"container", report.name},
+			{"size", stats.size},
+			{"capacity", stats.capacity},
+			{"peak_size", stats.peak_size},
+			{"shadowed", stats.shadowed},
+			{"payload_bytes", stats.payload_bytes},
+			{"index_bytes", stats.index_bytes},
+			{"tracking_bytes", stats.tracking_bytes},
+			{"index_load_factor", stats.index_load_factor},
+			{"total_added", stats.total_added},
+			{"total_removed", stats.total_removed},
+			{"adds_per_second", report.adds_per_second},
+			{"removes_per_second", report.removes_per_second}});
+	}
+	out << json{{"seconds", session_seconds}, {"total_bytes", total_bytes()}, {"containers", containers}}.dump(2) << '\n';
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "registry.hpp"
+
+// Per-container memory and occupancy of a registry over time, to spot component types that keep
+// growing during long sessions. sample() takes a snapshot that can be queried with reports();
+// with dump_to() set, step() also samples periodically and writes every snapshot out:
+//   <prefix>.csv  one row per container and sample, appended (a time series over the session)
+//   <prefix>.json the latest snapshot, overwritten
+class RegistryMonitor
+{
+public:
+	struct ContainerReport
+	{
+		const char *name;
+		ContainerStats stats;
+		double adds_per_second = 0; // since the previous sample
+		double removes_per_second = 0;
+	};
+
+	explicit RegistryMonitor(ECSRegistry &registry);
+
+	// Takes a snapshot of every container; seconds is the time since the previous sample
+	const std::vector<ContainerReport> &sample(double seconds);
+	const std::vector<ContainerReport> &reports() const { return latest; }
+	const ContainerReport *report(const std::string &name) const;
+	size_t total_bytes() const;
+
+	// Restarts the peak_size of every container
+	void reset_peaks();
+
+	// Writes a sample to <path_prefix>.csv / .json every interval_ms of step() time
+	void dump_to(const std::string &path_prefix, float interval_ms);
+	void step(float elapsed_ms);
+
+	void write_csv_header(std::ostream &out) const;
+	void write_csv_rows(std::ostream &out) const;
+	void write_json(std::ostream &out) const;
+
+private:
+	ECSRegistry &registry;
+	std::vector<ContainerReport> latest;
+	double session_seconds = 0;
+
+	std::string dump_prefix;
+	float dump_interval_ms = 0;
+	float since_dump_ms = 0;
+	std::ofstream csv;
+
+	void dump();
+};
@@ -1,5 +1,9 @@
 // internal
 #include "tiny_ecs.hpp"
+#include "registry.hpp"
 
-// All we need to store besides the containers is the id of every entity and callbacks to be able to remove entities across containers
-unsigned int Entity::id_count = 1;
\ No newline at end of file
+// All we need to store besides the containers is the id of every entity, kept per registry by its EntityAllocator
+Entity::Entity()
+	: m_id(registry().entities.allocate().id())
+{
+}
@@ -13,28 +13,170 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "../ext/json.hpp"
 #include <type_traits>
+#include <memory>
+#include <cstdint>
 using json = nlohmann::json;
 
+// The sparse half of a sparse set: maps Entity::index() to a slot in a container's dense arrays.
+// Entity indices are split into a page number and an offset; pages are only allocated once an index
+// in their range is set, so lookups are two array reads instead of a hash and the index never
+// allocates per-entity nodes. Generations are not stored, the owner checks them against its entities.
+class SparseIndex
+{
+	static constexpr unsigned int PAGE_BITS = 10;
+	static constexpr unsigned int PAGE_SIZE = 1u << PAGE_BITS;
+	static constexpr unsigned int PAGE_MASK = PAGE_SIZE - 1;
+	std::vector<std::unique_ptr<unsigned int[]>> pages;
+
+public:
+	static constexpr unsigned int INVALID_SLOT = ~0u;
+
+	// Returns the slot stored for e's index, or INVALID_SLOT
+	inline unsigned int get(Entity e) const
+	{
+		unsigned int page = e.index() >> PAGE_BITS;
+		if (page >= pages.size() || !pages[page])
+			return INVALID_SLOT;
+		return pages[page][e.index() & PAGE_MASK];
+	}
+
+	// Points e's index at slot, allocating its page on first use
+	inline void set(Entity e, unsigned int slot)
+	{
+		unsigned int page = e.index() >> PAGE_BITS;
+		if (page >= pages.size())
+			pages.resize(page + 1);
+		if (!pages[page])
+		{
+			pages[page].reset(new unsigned int[PAGE_SIZE]);
+			std::fill_n(pages[page].get(), PAGE_SIZE, INVALID_SLOT);
+		}
+		pages[page][e.index() & PAGE_MASK] = slot;
+	}
+
+	inline void clear(Entity e)
+	{
+		unsigned int page = e.index() >> PAGE_BITS;
+		if (page < pages.size() && pages[page])
+			pages[page][e.index() & PAGE_MASK] = INVALID_SLOT;
+	}
+
+	// number of index slots in the allocated pages
+	size_t slot_capacity() const
+	{
+		size_t allocated = 0;
+		for (const auto &page : pages)
+			allocated += page != nullptr;
+		return allocated * PAGE_SIZE;
+	}
+
+	size_t bytes() const
+	{
+		return pages.capacity() * sizeof(pages[0]) + slot_capacity() * sizeof(unsigned int);
+	}
+};
 
-// Common interface to refer to all containers in the ECS registry
-struct ContainerInterface
+
+// Memory use and occupancy of one container, see ComponentContainer::stats()
+struct ContainerStats
 {
-	virtual void clear() = 0;
-	virtual size_t size() = 0;
-	virtual void remove(Entity e) = 0;
-	virtual bool has(Entity entity) = 0;
-	virtual json toJSON() = 0;
+	size_t size = 0;
+	size_t capacity = 0;		 // entries the dense arrays hold before they reallocate
+	size_t peak_size = 0;		 // largest size since the last reset_peak()
+	size_t shadowed = 0;		 // older duplicates left by emplace_with_duplicates
+	size_t payload_bytes = 0;	 // the component array (0 for tags), without heap memory owned by the components
+	size_t index_bytes = 0;		 // the entity array and the sparse index pages
+	size_t tracking_bytes = 0;	 // change-tracking versions
+	float index_load_factor = 0; // size / slots of the allocated sparse index pages
+	uint64_t total_added = 0;	 // over the lifetime of the container
+	uint64_t total_removed = 0;
 };
 
-// A container that stores components of type 'Component' and associated entities
-template <typename Component> // A component can be any class
-class ComponentContainer : public ContainerInterface
+
+// A container that stores components of type 'Component' and associated entities.
+// Containers are not polymorphic; the registry reaches all of them through its compile-time list of component types.
+// Empty component types (tags such as MapTile or MoveWithCamera) get the payload-free specialization below.
+template <typename Component, bool IsTag = std::is_empty<Component>::value> // A component can be any class
+class ComponentContainer
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
-	bool registered = false;
+	// The sparse index from Entity -> array index
+	static constexpr unsigned int INVALID_SLOT = SparseIndex::INVALID_SLOT;
+	SparseIndex sparse;
+	// per-entity component bitmask owned by the registry (indexed by Entity::index()), in which this
+	// container keeps its own bit up to date; nullptr for containers outside a registry
+	std::vector<uint64_t> *membership = nullptr;
+	uint64_t membership_bit = 0;
+
+	// Change tracking, off unless the registry enables it with track_changes(). Ticks come from the
+	// registry clock: versions[i] is the tick at which components[i] was last added, or last written
+	// through modify() / mark_changed().
+	const uint32_t *change_clock = nullptr;
+	std::vector<uint32_t> versions;
+	uint32_t last_added = 0;
+	uint32_t last_removed = 0;
+	uint32_t last_modified = 0;
+	// number of entries added by emplace_with_duplicates on top of an existing one; the index only
+	// points at the newest, the older copies are dropped together with it in remove()
+	size_t shadowed = 0;
+
+	// counters for stats()
+	size_t peak_size = 0;
+	uint64_t total_added = 0;
+	uint64_t total_removed = 0;
+
+	// Returns the array index of entity e, or INVALID_SLOT if it has no component
+	inline unsigned int slot_of(Entity e) const
+	{
+		unsigned int slot = sparse.get(e);
+		// a stale handle (recycled index, older generation) does not own the slot
+		if (slot == INVALID_SLOT || entities[slot].id() != e.id())
+			return INVALID_SLOT;
+		return slot;
+	}
+
+	// Packs the container by moving the last element into slot, leaving the index of the erased entity untouched
+	void erase_at(unsigned int slot)
+	{
+		unsigned int last = (unsigned int)entities.size() - 1;
+		// a shadowed duplicate at the back must not take over the index of its entity
+		bool last_indexed = slot_of(entities[last]) == last;
+		// Move the last element to position slot using the move operator
+		// Note, components[slot] = components.back() would trigger the copy instead of move operator
+		components[slot] = std::move(components.back());
+		entities[slot] = entities.back(); // the entity is only a single index, copy it.
+		if (last_indexed)
+			sparse.set(entities[slot], slot);
+
+		// Erase the old component and free its memory
+		components.pop_back();
+		entities.pop_back();
+		total_removed++;
+
+		if (change_clock)
+		{
+			// the moved component keeps its version, its value did not change
+			versions[slot] = versions[last];
+			versions.pop_back();
+			last_removed = *change_clock;
+		}
+	}
+
+	// Erases the older copies of e left by emplace_with_duplicates, once the indexed one is gone
+	void remove_shadowed(Entity e)
+	{
+		for (unsigned int i = (unsigned int)entities.size(); i-- > 0;)
+		{
+			if (entities[i].id() == e.id())
+			{
+				erase_at(i);
+				shadowed--;
+			}
+		}
+	}
 public:
+	using component_type = Component;
+
 	// Container of all components of type 'Component'
 	std::vector<Component> components;
 
@@ -46,6 +188,75 @@ public:
 	{
 	}
 
+	// Called by the registry, see membership
+	void track_membership(std::vector<uint64_t> *mask, uint64_t bit)
+	{
+		membership = mask;
+		membership_bit = bit;
+	}
+
+	// Enables change tracking, stamping changes with the current value of *clock. Writes through
+	// get(), try_get() or components[] are not seen; writers that matter to a consumer go through
+	// modify() or call mark_changed()
+	void track_changes(const uint32_t *clock)
+	{
+		change_clock = clock;
+		versions.assign(components.size(), *clock);
+		last_added = last_modified = *clock;
+	}
+	bool tracks_changes() const { return change_clock != nullptr; }
+
+	// Stamps the component of e as modified now
+	void mark_changed(Entity e)
+	{
+		unsigned int slot = slot_of(e);
+		if (slot != INVALID_SLOT)
+			mark_changed_at(slot);
+	}
+	// Stamps components[slot] as modified now, for loops over the dense array
+	void mark_changed_at(size_t slot)
+	{
+		if (change_clock)
+		{
+			versions[slot] = *change_clock;
+			last_modified = *change_clock;
+		}
+	}
+
+	// get() for writing: the component of e, stamped as modified now
+	Component& modify(Entity e) {
+		Component &component = get(e);
+		mark_changed(e);
+		return component;
+	}
+
+	// True if a component was added, removed or modified at or after tick.
+	// Containers that do not track changes always report a change.
+	bool changed_since(uint32_t tick) const
+	{
+		return !change_clock || last_added >= tick || last_removed >= tick || last_modified >= tick;
+	}
+	// True if e's component was added or modified at or after tick (false if e has none)
+	bool changed_since(Entity e, uint32_t tick) const
+	{
+		unsigned int slot = slot_of(e);
+		return slot != INVALID_SLOT && (!change_clock || versions[slot] >= tick);
+	}
+	// Only additions / only removals, e.g. to know that slot order changed
+	bool added_since(uint32_t tick) const { return !change_clock || last_added >= tick; }
+	bool removed_since(uint32_t tick) const { return !change_clock || last_removed >= tick; }
+
+	// Calls func(entity, component) for every component added or modified at or after tick
+	template <typename Func>
+	void each_changed_since(uint32_t tick, Func &&func)
+	{
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			if (!change_clock || versions[i] >= tick)
+				func(entities[i], components[i]);
+		}
+	}
+
 	json toJSON() {
 		
 		json jsonData;
@@ -72,9 +283,24 @@ public:
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		if (!check_for_duplicates && has(e))
+			shadowed++;
+		if (membership)
+		{
+			if (e.index() >= membership->size())
+				membership->resize(e.index() + 1, 0);
+			(*membership)[e.index()] |= membership_bit;
+		}
+		sparse.set(e, (unsigned int)components.size());
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 		entities.push_back(e);
+		total_added++;
+		peak_size = std::max(peak_size, components.size());
+		if (change_clock)
+		{
+			versions.push_back(*change_clock);
+			last_added = *change_clock;
+		}
 		return components.back();
 	};
 
@@ -90,10 +316,11 @@ public:
 
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
-		if (!has(e)) {
+		unsigned int slot = slot_of(e);
+		if (slot == INVALID_SLOT) {
 			// Print debug info about the entity that's causing problems
 			std::cerr << "ERROR: Entity not found in registry!" << std::endl;
-			std::cerr << "  Entity ID: " << e.id() << std::endl;
+			std::cerr << "  Entity ID: " << e.id() << " (index " << e.index() << ", generation " << e.generation() << ")" << std::endl;
 			std::cerr << "  Container type: " << typeid(Component).name() << std::endl;
 			std::cerr << "  Registry has " << components.size() << " components" << std::endl;
 			
@@ -106,8 +333,15 @@ public:
 			
 			// Now trigger the assertion
 			assert(false && "Entity not contained in ECS registry");
+			slot = 0;
 		}
-		return components[map_entity_componentID[e]];
+		return components[slot];
+	}
+
+	// Returns the component of an entity, or nullptr if it has none (one lookup instead of has() + get())
+	Component* try_get(Entity e) {
+		unsigned int slot = slot_of(e);
+		return slot == INVALID_SLOT ? nullptr : &components[slot];
 	}
 
 	Component& getByIndex(int i) {
@@ -116,42 +350,52 @@ public:
 	}
 
 	int getEntityId(Entity e) {
-		return map_entity_componentID[e];
+		unsigned int slot = slot_of(e);
+		return slot == INVALID_SLOT ? 0 : (int)slot;
 	}
 
 	// Check if entity has a component of type 'Component'
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		return slot_of(entity) != INVALID_SLOT;
+	}
+
+	// False for the older copies left by emplace_with_duplicates, which the index no longer points at
+	bool is_indexed(size_t i) const {
+		return sparse.get(entities[i]) == i;
 	}
 
 	// Remove an component and pack the container to re-use the empty space
 	void remove(Entity e)
 	{
-		if (has(e))
+		unsigned int cID = slot_of(e);
+		if (cID != INVALID_SLOT)
 		{
-			// Get the current position
-			int cID = map_entity_componentID[e];
-
-			// Move the last element to position cID using the move operator
-			// Note, components[cID] = components.back() would trigger the copy instead of move operator
-			components[cID] = std::move(components.back());
-			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
-
-			// Erase the old component and free its memory
-			map_entity_componentID.erase(e);
-			components.pop_back();
-			entities.pop_back();
-			// Note, one could mark the id for re-use
+			erase_at(cID);
+			sparse.clear(e);
+			if (shadowed > 0)
+				remove_shadowed(e);
+			if (membership)
+				(*membership)[e.index()] &= ~membership_bit;
 		}
 	};
 
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		// only touch the pages that are in use, they stay allocated for the next round
+		for (Entity e : entities)
+		{
+			sparse.clear(e);
+			if (membership)
+				(*membership)[e.index()] &= ~membership_bit;
+		}
+		if (change_clock && !components.empty())
+			last_removed = *change_clock;
+		total_removed += components.size();
 		components.clear();
 		entities.clear();
+		versions.clear();
+		shadowed = 0;
 	}
 
 	// Report the number of components of type 'Component'
@@ -160,18 +404,253 @@ public:
 		return components.size();
 	}
 
+	ContainerStats stats() const
+	{
+		ContainerStats stats;
+		stats.size = components.size();
+		stats.capacity = components.capacity();
+		stats.peak_size = peak_size;
+		stats.shadowed = shadowed;
+		stats.payload_bytes = components.capacity() * sizeof(Component);
+		stats.index_bytes = entities.capacity() * sizeof(Entity) + sparse.bytes();
+		stats.tracking_bytes = versions.capacity() * sizeof(uint32_t);
+		size_t slots = sparse.slot_capacity();
+		stats.index_load_factor = slots == 0 ? 0.f : (float)components.size() / (float)slots;
+		stats.total_added = total_added;
+		stats.total_removed = total_removed;
+		return stats;
+	}
+
+	// Starts a new peak_size measurement from the current size
+	void reset_peak() { peak_size = components.size(); }
+
 	// Sort the components and associated entity assignment structures by the comparisonFunction, see std::sort
 	template <class Compare>
 	void sort(Compare comparisonFunction)
 	{
-		// First sort the entity list as desired
-		std::sort(entities.begin(), entities.end(), comparisonFunction);
-		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
+		// First sort the old slots by their entities as desired; the slots keep each entity with its
+		// own component, including the older copies left by emplace_with_duplicates
+		std::vector<unsigned int> old_slots(entities.size());
+		for (unsigned int i = 0; i < old_slots.size(); i++)
+			old_slots[i] = i;
+		std::stable_sort(old_slots.begin(), old_slots.end(), [&](unsigned int a, unsigned int b) { return comparisonFunction(entities[a], entities[b]); });
+		// Now re-arrange the entities and components (Note, creates new vectors, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
+		std::vector<Entity> entities_new; entities_new.reserve(entities.size());
 		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
-		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-		// Fill the new hashmap
+		std::vector<bool> indexed(entities.size());
+		for (unsigned int slot : old_slots)
+		{
+			entities_new.push_back(entities[slot]);
+			components_new.push_back(std::move(components[slot])); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
+			indexed[entities_new.size() - 1] = slot_of(entities[slot]) == slot;
+		}
+		entities = std::move(entities_new);
+		components = std::move(components_new);
+		// Fill the new sparse index, pointing every entity at the copy it pointed at before
+		for (unsigned int i = 0; i < entities.size(); i++)
+		{
+			if (indexed[i])
+				sparse.set(entities[i], i);
+		}
+		// versions are per slot, they move with their components
+		if (change_clock)
+		{
+			std::vector<uint32_t> versions_new; versions_new.reserve(versions.size());
+			for (unsigned int slot : old_slots)
+				versions_new.push_back(versions[slot]);
+			versions = std::move(versions_new);
+		}
+	}
+};
+
+
+// Storage for tag components, empty types that only mark an entity (MapTile, MoveWithCamera, Zombie, ...).
+// There is no per-entity payload: the container is the dense entity list plus the sparse index, and
+// every entity shares one instance of the (stateless) tag, which is what get() and emplace() return.
+// The interface matches the generic container, so tags work in views, the command buffer and saves.
+// To test several tags of one entity at once use registry.has_all / has_any / has_none, which read
+// the registry's per-entity bitmask instead of probing each container.
+template <typename Component>
+class ComponentContainer<Component, true>
+{
+private:
+	static constexpr unsigned int INVALID_SLOT = SparseIndex::INVALID_SLOT;
+	SparseIndex sparse;
+	// see the generic container
+	std::vector<uint64_t> *membership = nullptr;
+	uint64_t membership_bit = 0;
+	// a tag never changes value, removals are the only changes besides additions
+	const uint32_t *change_clock = nullptr;
+	uint32_t last_added = 0;
+	uint32_t last_removed = 0;
+	size_t peak_size = 0;
+	uint64_t total_added = 0;
+	uint64_t total_removed = 0;
+
+	static inline Component instance{};
+
+	inline unsigned int slot_of(Entity e) const
+	{
+		unsigned int slot = sparse.get(e);
+		if (slot == INVALID_SLOT || entities[slot].id() != e.id())
+			return INVALID_SLOT;
+		return slot;
+	}
+
+public:
+	using component_type = Component;
+
+	// The tagged entities
+	std::vector<Entity> entities;
+
+	void track_membership(std::vector<uint64_t> *mask, uint64_t bit)
+	{
+		membership = mask;
+		membership_bit = bit;
+	}
+
+	void track_changes(const uint32_t *clock)
+	{
+		change_clock = clock;
+		last_added = *clock;
+	}
+	bool tracks_changes() const { return change_clock != nullptr; }
+	void mark_changed(Entity) {}
+	void mark_changed_at(size_t) {}
+	bool changed_since(uint32_t tick) const { return !change_clock || last_added >= tick || last_removed >= tick; }
+	bool changed_since(Entity e, uint32_t tick) const { return has(e) && (!change_clock || last_added >= tick); }
+	bool added_since(uint32_t tick) const { return !change_clock || last_added >= tick; }
+	bool removed_since(uint32_t tick) const { return !change_clock || last_removed >= tick; }
+
+	json toJSON() {
+		json jsonData;
+		for (Entity e : entities) {
+			json temp = instance.toJSON();
+			temp["entity"] = e.id();
+			jsonData.push_back(temp);
+		}
+		return jsonData;
+	}
+
+	// Tags an entity. An entity is tagged at most once, inserting it again (with duplicates allowed) does nothing.
+	inline Component& insert(Entity e, Component = {}, bool check_for_duplicates = true)
+	{
+		bool tagged = has(e);
+		assert(!(check_for_duplicates && tagged) && "Entity already contained in ECS registry");
+		if (tagged)
+			return instance;
+		if (membership)
+		{
+			if (e.index() >= membership->size())
+				membership->resize(e.index() + 1, 0);
+			(*membership)[e.index()] |= membership_bit;
+		}
+		sparse.set(e, (unsigned int)entities.size());
+		entities.push_back(e);
+		total_added++;
+		peak_size = std::max(peak_size, entities.size());
+		if (change_clock)
+			last_added = *change_clock;
+		return instance;
+	}
+
+	template<typename... Args>
+	Component& emplace(Entity e, Args &&...) {
+		return insert(e);
+	}
+	template<typename... Args>
+	Component& emplace_with_duplicates(Entity e, Args &&...) {
+		return insert(e, {}, false);
+	}
+
+	Component& get(Entity e) {
+		assert(has(e) && "Entity not contained in ECS registry");
+		(void)e;
+		return instance;
+	}
+
+	Component* try_get(Entity e) {
+		return has(e) ? &instance : nullptr;
+	}
+
+	Component& modify(Entity e) {
+		return get(e);
+	}
+
+	Component& getByIndex(int i) {
+		assert(i < entities.size() && "Entity not contained in ECS registry");
+		(void)i;
+		return instance;
+	}
+
+	int getEntityId(Entity e) {
+		unsigned int slot = slot_of(e);
+		return slot == INVALID_SLOT ? 0 : (int)slot;
+	}
+
+	bool has(Entity entity) const {
+		return slot_of(entity) != INVALID_SLOT;
+	}
+
+	// a tag is never duplicated
+	bool is_indexed(size_t) const { return true; }
+
+	void remove(Entity e)
+	{
+		unsigned int slot = slot_of(e);
+		if (slot == INVALID_SLOT)
+			return;
+		entities[slot] = entities.back();
+		sparse.set(entities[slot], slot);
+		entities.pop_back();
+		sparse.clear(e);
+		total_removed++;
+		if (membership)
+			(*membership)[e.index()] &= ~membership_bit;
+		if (change_clock)
+			last_removed = *change_clock;
+	}
+
+	void clear()
+	{
+		for (Entity e : entities)
+		{
+			sparse.clear(e);
+			if (membership)
+				(*membership)[e.index()] &= ~membership_bit;
+		}
+		if (change_clock && !entities.empty())
+			last_removed = *change_clock;
+		total_removed += entities.size();
+		entities.clear();
+	}
+
+	size_t size()
+	{
+		return entities.size();
+	}
+
+	ContainerStats stats() const
+	{
+		ContainerStats stats;
+		stats.size = entities.size();
+		stats.capacity = entities.capacity();
+		stats.peak_size = peak_size;
+		stats.index_bytes = entities.capacity() * sizeof(Entity) + sparse.bytes();
+		size_t slots = sparse.slot_capacity();
+		stats.index_load_factor = slots == 0 ? 0.f : (float)entities.size() / (float)slots;
+		stats.total_added = total_added;
+		stats.total_removed = total_removed;
+		return stats;
+	}
+
+	void reset_peak() { peak_size = entities.size(); }
+
+	template <class Compare>
+	void sort(Compare comparisonFunction)
+	{
+		std::sort(entities.begin(), entities.end(), comparisonFunction);
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			sparse.set(entities[i], i);
 	}
 };
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+#include "tiny_ecs.hpp"
+
+// Tag listing component types an entity must NOT have to be visited by a view, e.g.
+//     registry.view<Motion, RenderRequest>(exclude<MoveWithCamera>)
+template <typename... Excluded>
+struct exclude_t
+{
+};
+template <typename... Excluded>
+inline constexpr exclude_t<Excluded...> exclude{};
+
+// A join over several component containers. Iteration is driven by the smallest included
+// container (or the one picked with use<T>()), and every other container is probed once per
+// candidate entity, so
+//     registry.view<Enemy, Motion>().each([](Entity e, Enemy& enemy, Motion& motion) { ... });
+// replaces the usual loop over registry.enemies with registry.motions.has(e) / get(e) inside.
+//
+// The callback may return void, or bool where false stops the iteration early. Structural changes
+// should go through registry.deferred; if the callback does change the containers directly, entities
+// added during the pass are not visited and removing the visited entity skips the one swapped into its slot.
+template <typename Included, typename Excluded>
+class View;
+
+template <typename... Included, typename... Excluded>
+class View<std::tuple<Included...>, std::tuple<Excluded...>>
+{
+	static_assert(sizeof...(Included) > 0, "A view needs at least one component type");
+
+	std::tuple<ComponentContainer<Included> *...> included;
+	std::tuple<ComponentContainer<Excluded> *...> excluded;
+	int lead = -1; // index into included of the driving container, -1 picks the smallest
+
+public:
+	View(ComponentContainer<Included> &...inc, ComponentContainer<Excluded> &...exc)
+		: included(&inc...), excluded(&exc...)
+	{
+	}
+
+	// Drive the iteration from the container of Lead, e.g. to keep the draw order of renderRequests
+	template <typename Lead>
+	View &use()
+	{
+		lead = index_of<Lead, Included...>();
+		return *this;
+	}
+
+	// True if e has all included and none of the excluded components
+	bool contains(Entity e)
+	{
+		return (std::get<ComponentContainer<Included> *>(included)->has(e) && ...) && !excluded_has(e);
+	}
+
+	// Upper bound on the number of visited entities
+	size_t size_hint()
+	{
+		size_t smallest = ~(size_t)0;
+		((smallest = std::min(smallest, std::get<ComponentContainer<Included> *>(included)->size())), ...);
+		return smallest;
+	}
+
+	template <typename Func>
+	void each(Func &&func)
+	{
+		int chosen = lead;
+		if (chosen < 0)
+		{
+			size_t smallest = size_hint();
+			int i = 0;
+			((chosen < 0 && std::get<ComponentContainer<Included> *>(included)->size() == smallest ? chosen = i : 0, i++), ...);
+		}
+		int i = 0;
+		((i++ == chosen ? (iterate(*std::get<ComponentContainer<Included> *>(included), func), 0) : 0), ...);
+	}
+
+private:
+	template <typename T, typename First, typename... Rest>
+	static constexpr int index_of()
+	{
+		if constexpr (std::is_same_v<T, First>)
+			return 0;
+		else
+		{
+			static_assert(sizeof...(Rest) > 0, "use<T>() needs T to be one of the included components");
+			return 1 + index_of<T, Rest...>();
+		}
+	}
+
+	bool excluded_has(Entity e)
+	{
+		return (std::get<ComponentContainer<Excluded> *>(excluded)->has(e) || ...);
+	}
+
+	// The component of type C of e, the entity in slot i of driver; the driver's own needs no lookup
+	template <typename C, typename Lead>
+	C *probe(ComponentContainer<Lead> &driver, size_t i, Entity e)
+	{
+		if constexpr (std::is_same_v<C, Lead> && !std::is_empty_v<C>)
+			return &driver.components[i];
+		else
+			return std::get<ComponentContainer<C> *>(included)->try_get(e);
+	}
+
+	template <typename Lead, typename Func>
+	void iterate(ComponentContainer<Lead> &driver, Func &func)
+	{
+		size_t count = driver.entities.size();
+		for (size_t i = 0; i < count && i < driver.entities.size(); i++)
+		{
+			Entity e = driver.entities[i];
+			// entries added with emplace_with_duplicates are visited once, through the slot the index points at
+			if (!driver.is_indexed(i))
+				continue;
+			if constexpr (sizeof...(Excluded) > 0)
+			{
+				if (excluded_has(e))
+					continue;
+			}
+			std::tuple<Included *...> found(probe<Included>(driver, i, e)...);
+			if (((std::get<Included *>(found) == nullptr) || ...))
+				continue;
+			if constexpr (std::is_same_v<decltype(func(e, *std::get<Included *>(found)...)), bool>)
+			{
+				if (!func(e, *std::get<Included *>(found)...))
+					return;
+			}
+			else
+			{
+				func(e, *std::get<Included *>(found)...);
+			}
+		}
+	}
+};
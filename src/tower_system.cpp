@@ -2,6 +2,7 @@
 #include "tower_system.hpp"
 #include "animation_system.hpp"
 #include "particle_system.hpp"
+#include "world.hpp"
 #include <iostream>
 #include <algorithm>
 
@@ -15,18 +16,20 @@ TowerSystem::~TowerSystem()
 
 void TowerSystem::step(float elapsed_ms)
 {
-    for (int i = 0; i < registry.towers.entities.size(); i++)
+    for (int i = 0; i < registry().towers.entities.size(); i++)
     {
-        Tower &tower = registry.towers.components[i];
-        Entity entity = registry.towers.entities[i];
-        PlantAnimation &plant_anim = registry.plantAnimations.get(entity);
+        Tower &tower = registry().towers.components[i];
+        Entity entity = registry().towers.entities[i];
+        PlantAnimation &plant_anim = registry().plantAnimations.get(entity);
+        // the countdown runs every step, only a change of state counts as a change of the tower
+        bool was_attacking = tower.state;
         tower.timer_ms -= elapsed_ms;
         switch (tower.type)
         {
         case PLANT_TYPE::PROJECTILE:
             if (!tower.state)
             {
-                Entity target;
+                Entity target = Entity::null();
                 if (find_nearest_enemy(entity, target))
                 {
                     tower.state = true;
@@ -35,9 +38,9 @@ void TowerSystem::step(float elapsed_ms)
             }
             else
             {
-                if (!registry.animations.has(entity))
+                if (!registry().animations.has(entity))
                 {
-                    Entity target;
+                    Entity target = Entity::null();
                     if (find_nearest_enemy(entity, target))
                         fire_projectile(entity, target);
                     tower.state = false;
@@ -48,7 +51,7 @@ void TowerSystem::step(float elapsed_ms)
         case PLANT_TYPE::HEAL:
             if (!tower.state)
             {
-                Entity player = registry.players.entities[0];
+                Entity player = registry().players.entities[0];
                 if (compute_delta_distance(entity, player) < tower.range)
                 {
                     tower.state = true;
@@ -59,12 +62,12 @@ void TowerSystem::step(float elapsed_ms)
             {
                 if (tower.timer_ms <= 0)
                 {
-                    Entity player = registry.players.entities[0];
+                    Entity player = registry().players.entities[0];
                     if (compute_delta_distance(entity, player) < tower.range)
                     {
-                        Player &player_component = registry.players.components[0];
+                        Player &player_component = registry().players.components[0];
                         player_component.health = std::min(player_component.health_max, player_component.health + tower.damage);
-                        Motion &player_motion = registry.motions.get(player);
+                        Motion &player_motion = registry().motions.get(player);
                         ParticleSystem::createAOEEffect(player_motion.position, player_motion.scale, PLANT_STATS_MAP.at(plant_anim.id).cooldown, player, "heal");
                     }
                     else
@@ -81,9 +84,9 @@ void TowerSystem::step(float elapsed_ms)
         {
             if (!tower.state)
             {
-                for (uint i = 0; i < registry.enemies.size(); i++)
+                find_enemies_in_range(entity, tower.range);
+                for (Entity enemy : nearby)
                 {
-                    Entity enemy = registry.enemies.entities[i];
                     if (compute_delta_distance(entity, enemy) < tower.range)
                     {
                         tower.state = true;
@@ -97,24 +100,25 @@ void TowerSystem::step(float elapsed_ms)
                 if (tower.timer_ms <= 0)
                 {
                     bool enemy_detected = false;
-                    for (uint i = 0; i < registry.enemies.size(); i++)
+                    find_enemies_in_range(entity, tower.range);
+                    for (Entity enemy : nearby)
                     {
-                        Entity enemy = registry.enemies.entities[i];
                         if (compute_delta_distance(entity, enemy) < tower.range)
                         {
                             enemy_detected = true;
-                            Enemy &enemy_component = registry.enemies.components[i];
-                            Motion &enemy_motion = registry.motions.get(enemy);
+                            Enemy &enemy_component = registry().enemies.get(enemy);
+                            Motion &enemy_motion = registry().motions.get(enemy);
                             if (tower.type == PLANT_TYPE::POISON)
                             {
                                 enemy_component.health -= tower.damage;
+                                world().stats.add_damage(plant_anim.id, tower.damage);
                                 ParticleSystem::createAOEEffect(enemy_motion.position, enemy_motion.scale, PLANT_STATS_MAP.at(plant_anim.id).cooldown, enemy, "poison");
                             }
                             else if (tower.type == PLANT_TYPE::SLOW)
                             {
-                                if (!registry.slowEffects.has(enemy))
-                                    registry.slowEffects.emplace(enemy);
-                                Slow &slow = registry.slowEffects.get(enemy);
+                                if (!registry().slowEffects.has(enemy))
+                                    registry().slowEffects.emplace(enemy);
+                                Slow &slow = registry().slowEffects.get(enemy);
                                 slow.value = 1.0f - tower.damage / 100.0f;
                                 slow.timer_ms = PLANT_STATS_MAP.at(plant_anim.id).cooldown + 100;
                                 ParticleSystem::createAOEEffect(enemy_motion.position, enemy_motion.scale, PLANT_STATS_MAP.at(plant_anim.id).cooldown, enemy, "slow");
@@ -138,13 +142,13 @@ void TowerSystem::step(float elapsed_ms)
             {
                 // Find other electricity towers within range
                 std::vector<Entity> nearby_electricity_towers;
-                for (int j = 0; j < registry.towers.entities.size(); j++)
+                for (int j = 0; j < registry().towers.entities.size(); j++)
                 {
                     if (i == j)
                         continue; // Skip self
 
-                    Entity other_tower = registry.towers.entities[j];
-                    Tower &other_tower_comp = registry.towers.components[j];
+                    Entity other_tower = registry().towers.entities[j];
+                    Tower &other_tower_comp = registry().towers.components[j];
 
                     // Check if it's an electricity tower
                     if (other_tower_comp.type == PLANT_TYPE::ELECTRICITY)
@@ -173,17 +177,17 @@ void TowerSystem::step(float elapsed_ms)
             else // In attack state
             {
                 // If animation is complete (no animation component means it finished)
-                if (!registry.animations.has(entity))
+                if (!registry().animations.has(entity))
                 {
                     // Find nearby electricity towers again
                     std::vector<Entity> nearby_electricity_towers;
-                    for (int j = 0; j < registry.towers.entities.size(); j++)
+                    for (int j = 0; j < registry().towers.entities.size(); j++)
                     {
                         if (i == j)
                             continue;
 
-                        Entity other_tower = registry.towers.entities[j];
-                        Tower &other_tower_comp = registry.towers.components[j];
+                        Entity other_tower = registry().towers.entities[j];
+                        Tower &other_tower_comp = registry().towers.components[j];
 
                         if (other_tower_comp.type == PLANT_TYPE::ELECTRICITY &&
                             compute_delta_distance(entity, other_tower) < tower.range)
@@ -213,31 +217,33 @@ void TowerSystem::step(float elapsed_ms)
             break;
         }
         }
+        if (registry().towers.components[i].state != was_attacking)
+            registry().towers.mark_changed_at(i);
     }
 }
 
 void TowerSystem::fire_projectile(Entity tower, Entity target)
 {
-    if (!registry.towers.has(tower) || !registry.motions.has(tower) ||
-        !registry.motions.has(target))
+    if (!registry().towers.has(tower) || !registry().motions.has(tower) ||
+        !registry().motions.has(target))
     {
         return;
     }
 
-    Tower &tower_comp = registry.towers.get(tower);
-    Motion &tower_motion = registry.motions.get(tower);
-    Motion &target_motion = registry.motions.get(target);
+    Tower &tower_comp = registry().towers.get(tower);
+    Motion &tower_motion = registry().motions.get(tower);
+    Motion &target_motion = registry().motions.get(target);
 
     // Create projectile
     Entity projectile = Entity();
 
     // Add components
-    Projectile &proj = registry.projectiles.emplace(projectile);
+    Projectile &proj = registry().projectiles.emplace(projectile);
     proj.source = tower;
     proj.damage = tower_comp.damage;
     proj.speed = PROJECTILE_SPEED;
 
-    Motion &proj_motion = registry.motions.emplace(projectile);
+    Motion &proj_motion = registry().motions.emplace(projectile);
     proj_motion.position = tower_motion.position;
     proj_motion.scale = vec2(10, 10);
 
@@ -250,8 +256,8 @@ void TowerSystem::fire_projectile(Entity tower, Entity target)
 
     proj_motion.velocity = direction * proj.speed;
 
-    PlantAnimation &plant_anim = registry.plantAnimations.get(tower);
-    registry.renderRequests.insert(
+    PlantAnimation &plant_anim = registry().plantAnimations.get(tower);
+    registry().renderRequests.insert(
         projectile,
         {PLANT_PROJECTILE_MAP.at(plant_anim.id),
          EFFECT_ASSET_ID::TEXTURED,
@@ -260,57 +266,67 @@ void TowerSystem::fire_projectile(Entity tower, Entity target)
 
 float TowerSystem::compute_delta_distance(Entity tower, Entity target)
 {
-    Motion &motion_tower = registry.motions.get(tower);
-    Motion &motion_target = registry.motions.get(target);
+    Motion &motion_tower = registry().motions.get(tower);
+    Motion &motion_target = registry().motions.get(target);
     return std::sqrt(std::pow(motion_tower.position.x - motion_target.position.x, 2) + std::pow(motion_tower.position.y - motion_target.position.y, 2));
 }
 
 bool TowerSystem::find_nearest_enemy(Entity entity, Entity &target)
 {
-    if (registry.towers.has(entity) && registry.motions.has(entity))
+    if (registry().towers.has(entity) && registry().motions.has(entity))
     {
-        Tower &tower = registry.towers.get(entity);
-        Motion &motion = registry.motions.get(entity);
+        Tower &tower = registry().towers.get(entity);
+        Motion &motion = registry().motions.get(entity);
 
         float min_dist = tower.range;
+        bool found = false;
 
-        for (Entity enemy : registry.enemies.entities)
+        // first enemy in range, in the order of registry().enemies
+        find_enemies_in_range(entity, tower.range);
+        for (Entity enemy : nearby)
         {
-            if (!registry.motions.has(enemy))
-            {
+            Motion *enemy_motion = registry().motions.try_get(enemy);
+            if (!enemy_motion)
                 continue;
-            }
-
-            Motion &enemy_motion = registry.motions.get(enemy);
-            vec2 diff = enemy_motion.position - motion.position;
+            vec2 diff = enemy_motion->position - motion.position;
             float dist = sqrt(dot(diff, diff));
 
             if (dist < min_dist)
             {
                 min_dist = dist;
                 target = enemy;
-                return true;
+                found = true;
+                break;
             }
         }
+        return found;
     }
 
     return false;
 }
 
+void TowerSystem::find_enemies_in_range(Entity tower, float range)
+{
+    nearby.clear();
+    world().enemy_grid.query_radius(registry().motions.get(tower).position, range, nearby);
+    order_like(registry().enemies, nearby, nearby_order);
+}
+
 void TowerSystem::create_electricity_effect(Entity tower1, Entity tower2)
 {
-    if (!registry.motions.has(tower1) || !registry.motions.has(tower2))
+    if (!registry().motions.has(tower1) || !registry().motions.has(tower2))
         return;
 
     // Get tower positions
-    Motion &motion1 = registry.motions.get(tower1);
-    Motion &motion2 = registry.motions.get(tower2);
+    Motion &motion1 = registry().motions.get(tower1);
+    Motion &motion2 = registry().motions.get(tower2);
 
     // Create electricity visual effect - duration of 500ms for a quick discharge
     Entity effect = ParticleSystem::createElectricityEffect(motion1.position, motion2.position, 20.0f, 500.0f);
 
     // Get tower damage
-    Tower &tower_comp = registry.towers.get(tower1);
+    Tower &tower_comp = registry().towers.get(tower1);
+    PLANT_ID plant = registry().plantAnimations.get(tower1).id;
 
     // Calculate rectangle area between the two towers
     vec2 direction = motion2.position - motion1.position;
@@ -322,14 +338,16 @@ void TowerSystem::create_electricity_effect(Entity tower1, Entity tower2)
     float damage_width = 40.0f;
 
     // Check and damage all enemies in the rectangular area
-    for (uint i = 0; i < registry.enemies.size(); i++)
+    nearby.clear();
+    world().enemy_grid.query_oriented_rect(motion1.position, normalized_dir, length, damage_width / 2, nearby);
+    order_like(registry().enemies, nearby, nearby_order);
+    for (Entity enemy : nearby)
     {
-        Entity enemy = registry.enemies.entities[i];
-        if (!registry.motions.has(enemy))
+        if (!registry().motions.has(enemy))
             continue;
 
-        Motion &enemy_motion = registry.motions.get(enemy);
-        Enemy &enemy_comp = registry.enemies.components[i];
+        Motion &enemy_motion = registry().motions.get(enemy);
+        Enemy &enemy_comp = registry().enemies.get(enemy);
 
         // Calculate if enemy is within the rectangle
         vec2 enemy_relative = enemy_motion.position - motion1.position;
@@ -341,9 +359,10 @@ void TowerSystem::create_electricity_effect(Entity tower1, Entity tower2)
         {
             // Damage enemy
             enemy_comp.health -= tower_comp.damage;
+            world().stats.add_damage(plant, tower_comp.damage);
 
             // Add hit effect
-            registry.hitEffects.emplace_with_duplicates(enemy);
+            registry().hitEffects.emplace_with_duplicates(enemy);
 
             // No need for an additional electric effect on the enemy,
             // as the main electricity visual already covers the area
@@ -2,6 +2,7 @@
 
 #include "common.hpp"
 #include "tinyECS/registry.hpp"
+#include "spatial_grid.hpp"
 
 class TowerSystem
 {
@@ -14,8 +15,13 @@ public:
 private:
     // Helper functions
     bool find_nearest_enemy(Entity tower, Entity& target);
+    // Fills nearby with the enemies that may be within range of tower, in registry order
+    void find_enemies_in_range(Entity tower, float range);
     void fire_projectile(Entity tower, Entity target);
     float compute_delta_distance(Entity tower, Entity target);
 
     void create_electricity_effect(Entity tower1, Entity tower2);
+
+    std::vector<Entity> nearby; // enemies found in the grid, reused every query
+    std::vector<OrderKey> nearby_order;
 };
\ No newline at end of file
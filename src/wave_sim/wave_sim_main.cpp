@@ -0,0 +1,422 @@
+// Entry point of wave_sim: balance runs of the days in days.hpp. Plays many seeded games headless
+// (no window, no OpenGL, no audio), all with the same towers planted before the first enemy, on
+// every core at once, and reports how they went: the share of games that survived, the damage each
+// kind of plant dealt and how long each day took to clear.
+//
+//   wave_sim --layout FILE [--games N] [--threads N] [--seed N] [--first-day N] [--last-day N]
+//            [--steps N] [--json FILE]
+//
+// Game i plays with seed --seed + i (default 1) from the start of --first-day (default 1) until
+// --last-day (default the last day of DAY_MAP) is cleared, the game is lost or it has run --steps
+// simulation steps. The player stands where the game puts them and never attacks; a level-up takes
+// the first seed offered and cutscenes are clicked through. --threads games play at a time (default
+// one per core), each in its own World on its own thread. The games' own logging is dropped; --json
+// writes the numbers of the report, and every game's, to a file.
+// A layout has one tower per line ('#' starts a comment), see data/wave_sim/:
+//
+//   <plant> <x> <y>     plant as in PLANT_ID (PLANT_1, PLANT_2_PURPLE, ...), (x, y) a map cell
+//
+// PLANT_3 is rejected: it fires projectiles, and PLANT_PROJECTILE_MAP has no texture for them yet.
+
+// stdlib
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// internal
+#include "days.hpp"
+#include "scripted_player.hpp"
+#include "simulation.hpp"
+#include "tinyECS/memory.hpp"
+#include "world_init.hpp"
+
+#include "../../ext/json.hpp"
+using json = nlohmann::json;
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+	const std::pair<const char *, PLANT_ID> PLANT_NAMES[GameStats::PLANT_KINDS] = {
+		{"PLANT_1", PLANT_ID::PLANT_1},
+		{"PLANT_1_PURPLE", PLANT_ID::PLANT_1_PURPLE},
+		{"PLANT_1_YELLOW", PLANT_ID::PLANT_1_YELLOW},
+		{"PLANT_2", PLANT_ID::PLANT_2},
+		{"PLANT_2_PURPLE", PLANT_ID::PLANT_2_PURPLE},
+		{"PLANT_2_CYAN", PLANT_ID::PLANT_2_CYAN},
+		{"PLANT_3", PLANT_ID::PLANT_3},
+		{"PLANT_3_BLUE", PLANT_ID::PLANT_3_BLUE},
+	};
+
+	const char *plant_name(int plant)
+	{
+		for (const auto &named_plant : PLANT_NAMES)
+		{
+			if ((int)named_plant.second == plant)
+				return named_plant.first;
+		}
+		return "?";
+	}
+
+	struct TowerPlacement
+	{
+		PLANT_ID plant;
+		int x; // map cell
+		int y;
+	};
+
+	// False for plants the game cannot run yet: a projectile plant fires with the texture of
+	// PLANT_PROJECTILE_MAP, and TowerSystem aborts on one without
+	bool plant_supported(PLANT_ID plant)
+	{
+		return PLANT_STATS_MAP.at(plant).type != PLANT_TYPE::PROJECTILE || PLANT_PROJECTILE_MAP.count(plant) > 0;
+	}
+
+	// Reads a layout; false (with a message) on the first malformed line or unsupported plant
+	bool load_layout(const std::string &path, std::vector<TowerPlacement> &towers)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			std::cerr << "ERROR: cannot open layout " << path << std::endl;
+			return false;
+		}
+		std::string line;
+		for (int line_number = 1; std::getline(file, line); line_number++)
+		{
+			line = line.substr(0, line.find('#'));
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+			std::istringstream in(line);
+			std::string name;
+			TowerPlacement tower;
+			bool valid = bool(in >> name >> tower.x >> tower.y) && tower.x >= 0 && tower.x < MAP_WIDTH_TILE_NUM &&
+						 tower.y >= 0 && tower.y < MAP_HEIGHT_TILE_NUM;
+			auto named_plant = std::find_if(std::begin(PLANT_NAMES), std::end(PLANT_NAMES),
+											[&](const auto &named_plant) { return name == named_plant.first; });
+			if (!valid || named_plant == std::end(PLANT_NAMES))
+			{
+				std::cerr << "ERROR: " << path << ":" << line_number << ": cannot parse '" << line << "'" << std::endl;
+				return false;
+			}
+			tower.plant = named_plant->second;
+			if (!plant_supported(tower.plant))
+			{
+				std::cerr << "ERROR: " << path << ":" << line_number << ": " << name
+						  << " is not supported, it fires projectiles but PLANT_PROJECTILE_MAP has no texture for it"
+						  << std::endl;
+				return false;
+			}
+			towers.push_back(tower);
+		}
+		return true;
+	}
+
+	struct Options
+	{
+		int games = 1000;
+		unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+		unsigned int seed = 1;
+		int first_day = 1;
+		int last_day = DAY_MAP.rbegin()->first;
+		unsigned long max_steps = 60 * 60 * 60; // an hour of game time
+		std::vector<TowerPlacement> towers;
+	};
+
+	enum class Outcome
+	{
+		SURVIVED,  // cleared the last day
+		LOST,	   // game over
+		UNFINISHED // ran out of steps
+	};
+
+	struct GameRecord
+	{
+		Outcome outcome = Outcome::UNFINISHED;
+		int day = 0; // the day the game ended on
+		unsigned long simulated_steps = 0;
+		GameStats stats;
+	};
+
+	// Plays one game in a world of its own, bound to the calling thread for the duration
+	void play_game(unsigned int seed, const Options &options, GameRecord &record)
+	{
+		World world;
+		World::Scope world_scope(world);
+		world.random.seed(seed);
+		Simulation simulation(world, 0);
+		RenderSystem renderer_system;
+		GLFWwindow *window = simulation.world_system.create_window();
+		simulation.start_and_load_sounds();
+		renderer_system.init(window);
+		simulation.init(&renderer_system);
+
+		simulation.world_system.start_game(options.first_day);
+		for (const TowerPlacement &tower : options.towers)
+			createPlant(&renderer_system, vec2(tower.x * GRID_CELL_WIDTH_PX, tower.y * GRID_CELL_HEIGHT_PX), tower.plant);
+
+		for (unsigned long step = 0; step < options.max_steps; step++)
+		{
+			if (world.game_is_over)
+			{
+				record.outcome = Outcome::LOST;
+				break;
+			}
+			if (world.stats.cleared(options.last_day))
+			{
+				record.outcome = Outcome::SURVIVED;
+				break;
+			}
+
+			frame_arena.reset();
+			if (world.game_screen == GAME_SCREEN_ID::CG)
+				skip_cutscene();
+			else if (world.game_screen == GAME_SCREEN_ID::LEVEL_UP)
+				pick_level_up_seed();
+			else if (world.game_screen == GAME_SCREEN_ID::PLAYING)
+			{
+				simulation.step(SIMULATION_STEP_MS);
+				record.simulated_steps++;
+			}
+			world.registry.advance_tick();
+		}
+		record.day = world.current_day;
+		record.stats = world.stats;
+	}
+
+	// The value p percent of the sorted values do not exceed
+	float percentile(const std::vector<float> &sorted, double p)
+	{
+		if (sorted.empty())
+			return 0.f;
+		size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+		return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+	}
+
+	// Sends stdout, where the games log, to the null device until restore()
+	class MutedStdout
+	{
+	public:
+		MutedStdout()
+		{
+			std::fflush(stdout);
+#ifdef _WIN32
+			saved = _dup(_fileno(stdout));
+			std::freopen("NUL", "w", stdout);
+#else
+			saved = dup(fileno(stdout));
+			std::freopen("/dev/null", "w", stdout);
+#endif
+		}
+
+		void restore()
+		{
+			std::fflush(stdout);
+#ifdef _WIN32
+			_dup2(saved, _fileno(stdout));
+			_close(saved);
+#else
+			dup2(saved, fileno(stdout));
+			close(saved);
+#endif
+			std::clearerr(stdout);
+		}
+
+	private:
+		int saved;
+	};
+
+	void print_report(const Options &options, const std::vector<GameRecord> &records, double wall_ms)
+	{
+		const int games = (int)records.size();
+		int outcomes[3] = {};
+		std::vector<int> lost_on(options.last_day + 1, 0);
+		double damage[GameStats::PLANT_KINDS] = {};
+		unsigned long simulated_steps = 0;
+		for (const GameRecord &record : records)
+		{
+			outcomes[(int)record.outcome]++;
+			if (record.outcome == Outcome::LOST && record.day <= options.last_day)
+				lost_on[record.day]++;
+			for (int plant = 0; plant < GameStats::PLANT_KINDS; plant++)
+				damage[plant] += record.stats.plant_damage[plant];
+			simulated_steps += record.simulated_steps;
+		}
+
+		std::cout << std::fixed << std::setprecision(1);
+		std::cout << "wave_sim: " << games << " games of days " << options.first_day << "-" << options.last_day
+				  << ", seeds " << options.seed << "-" << options.seed + games - 1 << ", " << options.towers.size()
+				  << " towers, " << options.threads << " threads" << std::endl;
+		std::cout << "survived: " << outcomes[(int)Outcome::SURVIVED] << " ("
+				  << 100.0 * outcomes[(int)Outcome::SURVIVED] / games << "%), lost: " << outcomes[(int)Outcome::LOST]
+				  << ", out of steps: " << outcomes[(int)Outcome::UNFINISHED] << std::endl;
+
+		double total_damage = 0;
+		for (double plant_damage : damage)
+			total_damage += plant_damage;
+		std::cout << "damage per game, by plant:" << std::endl;
+		for (int plant = 0; plant < GameStats::PLANT_KINDS; plant++)
+		{
+			if (damage[plant] == 0)
+				continue;
+			std::cout << "  " << std::left << std::setw(16) << plant_name(plant) << std::right << std::setw(10)
+					  << damage[plant] / games << std::setw(7) << 100.0 * damage[plant] / total_damage << "%" << std::endl;
+		}
+
+		std::cout << "days (clear time in s, of the games that cleared it):" << std::endl;
+		std::cout << "  day  reached  cleared  lost     mean      p50      p95      max" << std::endl;
+		for (int day = options.first_day; day <= options.last_day; day++)
+		{
+			std::vector<float> clear_s;
+			int reached = 0;
+			for (const GameRecord &record : records)
+			{
+				if (record.day >= day)
+					reached++;
+				if (record.stats.cleared(day))
+					clear_s.push_back(record.stats.day_clear_ms[day] / 1000.f);
+			}
+			std::sort(clear_s.begin(), clear_s.end());
+			double mean = 0;
+			for (float s : clear_s)
+				mean += s / clear_s.size();
+			std::cout << std::setw(5) << day << std::setw(9) << reached << std::setw(9) << clear_s.size() << std::setw(6)
+					  << lost_on[day] << std::setw(9) << mean << std::setw(9) << percentile(clear_s, 50) << std::setw(9)
+					  << percentile(clear_s, 95) << std::setw(9) << (clear_s.empty() ? 0.f : clear_s.back()) << std::endl;
+		}
+
+		double game_s = simulated_steps * SIMULATION_STEP_MS / 1000.0;
+		// the cores that were busy, for the speed of a single one
+		unsigned int cores = std::min<unsigned int>(options.threads, games);
+		cores = std::min(cores, std::max(1u, std::thread::hardware_concurrency()));
+		double core_s = wall_ms / 1000.0 * cores;
+		std::cout << "wall time: " << wall_ms / 1000.0 << " s, " << games / (wall_ms / 1000.0) << " games/s, "
+				  << game_s << " s of game time: " << (core_s > 0 ? game_s / core_s : 0) << "x real time per core"
+				  << std::defaultfloat << std::endl;
+	}
+
+	bool write_json(const std::string &path, const Options &options, const std::vector<GameRecord> &records)
+	{
+		json games = json::array();
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			const GameRecord &record = records[i];
+			json damage = json::object();
+			for (int plant = 0; plant < GameStats::PLANT_KINDS; plant++)
+				damage[plant_name(plant)] = record.stats.plant_damage[plant];
+			json clear_ms = json::object();
+			for (int day = options.first_day; day <= options.last_day; day++)
+			{
+				if (record.stats.cleared(day))
+					clear_ms[std::to_string(day)] = record.stats.day_clear_ms[day];
+			}
+			const char *outcome = record.outcome == Outcome::SURVIVED ? "survived" : record.outcome == Outcome::LOST ? "lost" : "out of steps";
+			games.push_back({{"seed", options.seed + i},
+							 {"outcome", outcome},
+							 {"day", record.day},
+							 {"steps", record.simulated_steps},
+							 {"plant_damage", damage},
+							 {"day_clear_ms", clear_ms}});
+		}
+		json layout = json::array();
+		for (const TowerPlacement &tower : options.towers)
+			layout.push_back({{"plant", plant_name((int)tower.plant)}, {"x", tower.x}, {"y", tower.y}});
+
+		std::ofstream file(path);
+		if (!file)
+		{
+			std::cerr << "ERROR: cannot write " << path << std::endl;
+			return false;
+		}
+		file << json{{"first_day", options.first_day}, {"last_day", options.last_day}, {"layout", layout}, {"games", games}}.dump(1, '\t')
+			 << std::endl;
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Options options;
+	std::string layout_path;
+	std::string json_path;
+	for (int i = 1; i < argc; i++)
+	{
+		bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--layout") && has_value)
+			layout_path = argv[++i];
+		else if (!strcmp(argv[i], "--games") && has_value)
+			options.games = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--threads") && has_value)
+			options.threads = (unsigned int)std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && has_value)
+			options.seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--first-day") && has_value)
+			options.first_day = std::max(1, std::atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--last-day") && has_value)
+			options.last_day = std::atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--steps") && has_value)
+			options.max_steps = std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--json") && has_value)
+			json_path = argv[++i];
+		else
+		{
+			layout_path.clear();
+			break;
+		}
+	}
+	if (layout_path.empty() || options.last_day < options.first_day)
+	{
+		std::cerr << "usage: " << argv[0] << " --layout FILE [--games N] [--threads N] [--seed N] [--first-day N] [--last-day N]"
+				  << " [--steps N] [--json FILE]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (!load_layout(layout_path, options.towers))
+		return EXIT_FAILURE;
+
+	// each thread takes the next game until there are none left
+	std::vector<GameRecord> records(options.games);
+	std::atomic<int> next_game(0);
+	std::atomic<int> finished(0);
+	MutedStdout muted_stdout;
+	auto start = Clock::now();
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < std::min<unsigned int>(options.threads, options.games); t++)
+	{
+		threads.emplace_back([&]()
+		{
+			for (int game = next_game++; game < options.games; game = next_game++)
+			{
+				play_game(options.seed + game, options, records[game]);
+				int done = ++finished;
+				if (done % std::max(1, options.games / 10) == 0)
+					std::cerr << "wave_sim: " << done << "/" << options.games << " games" << std::endl;
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	double wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	muted_stdout.restore();
+
+	print_report(options, records, wall_ms);
+	if (!json_path.empty() && !write_json(json_path, options, records))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,24 @@
+// internal
+#include "world.hpp"
+#include "plants.hpp"
+
+static_assert((int)PLANT_ID::PLANT_3_BLUE + 1 == GameStats::PLANT_KINDS, "GameStats counts every PLANT_ID");
+
+void GameStats::clear_day(int day)
+{
+	if (day >= (int)day_clear_ms.size())
+		day_clear_ms.resize(day + 1, 0.f);
+	day_clear_ms[day] = day_ms;
+}
+
+World::Scope::Scope(World &world)
+	: previous_world(World::bound), previous_registry(ECSRegistry::bind(&world.registry))
+{
+	World::bound = &world;
+}
+
+World::Scope::~Scope()
+{
+	World::bound = previous_world;
+	ECSRegistry::bind(previous_registry);
+}
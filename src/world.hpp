@@ -0,0 +1,102 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+#include "random.hpp"
+#include "spatial_grid.hpp"
+#include "tinyECS/registry.hpp"
+
+// stlib
+#include <vector>
+
+class RenderSystem;
+enum class PLANT_ID;
+
+// What happened in a game, for balance runs (see wave_sim/): the damage each kind of plant dealt and
+// how long each day took to clear. WorldSystem resets it with the game.
+struct GameStats
+{
+	static constexpr int PLANT_KINDS = 8; // values of PLANT_ID
+
+	// damage dealt to enemies, by the PLANT_ID of the tower that dealt it
+	float plant_damage[PLANT_KINDS] = {};
+	// game time from the start of day d until its last enemy died, at [d]; 0 for days not cleared
+	std::vector<float> day_clear_ms;
+	// game time since the current day started
+	float day_ms = 0;
+
+	void add_damage(PLANT_ID plant, float damage) { plant_damage[(int)plant] += damage; }
+	// Records day as cleared after day_ms
+	void clear_day(int day);
+	bool cleared(int day) const { return day < (int)day_clear_ms.size() && day_clear_ms[day] > 0; }
+};
+
+// How much cosmetic work the systems do, lowered by the FrameGovernor when frames run over budget.
+// Only looks change: nothing here feeds back into the game's state.
+struct QualitySettings
+{
+	float particle_spawn_rate = 1.f;	 // ParticleSystem: fraction of the generators' spawn rate
+	bool electricity_jitter = true;		 // ParticleSystem: flicker, jitter and spin of electricity particles
+	int offscreen_animation_interval = 1; // AnimationSystem: looping animations off screen advance every n-th update
+};
+
+// One game: its entities and components, the game state kept outside the registry and its random
+// streams. A process may hold any number of worlds. Each thread works on the one bound to it (see
+// Scope), which is how the systems and the create* helpers reach it through world() and registry();
+// worlds share nothing, so games bound to different threads run side by side.
+class World
+{
+public:
+	ECSRegistry registry;
+	RandomService random;
+
+	// game state outside the registry, kept by WorldSystem
+	GAME_SCREEN_ID game_screen = GAME_SCREEN_ID::SPLASH;
+	int current_day = 1;
+	bool game_is_over = false;
+	bool player_is_dashing = false;
+
+	// the renderer holding the meshes the systems create entities with, set by Simulation::init
+	RenderSystem *renderer = nullptr;
+	// AnimationSystem steps so far, off-screen animations are staggered by it
+	unsigned int animation_updates = 0;
+
+	GameStats stats;
+
+	// written by the FrameGovernor of this world's game between its steps, read by the systems
+	QualitySettings quality;
+
+	// the enemies by position, rebuilt by PhysicsSystem once it has moved them each step; what
+	// towers, projectiles and the player's attack look up enemies in
+	SpatialGrid enemy_grid;
+
+	World() = default;
+	World(const World &) = delete;
+	World &operator=(const World &) = delete;
+
+	// Binds a world, and its registry, to the calling thread for the lifetime of the scope, then
+	// restores what was bound before. Only pointers are swapped, so it is cheap enough per job.
+	class Scope
+	{
+	public:
+		explicit Scope(World &world);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		World *previous_world;
+		ECSRegistry *previous_registry;
+	};
+
+private:
+	static inline thread_local World *bound = nullptr;
+	friend World &world();
+};
+
+// The world bound to the calling thread
+inline World &world()
+{
+	assert(World::bound && "no world bound to this thread");
+	return *World::bound;
+}
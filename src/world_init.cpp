@@ -9,17 +9,17 @@ using json = nlohmann::json;
 // Entity createGridLine(vec2 start_pos, vec2 end_pos)
 // {
 // 	Entity entity = Entity();
-// 	GridLine &gl = registry.gridLines.emplace(entity);
+// 	GridLine &gl = registry().gridLines.emplace(entity);
 // 	gl.start_pos = start_pos;
 // 	gl.end_pos = end_pos;
 
-// 	registry.renderRequests.insert(
+// 	registry().renderRequests.insert(
 // 		entity,
 // 		{TEXTURE_ASSET_ID::TEXTURE_COUNT,
 // 		 EFFECT_ASSET_ID::EGG,
 // 		 GEOMETRY_BUFFER_ID::DEBUG_LINE});
 
-// 	vec3 &cv = registry.colors.emplace(entity);
+// 	vec3 &cv = registry().colors.emplace(entity);
 // 	cv = GRID_COLOR;
 
 // 	return entity;
@@ -27,12 +27,12 @@ using json = nlohmann::json;
 
 Entity createPausePanel(RenderSystem* renderer, vec2 position) {
 	Entity entity = Entity();
-	Motion& motion = registry.motions.emplace(entity);
+	Motion& motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = { 0, 0 };
 	motion.position = position;
 	motion.scale = vec2({ 800, 700 });
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{
 			TEXTURE_ASSET_ID::PAUSE_PANEL,
@@ -41,21 +41,21 @@ Entity createPausePanel(RenderSystem* renderer, vec2 position) {
 		},
 		false
 	);
-	registry.cgs.emplace(entity);
+	registry().cgs.emplace(entity);
 	return entity;
 }
 
 Entity createButton(RenderSystem* renderer, BUTTON_ID type, vec2 position, vec2 toDeduct, float scale) {
 	Entity entity = Entity();
-	CustomButton &button = registry.buttons.emplace(entity);
+	CustomButton &button = registry().buttons.emplace(entity);
 	button.type = type;
 	if (scale == 1) //splash screen don't change
 		button.position = toDeduct;
 	else
 		button.position = vec2(toDeduct.x, toDeduct.y);
 	
-	Motion& motion = registry.motions.emplace(entity);
-	//MoveWithCamera &mwc = registry.moveWithCameras.emplace(entity);
+	Motion& motion = registry().motions.emplace(entity);
+	//MoveWithCamera &mwc = registry().moveWithCameras.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 		if (scale == 1) { //splash screen don't change 
@@ -72,29 +72,29 @@ Entity createButton(RenderSystem* renderer, BUTTON_ID type, vec2 position, vec2
 	if (scale == -1) {
 		motion.scale = vec2(60, 60);
 	}
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{(TEXTURE_ASSET_ID)((int)TEXTURE_ASSET_ID::START_BUTTON + (int)type),
 		 EFFECT_ASSET_ID::TEXTURED,
 		 GEOMETRY_BUFFER_ID::SPRITE});
-	registry.cgs.emplace(entity);
+	registry().cgs.emplace(entity);
 	return entity;
 }
 
 Entity createScreen(TEXTURE_ASSET_ID background)
 {
 	Entity entity = Entity();
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = {WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2};
 	motion.scale = vec2({WINDOW_WIDTH_PX, WINDOW_HEIGHT_PX});
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{background,
 		 EFFECT_ASSET_ID::TEXTURED,
 		 GEOMETRY_BUFFER_ID::SPRITE});
-	registry.cgs.emplace(entity);
+	registry().cgs.emplace(entity);
 	return entity;
 }
 
@@ -103,15 +103,15 @@ Entity createZombieSpawn(RenderSystem *renderer, vec2 position)
 {
 	Entity entity = Entity();
 
-	registry.zombieSpawns.emplace(entity);
+	registry().zombieSpawns.emplace(entity);
 
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = position;
 	motion.scale = vec2({ENEMY_WIDTH, ENEMY_HEIGHT});
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::ZOMBIE_SPAWN_1,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -127,26 +127,26 @@ Entity createEnemy(RenderSystem *renderer, vec2 position, int health, int damage
 {
 	auto entity = Entity();
 
-	Zombie &zombie = registry.zombies.emplace(entity);
+	Zombie &zombie = registry().zombies.emplace(entity);
 
-	Attack &attack = registry.attacks.emplace(entity);
+	Attack &attack = registry().attacks.emplace(entity);
 	attack.range = 30.0f;
 	attack.damage = damage;
 
-	Enemy &enemy = registry.enemies.emplace(entity);
+	Enemy &enemy = registry().enemies.emplace(entity);
 	enemy.health = health;
 	enemy.speed = speed;
 
-	auto &motion = registry.motions.emplace(entity);
+	auto &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = position;
 	motion.scale = vec2({ENEMY_WIDTH, ENEMY_HEIGHT});
 
-	VisualScale &vscale = registry.visualScales.emplace(entity);
+	VisualScale &vscale = registry().visualScales.emplace(entity);
 	vscale.scale = {5.f, 5.f}; // Scale visuals 3.1x
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{anim_textures[0],
 		 EFFECT_ASSET_ID::ZOMBIE,
@@ -192,31 +192,31 @@ Entity createOrcRider(RenderSystem *renderer, vec2 position)
 {
     Entity entity = Entity();
 
-    Motion &motion = registry.motions.emplace(entity);
+    Motion &motion = registry().motions.emplace(entity);
     motion.position = position;
     motion.angle = 0.f;
     motion.velocity = {0, 0};
     motion.scale = vec2(60.0f, 60.0f);
 
     // Add zombie component 
-    Zombie &zombie = registry.zombies.emplace(entity);
+    Zombie &zombie = registry().zombies.emplace(entity);
 
     // Add enemy component
-    Enemy &enemy = registry.enemies.emplace(entity);
+    Enemy &enemy = registry().enemies.emplace(entity);
     enemy.health = 80; 
     enemy.speed = 100;  // Base speed same as walk speed
     
-    Attack &attack = registry.attacks.emplace(entity);
+    Attack &attack = registry().attacks.emplace(entity);
     attack.range = 60.0f;         // Melee range for charge attack
     attack.damage = 10;           // Same as orcrider.damage
     
-    VisualScale &vscale = registry.visualScales.emplace(entity);
+    VisualScale &vscale = registry().visualScales.emplace(entity);
     vscale.scale = {4.f, 4.f}; // Scale visuals 4x
     
-    OrcRider &orcrider = registry.orcRiders.emplace(entity);
+    OrcRider &orcrider = registry().orcRiders.emplace(entity);
     orcrider.damage = 10; // Damage when charging into player
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::ORC_RIDER_IDLE1,
 		 EFFECT_ASSET_ID::ZOMBIE,
@@ -241,7 +241,7 @@ Entity createPlant(RenderSystem* renderer, vec2 position, PLANT_ID id)
 	Entity entity = Entity();
 
 	// Basic tower stats
-	Tower &tower = registry.towers.emplace(entity);
+	Tower &tower = registry().towers.emplace(entity);
 	tower.health = PLANT_STATS_MAP.at(id).health;
 	tower.damage = PLANT_STATS_MAP.at(id).damage;
 	tower.range = PLANT_STATS_MAP.at(id).range; // Detection range in pixels
@@ -250,29 +250,29 @@ Entity createPlant(RenderSystem* renderer, vec2 position, PLANT_ID id)
 	tower.type = PLANT_STATS_MAP.at(id).type;
 
 	// Motion component for position and rotation
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.position = {position.x + TOWER_BB_WIDTH / 2, position.y + TOWER_BB_HEIGHT / 2};
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};								// Towers don't move
 	motion.scale = vec2({TOWER_BB_WIDTH, TOWER_BB_HEIGHT}); // Using constants from common.hpp
 
-	Dimension &dimension = registry.dimensions.emplace(entity);
+	Dimension &dimension = registry().dimensions.emplace(entity);
 	dimension.width = TOWER_BB_WIDTH;
 	dimension.height = TOWER_BB_HEIGHT;
 
-	VisualScale& vscale = registry.visualScales.emplace(entity);
+	VisualScale& vscale = registry().visualScales.emplace(entity);
 	vscale.scale = { 1.5f, 1.5f };
 
 	// // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
 	// Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
-	// registry.meshPtrs.emplace(entity, &mesh);
+	// registry().meshPtrs.emplace(entity, &mesh);
 
 	// Plant animation id
-	PlantAnimation& plant_animation = registry.plantAnimations.emplace(entity);
+	PlantAnimation& plant_animation = registry().plantAnimations.emplace(entity);
 	plant_animation.id = id;
 
 	// Add render request for tower
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{PLANT_ANIMATION_MAP.at(id).idle.textures[0],
 		 EFFECT_ASSET_ID::ZOMBIE,
@@ -287,16 +287,16 @@ Entity createPlant(RenderSystem* renderer, vec2 position, PLANT_ID id)
 Entity createMapTile(Entity maptile_entity, vec2 position)
 {
 	// Create the associated component.
-	MapTile &maptile_component = registry.mapTiles.emplace(maptile_entity);
+	MapTile &maptile_component = registry().mapTiles.emplace(maptile_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(maptile_entity);
+	Motion &motion_component = registry().motions.emplace(maptile_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(GRID_CELL_WIDTH_PX, GRID_CELL_HEIGHT_PX);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		maptile_entity,
 		{DECORATION_LIST[1],
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -319,16 +319,16 @@ Entity createMapTile(vec2 position)
 Entity createMapTileDecoration(Entity decoration_entity, int i, vec2 position)
 {
 	// Create the associated component.
-	MapTile &maptile_component = registry.mapTiles.emplace(decoration_entity);
+	MapTile &maptile_component = registry().mapTiles.emplace(decoration_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(decoration_entity);
+	Motion &motion_component = registry().motions.emplace(decoration_entity);
 	motion_component.position = position;
 	motion_component.scale = DECORATION_SIZE_LIST[i];
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		decoration_entity,
 		{DECORATION_LIST[i],
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -353,7 +353,7 @@ Entity createTutorialTile(vec2 position)
 	Entity tutorial_tile_entity = Entity();
 
 	// Create the associated component.
-	TutorialTile &tutorial_tile_component = registry.tutorialTiles.emplace(tutorial_tile_entity);
+	TutorialTile &tutorial_tile_component = registry().tutorialTiles.emplace(tutorial_tile_entity);
 
 	// Create the associated maptile component.
 	createMapTile(tutorial_tile_entity, position);
@@ -367,7 +367,7 @@ Entity createTutorialTileDecoration(int i, vec2 position)
 	Entity tutorial_tile_entity = Entity();
 
 	// Create the associated component.
-	TutorialTile &tutorial_tile_component = registry.tutorialTiles.emplace(tutorial_tile_entity);
+	TutorialTile &tutorial_tile_component = registry().tutorialTiles.emplace(tutorial_tile_entity);
 
 	// Create the associated maptile component.
 	createMapTileDecoration(tutorial_tile_entity, i, position);
@@ -383,16 +383,16 @@ Entity createScorchedEarth(vec2 position)
 	Entity scorched_earth_entity = Entity();
 
 	// Create the associated component.
-	ScorchedEarth &scorched_earth_component = registry.scorchedEarths.emplace(scorched_earth_entity);
+	ScorchedEarth &scorched_earth_component = registry().scorchedEarths.emplace(scorched_earth_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(scorched_earth_entity);
+	Motion &motion_component = registry().motions.emplace(scorched_earth_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(GRID_CELL_WIDTH_PX, GRID_CELL_HEIGHT_PX);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		scorched_earth_entity,
 		{TEXTURE_ASSET_ID::SCORCHED_EARTH,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -406,14 +406,14 @@ Entity createScorchedEarth(vec2 position)
 void removeSurfaces()
 {
 	// remove all mapTiles
-	for (Entity &maptile_entity : registry.mapTiles.entities)
+	for (Entity &maptile_entity : registry().mapTiles.entities)
 	{
-		registry.remove_all_components_of(maptile_entity);
+		registry().remove_all_components_of(maptile_entity);
 	}
 	// remove all scorched earth
-	for (Entity &scorched_earth_entity : registry.scorchedEarths.entities)
+	for (Entity &scorched_earth_entity : registry().scorchedEarths.entities)
 	{
-		registry.remove_all_components_of(scorched_earth_entity);
+		registry().remove_all_components_of(scorched_earth_entity);
 	}
 	// print confirmation
 	std::cout << "surfaces reset" << std::endl;
@@ -426,16 +426,16 @@ Entity createTutorialMove(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_MOVE,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -453,7 +453,7 @@ Entity createTutorialMove(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_MOVE_D,
 	};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 1000;
 	animation_component.pose_count = 8;
 	animation_component.loop = true;
@@ -470,16 +470,16 @@ Entity createTutorialAttack(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_ATTACK,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -490,7 +490,7 @@ Entity createTutorialAttack(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_ATTACK,
 		TEXTURE_ASSET_ID::TUTORIAL_ATTACK_ANIMATED};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 1000;
 	animation_component.pose_count = 2;
 	animation_component.loop = true;
@@ -507,16 +507,16 @@ Entity createTutorialPlant(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_PLANT,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -527,7 +527,7 @@ Entity createTutorialPlant(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_PLANT,
 		TEXTURE_ASSET_ID::TUTORIAL_PLANT_ANIMATED};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 1000;
 	animation_component.pose_count = 2;
 	animation_component.loop = true;
@@ -544,16 +544,16 @@ Entity createTutorialDash(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_DASH,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -565,7 +565,7 @@ Entity createTutorialDash(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_DASH_ANIMATED,
 		TEXTURE_ASSET_ID::TUTORIAL_DASH_ANIMATED_2};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 1000;
 	animation_component.pose_count = 3;
 	animation_component.loop = true;
@@ -582,16 +582,16 @@ Entity createTutorialChangeSeed(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_CHANGE_SEED,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -608,7 +608,7 @@ Entity createTutorialChangeSeed(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_CHANGE_SEED_6,
 		TEXTURE_ASSET_ID::TUTORIAL_CHANGE_SEED_7};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 2000;
 	animation_component.pose_count = 8;
 	animation_component.loop = true;
@@ -625,16 +625,16 @@ Entity createTutorialRestart(vec2 position)
 	Entity tutorial_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(tutorial_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(tutorial_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(tutorial_entity);
+	Motion &motion_component = registry().motions.emplace(tutorial_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(465, 345);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		tutorial_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_RESTART,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -645,7 +645,7 @@ Entity createTutorialRestart(vec2 position)
 		TEXTURE_ASSET_ID::TUTORIAL_RESTART,
 		TEXTURE_ASSET_ID::TUTORIAL_RESTART_ANIMATED};
 
-	Animation &animation_component = registry.animations.emplace(tutorial_entity);
+	Animation &animation_component = registry().animations.emplace(tutorial_entity);
 	animation_component.transition_ms = 1000;
 	animation_component.pose_count = 2;
 	animation_component.loop = true;
@@ -662,16 +662,16 @@ Entity createTutorialArrow(vec2 position)
 	Entity arrow_entity = Entity();
 
 	// Create the associated component.
-	TutorialSign &tutorial_component = registry.tutorialSigns.emplace(arrow_entity);
+	TutorialSign &tutorial_component = registry().tutorialSigns.emplace(arrow_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(arrow_entity);
+	Motion &motion_component = registry().motions.emplace(arrow_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(80, 150);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the sign.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		arrow_entity,
 		{TEXTURE_ASSET_ID::TUTORIAL_ARROW,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -745,14 +745,14 @@ Entity createToolbar(vec2 position)
 	Entity toolbar_entity = Entity();
 	Entity projectile = Entity();
 
-    Motion &proj_motion = registry.motions.emplace(projectile);
+    Motion &proj_motion = registry().motions.emplace(projectile);
 	proj_motion.position.y = position.y;
     proj_motion.position.x = position.x - 4*TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
     proj_motion.scale = vec2(60,60);
 
      proj_motion.velocity = {0,0};
 
-    registry.renderRequests.insert(
+    registry().renderRequests.insert(
         projectile,
         {TEXTURE_ASSET_ID::SELECTED,
          EFFECT_ASSET_ID::TEXTURED,
@@ -760,22 +760,22 @@ Entity createToolbar(vec2 position)
 		false);
 
 	// Create the associated component.
-	Toolbar &toolbar_component = registry.toolbars.emplace(toolbar_entity);
-	Toolbar &projectile_component = registry.toolbars.emplace(projectile);
+	Toolbar &toolbar_component = registry().toolbars.emplace(toolbar_entity);
+	Toolbar &projectile_component = registry().toolbars.emplace(projectile);
 	
 
 	// Create a component to simplify movement.
-	MoveWithCamera &mwc = registry.moveWithCameras.emplace(toolbar_entity);
-	MoveWithCamera &mwcc = registry.moveWithCameras.emplace(projectile);
+	MoveWithCamera &mwc = registry().moveWithCameras.emplace(toolbar_entity);
+	MoveWithCamera &mwcc = registry().moveWithCameras.emplace(projectile);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(toolbar_entity);
+	Motion &motion_component = registry().motions.emplace(toolbar_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(TOOLBAR_WIDTH, TOOLBAR_HEIGHT);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		toolbar_entity,
 		{TEXTURE_ASSET_ID::TOOLBAR,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -786,12 +786,12 @@ Entity createToolbar(vec2 position)
 
 Entity createGameOver()
 {
-	registry.animations.clear();
-	registry.deathAnimations.clear();
-	registry.renderRequests.clear();
+	registry().animations.clear();
+	registry().deathAnimations.clear();
+	registry().renderRequests.clear();
 	Entity entity = Entity();
 
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = {WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2};
@@ -808,20 +808,20 @@ Entity createPause(vec2 position, BUTTON_ID texture)
 	Entity pause_entity = Entity();
 
 	// Create a component to simplify movement.
-	MoveWithCamera &mwc = registry.moveWithCameras.emplace(pause_entity);
+	MoveWithCamera &mwc = registry().moveWithCameras.emplace(pause_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(pause_entity);
+	Motion &motion_component = registry().motions.emplace(pause_entity);
 	motion_component.position = position;
 	motion_component.scale = vec2(60, 60);
 	motion_component.velocity = vec2(0, 0);
 
-	CustomButton& button = registry.buttons.emplace(pause_entity);
+	CustomButton& button = registry().buttons.emplace(pause_entity);
 	button.type = BUTTON_ID::PAUSE;
 	button.position = vec2(30, 30);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		pause_entity,
 		{(TEXTURE_ASSET_ID)((int)TEXTURE_ASSET_ID::START_BUTTON + (int)texture),
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -834,42 +834,42 @@ Entity createPlayer(RenderSystem *renderer, vec2 position, int seed_type)
 {
 	Entity entity = Entity();
 
-	State &state = registry.states.emplace(entity);
+	State &state = registry().states.emplace(entity);
 	state.state = STATE::IDLE;
 
-	Player &player = registry.players.emplace(entity);
+	Player &player = registry().players.emplace(entity);
 	player.health = PLAYER_HEALTH;
 	player.health_max = PLAYER_HEALTH;
 
-	Inventory &inventory = registry.inventorys.emplace(entity);
-	registry.inventorys.components[0].seedCount[seed_type] = 5; // 5 starter seeds
+	Inventory &inventory = registry().inventorys.emplace(entity);
+	registry().inventorys.components[0].seedCount[seed_type] = 5; // 5 starter seeds
 	for(int i = 0; i < NUM_SEED_TYPES; i++)
 	{
 		if (i == 7)
-			registry.inventorys.components[0].seedCount[i] = 0;
+			registry().inventorys.components[0].seedCount[i] = 0;
 		else
-			registry.inventorys.components[0].seedCount[i] = 4;
-		registry.inventorys.components[0].seedAtToolbar[i] = i;
+			registry().inventorys.components[0].seedCount[i] = 4;
+		registry().inventorys.components[0].seedAtToolbar[i] = i;
 	}
 
-	MoveWithCamera &mwc = registry.moveWithCameras.emplace(entity);
-	Motion &motion = registry.motions.emplace(entity);
+	MoveWithCamera &mwc = registry().moveWithCameras.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = position;
 	motion.scale = vec2({PLAYER_HEIGHT, PLAYER_HEIGHT});
 
-	VisualScale &vscale = registry.visualScales.emplace(entity);
+	VisualScale &vscale = registry().visualScales.emplace(entity);
 	vscale.scale = {5.f, 5.f}; // Scale visuals 3.1x
 
-	Attack &attack = registry.attacks.emplace(entity);
+	Attack &attack = registry().attacks.emplace(entity);
 	attack.range = 60;
 	attack.damage = PLAYER_DAMAGE;
 
-	registry.statuses.emplace(entity);
+	registry().statuses.emplace(entity);
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::PLAYER_IDLE1,
 		 EFFECT_ASSET_ID::PLAYER,
@@ -893,13 +893,13 @@ Entity createEffect(RenderSystem *renderer, vec2 position, vec2 scale)
 {
 	Entity entity = Entity();
 
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = position;
 	motion.scale = scale;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::PLAYER_ATTACK_SLASH_1,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -918,18 +918,18 @@ Entity createSeed(vec2 pos, int type)
 	Entity seed_entity = Entity();
 
 	// Create the associated component.
-	Seed &seed_component = registry.seeds.emplace(seed_entity);
+	Seed &seed_component = registry().seeds.emplace(seed_entity);
 	seed_component.type = type;
 	seed_component.timer = SEED_MATURE_SPEED * 1000;
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(seed_entity);
+	Motion &motion_component = registry().motions.emplace(seed_entity);
 	motion_component.position = pos;
 	motion_component.scale = vec2(50, 50);
 	motion_component.velocity = vec2(0, 0);
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		seed_entity,
 		{SEED_MAP.at(type).texture,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -947,24 +947,24 @@ Entity createSeedInventory(vec2 pos, vec2 velocity, int type, int toolbar_pos)
 	Entity seed_entity = Entity();
 
 	// Create the associated component.
-	Seed &seed_component = registry.seeds.emplace(seed_entity);
+	Seed &seed_component = registry().seeds.emplace(seed_entity);
 	seed_component.type = type;
 	seed_component.timer = 5000;
 
 	// Create a component to simplify movement.
-	MoveWithCamera &mwc = registry.moveWithCameras.emplace(seed_entity);
+	MoveWithCamera &mwc = registry().moveWithCameras.emplace(seed_entity);
 
 	// Create the relevant motion component.
-	Motion &motion_component = registry.motions.emplace(seed_entity);
+	Motion &motion_component = registry().motions.emplace(seed_entity);
 	motion_component.position = pos;
 	motion_component.scale = vec2(50, 50);
 	motion_component.velocity = velocity;
 
-	VisualScale& vscale = registry.visualScales.emplace(seed_entity);
+	VisualScale& vscale = registry().visualScales.emplace(seed_entity);
 	vscale.scale = {0.75, 0.75};
 
 	// Render the object.
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		seed_entity,
 		{
 			SEED_MAP.at(type).texture,
@@ -983,7 +983,7 @@ Entity createCamera(RenderSystem *renderer, vec2 position)
 	Entity camera = Entity();
 
 	// Create camera component
-	Camera &camera_component = registry.cameras.emplace(camera);
+	Camera &camera_component = registry().cameras.emplace(camera);
 	camera_component.position = position;
 
 	return camera;
@@ -995,30 +995,30 @@ Entity createSkeletonArcher(RenderSystem *renderer, vec2 position)
 	Entity entity = Entity();
 
 	// Add skeleton specific component with improved properties
-	Skeleton &skeleton = registry.skeletons.emplace(entity);
+	Skeleton &skeleton = registry().skeletons.emplace(entity);
 	skeleton.attack_range = 400.0f;							// Longer range than zombies
 	skeleton.stop_distance = 300.0f;						// Stops moving at this distance
 	skeleton.attack_cooldown_ms = SKELETON_ATTACK_DURATION; // Attack cooldown
 
-	Enemy &enemy = registry.enemies.emplace(entity);
+	Enemy &enemy = registry().enemies.emplace(entity);
 	enemy.health = SKELETON_ARCHER_HEALTH;
 
 	// Add attack component separate from zombies
-	Attack &attack = registry.attacks.emplace(entity);
+	Attack &attack = registry().attacks.emplace(entity);
 	attack.range = skeleton.attack_range;	// Match the attack range
 	attack.damage = SKELETON_ARCHER_DAMAGE; // Set the damage value
 
 	// Add motion component
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.position = position;
 	motion.velocity = {0, 0};
 	motion.scale = {ENEMY_WIDTH, ENEMY_HEIGHT};
 
-	VisualScale &vscale = registry.visualScales.emplace(entity);
+	VisualScale &vscale = registry().visualScales.emplace(entity);
 	vscale.scale = {5.f, 5.f}; // Scale visuals 3.1x
 
 	// Add render request - temporarily use zombie texture
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::SKELETON_IDLE1, // Replace with SKELETON texture
 		 EFFECT_ASSET_ID::ZOMBIE,		   // Consider using a unique shader for skeletons
@@ -1046,24 +1046,24 @@ Entity createArrow(vec2 position, vec2 direction, Entity source)
 	Entity entity = Entity();
 
 	// Add arrow component
-	Arrow &arrow = registry.arrows.emplace(entity);
+	Arrow &arrow = registry().arrows.emplace(entity);
 	arrow.source = source;
 	arrow.direction = normalize(direction); // Ensure direction is normalized
 	arrow.damage = SKELETON_ARCHER_DAMAGE;
 
 	// Add motion component
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 	motion.position = position;
 	motion.velocity = arrow.direction * arrow.speed;
 	// Set proper angle for the arrow based on direction
 	motion.angle = atan2(direction.y, direction.x) * 180.f / M_PI;
 	motion.scale = {10.f, 10.f}; // Arrow size
 
-	VisualScale &vscale = registry.visualScales.emplace(entity);
+	VisualScale &vscale = registry().visualScales.emplace(entity);
 	vscale.scale = {10.f, 10.f}; // Scale visuals 2.5x
 
 	// Add render request - use projectile texture or a specific arrow texture
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::ARROW,
 		 EFFECT_ASSET_ID::TEXTURED,
@@ -1072,10 +1072,10 @@ Entity createArrow(vec2 position, vec2 direction, Entity source)
 	return entity;
 }
 
-Entity createText(std::string text, vec2 pos, float size, vec3 color) {
+Entity createText(std::string_view text, vec2 pos, float size, vec3 color) {
 	Entity text_entity = Entity();
 
-	Text &text_component = registry.texts.emplace(text_entity);
+	Text &text_component = registry().texts.emplace(text_entity);
 	text_component.text = text;
 	text_component.pos = pos;
 	text_component.size = size;
@@ -1088,14 +1088,14 @@ Entity createChicken(RenderSystem *renderer)
 {
 	auto entity = Entity();
 
-	Projectile &projectile = registry.projectiles.emplace(entity);
+	Projectile &projectile = registry().projectiles.emplace(entity);
 	projectile.damage = CHICKEN_DAMAGE;
 	projectile.invincible = true;
 
 	Mesh &mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::CHICKEN);
-	registry.meshPtrs.emplace(entity, &mesh);
+	registry().meshPtrs.emplace(entity, &mesh);
 
-	auto &motion = registry.motions.emplace(entity);
+	auto &motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = {CHICKEN_SPEED, 0};
 	motion.position = vec2(0, WINDOW_HEIGHT_PX / 2);
@@ -1103,14 +1103,14 @@ Entity createChicken(RenderSystem *renderer)
 	motion.scale.x *= -1;
 	motion.scale.y *= -1;
 
-	if (registry.players.size() > 0)
+	if (registry().players.size() > 0)
 	{
-		Entity &player_entity = registry.players.entities[0];
-		Motion &player_motion = registry.motions.get(player_entity);
+		Entity &player_entity = registry().players.entities[0];
+		Motion &player_motion = registry().motions.get(player_entity);
 		motion.position.y = player_motion.position.y;
 	}
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{TEXTURE_ASSET_ID::TEXTURE_COUNT,
 		 EFFECT_ASSET_ID::CHICKEN,
@@ -1122,19 +1122,19 @@ Entity createChicken(RenderSystem *renderer)
 Entity createCharacter(RenderSystem *renderer, vec2 position, vec2 scale, TEXTURE_ASSET_ID texture)
 {
 	Entity entity = Entity();
-	Motion &motion = registry.motions.emplace(entity);
+	Motion &motion = registry().motions.emplace(entity);
 
 	motion.angle = 0.f;
 	motion.velocity = {0, 0};
 	motion.position = position;
 	motion.scale = scale;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{texture,
 		 EFFECT_ASSET_ID::PLAYER,
 		 GEOMETRY_BUFFER_ID::SPRITE},
 		false);
-	registry.cgs.emplace(entity);
+	registry().cgs.emplace(entity);
 	return entity;
 }
@@ -70,5 +70,5 @@ Entity createGameOver();
 Entity createSkeletonArcher(RenderSystem* renderer, vec2 position);
 Entity createArrow(vec2 position, vec2 direction, Entity source);
 
-Entity createText(std::string text, vec2 pos, float size, vec3 color);
+Entity createText(std::string_view text, vec2 pos, float size, vec3 color);
 
@@ -16,6 +16,9 @@
 using json = nlohmann::json;
 #include "particle_system.hpp"
 #include "render_system.hpp"
+#include "profiler.hpp"
+#include "random.hpp"
+#include "world.hpp"
 
 // FreeType
 #include <ft2build.h>
@@ -23,11 +26,7 @@ using json = nlohmann::json;
 
 FT_Library library;
 
-bool WorldSystem::game_is_over = false;
 Mix_Chunk *WorldSystem::game_over_sound = nullptr;
-GAME_SCREEN_ID WorldSystem::game_screen = GAME_SCREEN_ID::SPLASH;
-int WorldSystem::current_day = 1;
-bool WorldSystem::player_is_dashing = false;
 
 // create the world
 WorldSystem::WorldSystem() : points(0), level(1), current_seed(0)
@@ -50,7 +49,7 @@ WorldSystem::~WorldSystem()
 	Mix_CloseAudio();
 
 	// Destroy all created components
-	registry.clear_all_components();
+	registry().clear_all_components();
 
 	// Close the window
 	glfwDestroyWindow(window);
@@ -118,11 +117,31 @@ GLFWwindow *WorldSystem::create_window()
 	// http://www.glfw.org/docs/latest/input_guide.html
 	glfwSetWindowUserPointer(window, this);
 	auto key_redirect = [](GLFWwindow *wnd, int _0, int _1, int _2, int _3)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_key(_0, _1, _2, _3); };
+	{
+		InputEvent event;
+		event.type = InputEvent::Type::KEY;
+		event.code = _0;
+		event.action = _2;
+		event.mods = _3;
+		((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_window_input(event);
+	};
 	auto cursor_pos_redirect = [](GLFWwindow *wnd, double _0, double _1)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_mouse_move({_0, _1}); };
+	{
+		InputEvent event;
+		event.type = InputEvent::Type::MOUSE_MOVE;
+		event.x = (float)_0;
+		event.y = (float)_1;
+		((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_window_input(event);
+	};
 	auto mouse_button_pressed_redirect = [](GLFWwindow *wnd, int _button, int _action, int _mods)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_mouse_button_pressed(_button, _action, _mods); };
+	{
+		InputEvent event;
+		event.type = InputEvent::Type::MOUSE_BUTTON;
+		event.code = _button;
+		event.action = _action;
+		event.mods = _mods;
+		((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_window_input(event);
+	};
 
 	glfwSetKeyCallback(window, key_redirect);
 	glfwSetCursorPosCallback(window, cursor_pos_redirect);
@@ -131,6 +150,38 @@ GLFWwindow *WorldSystem::create_window()
 	return window;
 }
 
+void WorldSystem::on_window_input(InputEvent event)
+{
+	if (input_filter && !input_filter(event))
+		return;
+	handle_input(event);
+}
+
+void WorldSystem::handle_input(const InputEvent &event)
+{
+	switch (event.type)
+	{
+	case InputEvent::Type::KEY:
+		if (event.code >= 0 && event.code <= GLFW_KEY_LAST)
+			keys_down[event.code] = event.action != GLFW_RELEASE;
+		on_key(event.code, 0, event.action, event.mods);
+		break;
+	case InputEvent::Type::MOUSE_MOVE:
+		on_mouse_move({event.x, event.y});
+		break;
+	case InputEvent::Type::MOUSE_BUTTON:
+		on_mouse_button_pressed(event.code, event.action, event.mods);
+		break;
+	case InputEvent::Type::END:
+		break;
+	}
+}
+
+bool WorldSystem::is_key_down(int key) const
+{
+	return key >= 0 && key <= GLFW_KEY_LAST && keys_down[key];
+}
+
 bool WorldSystem::start_and_load_sounds()
 {
 
@@ -179,8 +230,8 @@ void WorldSystem::init(RenderSystem *renderer_arg)
 void WorldSystem::restart_splash_screen()
 {
 	clearButtons();
-	game_screen = GAME_SCREEN_ID::SPLASH;
-	registry.screenStates.components[0].darken_screen_factor = 0;
+	world().game_screen = GAME_SCREEN_ID::SPLASH;
+	registry().screenStates.components[0].darken_screen_factor = 0;
 	createScreen(TEXTURE_ASSET_ID::BACKGROUND);
 	createButton(renderer, BUTTON_ID::START, vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 5), vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 5), 1);
 	createButton(renderer, BUTTON_ID::LOAD, vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 5 + 200), vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 5 + 200), 1);
@@ -191,20 +242,21 @@ void WorldSystem::restart_splash_screen()
 // Update our game world
 bool WorldSystem::step(float elapsed_ms_since_last_update)
 {
-	// if(game_screen == GAME_SCREEN_ID::LEVEL_UP) {
+	PROFILE_SCOPE("world");
+	// if(world().game_screen == GAME_SCREEN_ID::LEVEL_UP) {
 	// 			std::set<int> unique_numbers;
 	// 	bool buttonsCreated = false;
 	// 	levelUpHelper(renderer, unique_numbers, buttonsCreated);
 	// }
-	if (registry.players.size() != 0 && registry.screenStates.size() != 0 && registry.inventorys.size() != 0)
+	if (registry().players.size() != 0 && registry().screenStates.size() != 0 && registry().inventorys.size() != 0)
 	{
 		increase_level();
 	}
 	// Using the spawn manager to generate zombies
-	if (WorldSystem::game_is_over)
+	if (world().game_is_over)
 	{
-		assert(registry.screenStates.components.size() <= 1);
-		ScreenState &screen = registry.screenStates.components[0];
+		assert(registry().screenStates.components.size() <= 1);
+		ScreenState &screen = registry().screenStates.components[0];
 		if (screen.game_over)
 		{
 			screen.lerp_timer += elapsed_ms_since_last_update;
@@ -215,7 +267,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 		}
 	}
 
-	if (registry.enemies.size() == 0 && current_bgm != night_bgm)
+	if (registry().enemies.size() == 0 && current_bgm != night_bgm)
 	{
 		current_bgm = night_bgm;
 		std::thread music_thread([this]()
@@ -225,7 +277,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 			Mix_FadeInMusic(night_bgm, -1, 1000); });
 		music_thread.detach();
 	}
-	else if (registry.enemies.size() > 0 && current_bgm != combat_bgm)
+	else if (registry().enemies.size() > 0 && current_bgm != combat_bgm)
 	{
 		current_bgm = combat_bgm;
 		std::thread music_thread([this]()
@@ -236,16 +288,16 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 		music_thread.detach();
 	}
 
-	if (!WorldSystem::game_is_over && game_screen != GAME_SCREEN_ID::SPLASH && game_screen != GAME_SCREEN_ID::CG && game_screen != GAME_SCREEN_ID::LEVEL_UP)
+	if (!world().game_is_over && world().game_screen != GAME_SCREEN_ID::SPLASH && world().game_screen != GAME_SCREEN_ID::CG && world().game_screen != GAME_SCREEN_ID::LEVEL_UP)
 	{
 		update_camera();
 		// spawn_manager.step(elapsed_ms_since_last_update, renderer);
-		if (game_screen == GAME_SCREEN_ID::PLAYING)
+		if (world().game_screen == GAME_SCREEN_ID::PLAYING)
 		{
 			updateDayInProgress(elapsed_ms_since_last_update);
 		}
 		// Check and respawn tutorial enemies if needed
-		if (game_screen == GAME_SCREEN_ID::TUTORIAL)
+		if (world().game_screen == GAME_SCREEN_ID::TUTORIAL)
 		{
 			check_tutorial_enemies();
 		}
@@ -257,7 +309,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 		update_dash(elapsed_ms_since_last_update);
 
 		// Summon the chicken when in low health
-		ScreenState &screen = registry.screenStates.components[0];
+		ScreenState &screen = registry().screenStates.components[0];
 		if (screen.hp_percentage < 0.25f && !chicken_summoned)
 		{
 			createChicken(renderer);
@@ -265,10 +317,11 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 		}
 
 		// Print level, day, and enemies killed.
-		registry.texts.clear();
-		createText("Enemies Killed: " + std::to_string(points), vec2(WINDOW_WIDTH_PX * 0.2, WINDOW_HEIGHT_PX - 50.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
-		createText("Level: " + std::to_string(level), vec2(WINDOW_WIDTH_PX * 0.475, WINDOW_HEIGHT_PX - 50.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
-		createText("Day: " + std::to_string(current_day), vec2(WINDOW_WIDTH_PX * 0.475, WINDOW_HEIGHT_PX - 100.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
+		registry().texts.clear();
+		// formatted into the frame arena, the Text components copy them into their own storage
+		createText(frame_arena.format("Enemies Killed: %u", points), vec2(WINDOW_WIDTH_PX * 0.2, WINDOW_HEIGHT_PX - 50.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
+		createText(frame_arena.format("Level: %u", level), vec2(WINDOW_WIDTH_PX * 0.475, WINDOW_HEIGHT_PX - 50.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
+		createText(frame_arena.format("Day: %d", world().current_day), vec2(WINDOW_WIDTH_PX * 0.475, WINDOW_HEIGHT_PX - 100.0f), 0.5f, vec3(0.9f, 0.9f, 0.9f));
 
 		return true;
 	}
@@ -279,20 +332,21 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 // Shared elements between restarting a game and a tutorial
 void WorldSystem::restart_common_tasks(vec2 map_dimensions)
 {
-	registry.clear_all_components();
+	registry().clear_all_components();
 
-	registry.particles.clear();
-	registry.particleGenerators.clear();
-	registry.customData.clear();
-	registry.hitEffects.clear();
+	registry().particles.clear();
+	registry().particleGenerators.clear();
+	registry().customData.clear();
+	registry().hitEffects.clear();
 
 	// Reset day counter and related variables
-	current_day = 1;
-	spawn_manager.set_day(current_day);
+	world().stats = GameStats();
+	world().current_day = 1;
+	spawn_manager.set_day(world().current_day);
 	rest_timer_ms = 0.f;
 	enemy_spawn_timer_ms = 0.f;
 	enemies_spawned_today = 0;
-	enemies_to_spawn_today = calculate_enemies_for_day(current_day);
+	enemies_to_spawn_today = calculate_enemies_for_day(world().current_day);
 	day_in_progress = true;
 	current_seed = 0;
 
@@ -307,9 +361,9 @@ void WorldSystem::restart_common_tasks(vec2 map_dimensions)
 	Mix_VolumeMusic(128 * 0.35);
 
 	// Debugging for memory/component leaks
-	registry.list_all_components();
+	registry().list_all_components();
 
-	game_is_over = false;
+	world().game_is_over = false;
 
 	// Reset the spawn manager
 	spawn_manager.reset();
@@ -319,15 +373,15 @@ void WorldSystem::restart_common_tasks(vec2 map_dimensions)
 	current_speed = 1.f;
 
 	points = 0;
-	registry.screenStates.get(registry.screenStates.entities[0]).game_over = false;
-	registry.screenStates.get(registry.screenStates.entities[0]).lerp_timer = 0.0;
+	registry().screenStates.get(registry().screenStates.entities[0]).game_over = false;
+	registry().screenStates.get(registry().screenStates.entities[0]).lerp_timer = 0.0;
 
 	// Remove all entities that we created
-	while (registry.motions.entities.size() > 0)
-		registry.remove_all_components_of(registry.motions.entities.back());
+	while (registry().motions.entities.size() > 0)
+		registry().remove_all_components_of(registry().motions.entities.back());
 
 	// debugging for memory/component leaks
-	registry.list_all_components();
+	registry().list_all_components();
 
 	int grid_line_width = GRID_LINE_WIDTH_PX;
 
@@ -354,10 +408,10 @@ void WorldSystem::restart_common_tasks(vec2 map_dimensions)
 	}
 
 	// if the screenState exists, reset the health bar percentages
-	if (registry.screenStates.size() != 0)
+	if (registry().screenStates.size() != 0)
 	{
-		registry.screenStates.get(registry.screenStates.entities[0]).hp_percentage = 1.0;
-		registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage = 0.0;
+		registry().screenStates.get(registry().screenStates.entities[0]).hp_percentage = 1.0;
+		registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage = 0.0;
 	}
 }
 
@@ -371,18 +425,18 @@ void WorldSystem::restart_overlay_renders(vec2 player_pos)
 	createCamera(renderer, player_pos);
 
 	// Kung: Create the pause button and toolbar, and have them overlay the player
-	registry.toolbars.clear();
+	registry().toolbars.clear();
 	vec2 position = vec2(player_pos.x - CAMERA_VIEW_WIDTH / 2 + 30, player_pos.y - CAMERA_VIEW_HEIGHT / 2 + 30);
-	if (game_screen == GAME_SCREEN_ID::TUTORIAL)
+	if (world().game_screen == GAME_SCREEN_ID::TUTORIAL)
 		createPause(position, BUTTON_ID::RETURN);
 	else
 		createPause(position, BUTTON_ID::PAUSE);
 	createToolbar(vec2(player_pos.x, player_pos.y + CAMERA_VIEW_HEIGHT * 0.45));
 	for (int i = 0; i < NUM_SEED_TYPES; i++)
 	{
-		if (registry.inventorys.components[0].seedCount[i] > 0)
+		if (registry().inventorys.components[0].seedCount[i] > 0)
 		{
-			createSeedInventory(vec2(player_pos.x + (i - 4) * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2, player_pos.y + CAMERA_VIEW_HEIGHT * 0.45), registry.motions.get(player).velocity, i, i);
+			createSeedInventory(vec2(player_pos.x + (i - 4) * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2, player_pos.y + CAMERA_VIEW_HEIGHT * 0.45), registry().motions.get(player).velocity, i, i);
 			std::cout << "seed type: " << i << std::endl;
 		}
 	}
@@ -390,43 +444,43 @@ void WorldSystem::restart_overlay_renders(vec2 player_pos)
 	// Kung: Reset player movement so that the player remains still when no keys are pressed
 
 	// Move left
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	if (is_key_down(GLFW_KEY_A))
 	{
 		std::cout << "huh" << std::endl;
-		for (Entity mwc_entity : registry.moveWithCameras.entities)
+		for (Entity mwc_entity : registry().moveWithCameras.entities)
 		{
-			if (registry.motions.has(mwc_entity))
-				registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
+			if (registry().motions.has(mwc_entity))
+				registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
 		}
 	}
 
 	// Move right
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	if (is_key_down(GLFW_KEY_D))
 	{
-		for (Entity mwc_entity : registry.moveWithCameras.entities)
+		for (Entity mwc_entity : registry().moveWithCameras.entities)
 		{
-			if (registry.motions.has(mwc_entity))
-				registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
+			if (registry().motions.has(mwc_entity))
+				registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
 		}
 	}
 
 	// Move down
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	if (is_key_down(GLFW_KEY_S))
 	{
-		for (Entity mwc_entity : registry.moveWithCameras.entities)
+		for (Entity mwc_entity : registry().moveWithCameras.entities)
 		{
-			if (registry.motions.has(mwc_entity))
-				registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
+			if (registry().motions.has(mwc_entity))
+				registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
 		}
 	}
 
 	// Move up
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	if (is_key_down(GLFW_KEY_W))
 	{
-		for (Entity mwc_entity : registry.moveWithCameras.entities)
+		for (Entity mwc_entity : registry().moveWithCameras.entities)
 		{
-			if (registry.motions.has(mwc_entity))
-				registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
+			if (registry().motions.has(mwc_entity))
+				registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
 		}
 	}
 }
@@ -434,17 +488,17 @@ void WorldSystem::restart_overlay_renders(vec2 player_pos)
 void WorldSystem::start_cg(RenderSystem *renderer)
 {
 	// If a player entity exists, set the moveWithCamera items to zero velocity.
-	if (registry.players.size() != 0) {
-		for (Entity mwc_entity : registry.moveWithCameras.entities) {
-			if (registry.motions.has(mwc_entity)) registry.motions.get(mwc_entity).velocity = vec2(0, 0);
+	if (registry().players.size() != 0) {
+		for (Entity mwc_entity : registry().moveWithCameras.entities) {
+			if (registry().motions.has(mwc_entity)) registry().motions.get(mwc_entity).velocity = vec2(0, 0);
 		}
 	}
 
 	// Now start the cutscene.
-	registry.cgs.clear();
-	game_screen = GAME_SCREEN_ID::CG;
-	int cg_idx = registry.screenStates.components[0].cg_index;
-	int cutscene = registry.screenStates.components[0].cutscene;
+	registry().cgs.clear();
+	world().game_screen = GAME_SCREEN_ID::CG;
+	int cg_idx = registry().screenStates.components[0].cg_index;
+	int cutscene = registry().screenStates.components[0].cutscene;
 	if (cutscene == 1)
 	{
 		createScreen(TEXTURE_ASSET_ID::NIGHT_BG);
@@ -462,9 +516,9 @@ void WorldSystem::restart_game()
 
 	restart_common_tasks(vec2(MAP_WIDTH_PX, MAP_HEIGHT_PX));
 
-	// Set the level to level 1 and the game_screen to PLAYING.
+	// Set the level to level 1 and the world().game_screen to PLAYING.
 	level = 1;
-	game_screen = GAME_SCREEN_ID::PLAYING;
+	world().game_screen = GAME_SCREEN_ID::PLAYING;
 
 	// Kung: This is for Milestone #2. This creates the farmland.
 	parseMap(false);
@@ -491,15 +545,25 @@ void WorldSystem::restart_game()
 	spawn_manager.start_game();
 }
 
+void WorldSystem::start_game(int day)
+{
+	// the background the intro leaves behind
+	registry().screenStates.components[0].cutscene = 1;
+	restart_game();
+	world().current_day = day;
+	spawn_manager.set_day(day);
+	enemies_to_spawn_today = calculate_enemies_for_day(day);
+}
+
 // Reset the world state to the tutorial mode state
 void WorldSystem::restart_tutorial()
 {
 	std::cout << "Restarting tutorial..." << std::endl;
 	clearButtons();
 	restart_common_tasks(vec2(TUTORIAL_WIDTH_PX, TUTORIAL_HEIGHT_PX));
-	// Set the level to level 0 (non-existent) and the game_screen to TUTORIAL.
+	// Set the level to level 0 (non-existent) and the world().game_screen to TUTORIAL.
 	level = 0;
-	game_screen = GAME_SCREEN_ID::TUTORIAL;
+	world().game_screen = GAME_SCREEN_ID::TUTORIAL;
 
 	// Kung: This is for Milestone #2. This creates the farmland.
 	parseMap(true);
@@ -557,11 +621,11 @@ void WorldSystem::check_tutorial_enemies()
 	bool skeleton_exists = false;
 
 	// Check if tutorial zombie exists
-	for (Entity zombie : registry.zombies.entities)
+	for (Entity zombie : registry().zombies.entities)
 	{
-		if (registry.motions.has(zombie))
+		if (registry().motions.has(zombie))
 		{
-			Motion &motion = registry.motions.get(zombie);
+			Motion &motion = registry().motions.get(zombie);
 
 			zombie_exists = true;
 			// Keep zombie in place by setting velocity to zero
@@ -570,11 +634,11 @@ void WorldSystem::check_tutorial_enemies()
 	}
 
 	// Check if tutorial skeleton exists
-	for (Entity entity : registry.skeletons.entities)
+	for (Entity entity : registry().skeletons.entities)
 	{
-		if (registry.motions.has(entity))
+		if (registry().motions.has(entity))
 		{
-			Motion &motion = registry.motions.get(entity);
+			Motion &motion = registry().motions.get(entity);
 
 			skeleton_exists = true;
 			// Keep skeleton in place by setting velocity to zero
@@ -592,31 +656,31 @@ bool WorldSystem::is_over() const
 // Helper function to increase the level automatically if the conditions are met.
 void WorldSystem::increase_level()
 {
-	Entity player_entity = registry.players.entities[0];
+	Entity player_entity = registry().players.entities[0];
 	// Kung: If the bar is full, reset the player experience bar and upgrade the user level.
-	if (registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage >= 1.0)
+	if (registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage >= 1.0)
 	{
-		if (registry.inventorys.components[0].seedCount[current_seed] == 0)
+		if (registry().inventorys.components[0].seedCount[current_seed] == 0)
 		{
-			registry.inventorys.components[0].seedAtToolbar[current_seed] == -1;
-			createSeedInventory(vec2(registry.motions.get(player_entity).position.x + (current_seed - 4) * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2, registry.motions.get(player_entity).position.y + CAMERA_VIEW_HEIGHT * 0.45), registry.motions.get(player_entity).velocity, current_seed, 0);
+			registry().inventorys.components[0].seedAtToolbar[current_seed] == -1;
+			createSeedInventory(vec2(registry().motions.get(player_entity).position.x + (current_seed - 4) * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2, registry().motions.get(player_entity).position.y + CAMERA_VIEW_HEIGHT * 0.45), registry().motions.get(player_entity).velocity, current_seed, 0);
 		}
-		registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage = 0.0;
+		registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage = 0.0;
 		level++;
 
-		vec2 player_pos = registry.motions.get(player_entity).position;
-		vec2 player_size = registry.motions.get(player_entity).scale;
+		vec2 player_pos = registry().motions.get(player_entity).position;
+		vec2 player_size = registry().motions.get(player_entity).scale;
 		ParticleSystem::createLevelUpEffect(player_pos, player_size);
 
-		game_screen = GAME_SCREEN_ID::LEVEL_UP;
+		world().game_screen = GAME_SCREEN_ID::LEVEL_UP;
 		std::set<int> unique_numbers;
 		bool buttonsCreated = false;
 		return levelUpHelper(unique_numbers, buttonsCreated); // increment the seed count of the selected seed
 	}
-	else if (level == 2 && registry.screenStates.components[0].cutscene != 3)
+	else if (level == 2 && registry().screenStates.components[0].cutscene != 3)
 	{
-		registry.screenStates.components[0].cutscene = 3;
-		registry.screenStates.components[0].cg_index = 0;
+		registry().screenStates.components[0].cutscene = 3;
+		registry().screenStates.components[0].cg_index = 0;
 		return start_cg(renderer);
 	}
 }
@@ -624,10 +688,10 @@ void WorldSystem::increase_level()
 // Helper function to make it easier to increase experience
 void WorldSystem::increase_exp()
 {
-	Entity player_entity = registry.players.entities[0];
-	if (registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage < 1.0)
+	Entity player_entity = registry().players.entities[0];
+	if (registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage < 1.0)
 	{
-		registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage += registry.attacks.get(player_entity).damage / PLAYER_HEALTH;
+		registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage += registry().attacks.get(player_entity).damage / PLAYER_HEALTH;
 	}
 }
 
@@ -639,13 +703,13 @@ void WorldSystem::increment_points()
 // Helper function to handle what happens when the player does a mouse click
 void WorldSystem::player_attack()
 {
-	Entity player = registry.players.entities[0];
-	if (!registry.cooldowns.has(player) && PlayerSystem::get_state() != STATE::ATTACK)
+	Entity player = registry().players.entities[0];
+	if (!registry().cooldowns.has(player) && PlayerSystem::get_state() != STATE::ATTACK)
 	{
 		// Play the sword attack sound
 		Mix_PlayChannel(3, sword_attack_sound, 0);
 
-		Motion &player_motion = registry.motions.get(registry.players.entities[0]);
+		Motion &player_motion = registry().motions.get(registry().players.entities[0]);
 
 		// Calculate attack direction based on mouse position
 		// Convert mouse position to world coordinates
@@ -659,10 +723,11 @@ void WorldSystem::player_attack()
 		if (attack_direction.x != 0)
 		{
 			player_motion.scale.x = (attack_direction.x > 0) ? abs(player_motion.scale.x) : -abs(player_motion.scale.x);
+			registry().motions.mark_changed(player);
 		}
 
 		// Calculate attack position based on direction and range
-		vec2 attack_position = player_motion.position + attack_direction * static_cast<float>(registry.attacks.get(player).range);
+		vec2 attack_position = player_motion.position + attack_direction * static_cast<float>(registry().attacks.get(player).range);
 
 		// Create weapon motion at the attack position
 		Motion weapon_motion = Motion();
@@ -671,20 +736,40 @@ void WorldSystem::player_attack()
 		weapon_motion.velocity = player_motion.velocity;
 		weapon_motion.scale = player_motion.scale;
 
-		// Check for collisions with enemies
-		for (int i = 0; i < registry.enemies.size(); i++)
-		{
-			if (PhysicsSystem::collides(weapon_motion, registry.motions.get(registry.enemies.entities[i])) // if enemy and weapon collide, decrease enemy health
-				|| PhysicsSystem::collides(player_motion, registry.motions.get(registry.enemies.entities[i])))
+		// Check for collisions with enemies. This runs between steps, so the grid first picks up
+		// the enemies spawned since the last one
+		SpatialGrid &enemy_grid = world().enemy_grid;
+		enemy_grid.build(registry().enemies.entities, registry().motions);
+		float reach = length(abs(player_motion.scale) / 2.f);
+		attack_targets.clear();
+		enemy_grid.query_radius(weapon_motion.position, reach, attack_targets);
+		enemy_grid.query_radius(player_motion.position, reach, attack_targets);
+		order_like(registry().enemies, attack_targets, attack_order);
+		// an enemy near both circles was found twice, and now sits next to itself
+		attack_targets.erase(std::unique(attack_targets.begin(), attack_targets.end(),
+										 [](Entity a, Entity b) { return a.id() == b.id(); }),
+							 attack_targets.end());
+		// if an enemy collides with the weapon or the player, decrease its health
+		attack_batch.clear();
+		for (Entity enemy : attack_targets)
+			attack_batch.push(enemy, registry().motions.get(enemy));
+		batch_circles_overlap(attack_batch, weapon_motion);
+		weapon_hits = attack_batch.hits;
+		batch_circles_overlap(attack_batch, player_motion);
+		for (size_t w = 0; w < weapon_hits.size(); w++)
+			attack_batch.hits[w] |= weapon_hits[w];
+		for (size_t i = 0; i < attack_batch.size(); i++)
+		{
+			Entity enemy = attack_batch.entities[i];
+			if (attack_batch.hit(i))
 			{
-				Entity enemy = registry.enemies.entities[i];
-				if (registry.enemies.has(enemy))
+				if (registry().enemies.has(enemy))
 				{
-					auto &enemy_comp = registry.enemies.get(enemy);
-					enemy_comp.health -= registry.attacks.get(player).damage;
+					auto &enemy_comp = registry().enemies.get(enemy);
+					enemy_comp.health -= registry().attacks.get(player).damage;
 
 					// Calculate knockback direction (from player to enemy)
-					Motion &enemy_motion = registry.motions.get(enemy);
+					Motion &enemy_motion = registry().motions.get(enemy);
 					vec2 direction = enemy_motion.position - player_motion.position;
 					float length = sqrt(dot(direction, direction));
 					if (length > 0)
@@ -697,21 +782,21 @@ void WorldSystem::player_attack()
 					enemy_motion.velocity += direction * knockback_force;
 
 					// Add hit effect
-					HitEffect &hit = registry.hitEffects.emplace_with_duplicates(enemy);
+					HitEffect &hit = registry().hitEffects.emplace_with_duplicates(enemy);
 
 					vec2 sprite_size = {50.0f, 50.0f}; // Default fallback size
-					sprite_size = registry.motions.get(enemy).scale;
+					sprite_size = registry().motions.get(enemy).scale;
 					// Create blood effect
-					ParticleSystem::createBloodEffect(registry.motions.get(enemy).position, sprite_size);
+					ParticleSystem::createBloodEffect(registry().motions.get(enemy).position, sprite_size);
 
 					// This is what you do when you kill a enemy.
-					if (enemy_comp.health <= 0 && !registry.deathAnimations.has(enemy))
+					if (enemy_comp.health <= 0 && !registry().deathAnimations.has(enemy))
 					{
 						// Add death animation before removing
 						vec2 slide_direction = attack_direction; // Use attack direction for death animation
 
 						// Add death animation component
-						DeathAnimation &death_anim = registry.deathAnimations.emplace(enemy);
+						DeathAnimation &death_anim = registry().deathAnimations.emplace(enemy);
 						death_anim.slide_direction = slide_direction;
 						death_anim.alpha = 1.0f;
 						death_anim.duration_ms = 500.0f; // Animation lasts 0.5 seconds
@@ -730,11 +815,11 @@ void WorldSystem::player_attack()
 		PlayerSystem::update_state(STATE::ATTACK);
 
 		// Cooldown
-		if (registry.cooldowns.has(player))
+		if (registry().cooldowns.has(player))
 		{
-			registry.cooldowns.remove(player);
+			registry().cooldowns.remove(player);
 		}
-		Cooldown &cooldown = registry.cooldowns.emplace(player);
+		Cooldown &cooldown = registry().cooldowns.emplace(player);
 		cooldown.timer_ms = COOLDOWN_PLAYER_ATTACK;
 	}
 }
@@ -742,18 +827,18 @@ void WorldSystem::player_attack()
 void WorldSystem::update_enemy_death_animations(float elapsed_ms)
 {
 	// Process each entity with a death animation
-	for (Entity entity : registry.deathAnimations.entities)
+	for (Entity entity : registry().deathAnimations.entities)
 	{
-		auto &death_anim = registry.deathAnimations.get(entity);
+		auto &death_anim = registry().deathAnimations.get(entity);
 
 		// Update alpha
 		death_anim.duration_ms -= elapsed_ms;
 		death_anim.alpha = death_anim.duration_ms / 500.0f; // Linear fade out
 
 		// Update position with increased slide speed and distance
-		if (registry.motions.has(entity))
+		if (registry().motions.has(entity))
 		{
-			auto &motion = registry.motions.get(entity);
+			auto &motion = registry().motions.modify(entity);
 			float slide_speed = 300.0f; // pixels per second
 
 			// Calculate movement
@@ -767,14 +852,14 @@ void WorldSystem::update_enemy_death_animations(float elapsed_ms)
 		// Remove entity when animation is complete
 		if (death_anim.duration_ms <= 0)
 		{
-			registry.remove_all_components_of(entity);
+			registry().remove_all_components_of(entity);
 		}
 	}
 }
 
 void WorldSystem::update_screen_shake(float elapsed_ms)
 {
-	auto &screen = registry.screenStates.get(registry.screenStates.entities[0]);
+	auto &screen = registry().screenStates.get(registry().screenStates.entities[0]);
 	if (screen.shake_duration_ms > 0)
 	{
 		screen.shake_duration_ms -= elapsed_ms;
@@ -782,8 +867,8 @@ void WorldSystem::update_screen_shake(float elapsed_ms)
 		// Calculate random shake offset
 		float intensity = screen.shake_intensity * (screen.shake_duration_ms / 200.0f);
 		screen.shake_offset = {
-			((rand() % 100) / 50.0f - 1.0f) * intensity,
-			((rand() % 100) / 50.0f - 1.0f) * intensity};
+			rng(RandomStream::WORLD).uniform(-1.0f, 1.0f) * intensity,
+			rng(RandomStream::WORLD).uniform(-1.0f, 1.0f) * intensity};
 
 		if (screen.shake_duration_ms <= 0)
 		{
@@ -805,18 +890,18 @@ void WorldSystem::player_movement(int key, int action, Motion &player_motion)
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_A)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_A)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_LEFT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_LEFT_SPEED;
 			}
 		}
 	}
@@ -826,18 +911,18 @@ void WorldSystem::player_movement(int key, int action, Motion &player_motion)
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_D)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_D)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_RIGHT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_RIGHT_SPEED;
 			}
 		}
 	}
@@ -847,18 +932,18 @@ void WorldSystem::player_movement(int key, int action, Motion &player_motion)
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_S)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_S)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_DOWN_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_DOWN_SPEED;
 			}
 		}
 	}
@@ -868,18 +953,18 @@ void WorldSystem::player_movement(int key, int action, Motion &player_motion)
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_W)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_W)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_UP_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_UP_SPEED;
 			}
 		}
 	}
@@ -893,18 +978,18 @@ void WorldSystem::player_movement_tutorial(int key, int action, Motion &player_m
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_A)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_LEFT_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_A)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_LEFT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_LEFT_SPEED;
 			}
 		}
 	}
@@ -914,18 +999,18 @@ void WorldSystem::player_movement_tutorial(int key, int action, Motion &player_m
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_D)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x += PLAYER_MOVE_RIGHT_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_D)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_RIGHT_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.x -= PLAYER_MOVE_RIGHT_SPEED;
 			}
 		}
 	}
@@ -935,18 +1020,18 @@ void WorldSystem::player_movement_tutorial(int key, int action, Motion &player_m
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_S)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_DOWN_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_S)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_DOWN_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_DOWN_SPEED;
 			}
 		}
 	}
@@ -956,18 +1041,18 @@ void WorldSystem::player_movement_tutorial(int key, int action, Motion &player_m
 	{
 		if (action == GLFW_PRESS && key == GLFW_KEY_W)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y += PLAYER_MOVE_UP_SPEED;
 			}
 		}
 		else if (action == GLFW_RELEASE && key == GLFW_KEY_W)
 		{
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
-					registry.motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_UP_SPEED;
+				if (registry().motions.has(mwc_entity))
+					registry().motions.get(mwc_entity).velocity.y -= PLAYER_MOVE_UP_SPEED;
 			}
 		}
 	}
@@ -982,6 +1067,24 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 		return;
 	}
 
+	// F9 starts recording a profile, and the next F9 writes it to data/profile_trace.json
+	// (open it in chrome://tracing or ui.perfetto.dev)
+	if (action == GLFW_RELEASE && key == GLFW_KEY_F9)
+	{
+		if (Profiler::is_recording())
+		{
+			Profiler::stop();
+			Profiler::write_chrome_trace(data_path() + "/profile_trace.json");
+		}
+		else
+		{
+			Profiler::clear();
+			Profiler::start();
+			std::cout << "Recording a profile, press F9 again to write it" << std::endl;
+		}
+		return;
+	}
+
 	// Resetting game with the 'R' button
 	if (action == GLFW_RELEASE && key == GLFW_KEY_R)
 	{
@@ -1009,22 +1112,22 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	// Debug
 	if (action == GLFW_PRESS && key == GLFW_KEY_L)
 	{
-		registry.list_all_components();
+		registry().list_all_components();
 	}
 
-	if (game_screen == GAME_SCREEN_ID::SPLASH || game_screen == GAME_SCREEN_ID::CG)
+	if (world().game_screen == GAME_SCREEN_ID::SPLASH || world().game_screen == GAME_SCREEN_ID::CG)
 	{
 		// implement
 		return;
 	}
 
 	// when player is in the level up menu, disable some game inputs
-	if (game_is_over)
+	if (world().game_is_over)
 		return;
 
 	// Player movement
-	Entity player = registry.players.entities[0];
-	Motion &motion = registry.motions.get(player);
+	Entity player = registry().players.entities[0];
+	Motion &motion = registry().motions.get(player);
 
 	// Manual wave generation with 'g'
 	if (action == GLFW_PRESS && key == GLFW_KEY_G)
@@ -1037,16 +1140,16 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	if (action == GLFW_PRESS && key == GLFW_KEY_SLASH)
 	{
 		// Disable in tutorial mode
-		if (game_screen == GAME_SCREEN_ID::PLAYING || game_screen == GAME_SCREEN_ID::TEST)
+		if (world().game_screen == GAME_SCREEN_ID::PLAYING || world().game_screen == GAME_SCREEN_ID::TEST)
 		{
 			test_mode = !test_mode;
 			spawn_manager.set_test_mode(test_mode);
-			if (game_screen == GAME_SCREEN_ID::PLAYING)
+			if (world().game_screen == GAME_SCREEN_ID::PLAYING)
 			{
-				game_screen = GAME_SCREEN_ID::TEST;
+				world().game_screen = GAME_SCREEN_ID::TEST;
 			}
 			else
-				game_screen = GAME_SCREEN_ID::PLAYING;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
 			std::cout << "Game " << (test_mode ? "entered" : "exited") << " test mode" << std::endl;
 		}
 		return;
@@ -1058,7 +1161,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 		tutorial_mode = !tutorial_mode;
 		spawn_manager.set_test_mode(tutorial_mode);
 
-		if (game_screen != GAME_SCREEN_ID::TUTORIAL)
+		if (world().game_screen != GAME_SCREEN_ID::TUTORIAL)
 		{
 			restart_tutorial();
 		}
@@ -1073,8 +1176,8 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	if (action == GLFW_PRESS && key == GLFW_KEY_E)
 	{
 		// Get player position for start point
-		Entity player = registry.players.entities[0];
-		Motion &motion = registry.motions.get(player);
+		Entity player = registry().players.entities[0];
+		Motion &motion = registry().motions.get(player);
 		vec2 start_point = motion.position;
 
 		// Calculate end point in direction of mouse cursor
@@ -1100,7 +1203,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	}
 
 	// Kung: Helper function for player movement (see above for description)
-	if (game_screen == GAME_SCREEN_ID::TUTORIAL)
+	if (world().game_screen == GAME_SCREEN_ID::TUTORIAL)
 	{
 		player_movement_tutorial(key, action, motion);
 	}
@@ -1110,11 +1213,11 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	}
 
 	// Add this case in the on_key function where other key inputs are handled
-	if (action == GLFW_PRESS && key == GLFW_KEY_SPACE && !player_is_dashing && dash_cooldown_ms <= 0.0f)
+	if (action == GLFW_PRESS && key == GLFW_KEY_SPACE && !world().player_is_dashing && dash_cooldown_ms <= 0.0f)
 	{
 		// Get player entity and motion
-		Entity player = registry.players.entities[0];
-		Motion &motion = registry.motions.get(player);
+		Entity player = registry().players.entities[0];
+		Motion &motion = registry().motions.get(player);
 
 		// Determine dash direction - use current movement direction or facing direction if not moving
 		dash_direction = motion.velocity;
@@ -1130,15 +1233,15 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 		}
 
 		// Start the dash
-		player_is_dashing = true;
+		world().player_is_dashing = true;
 		dash_timer_ms = PLAYER_DASH_DURATION_MS;
 
 		// Apply the dash velocity to all moveWithCamera entities
-		for (Entity mwc_entity : registry.moveWithCameras.entities)
+		for (Entity mwc_entity : registry().moveWithCameras.entities)
 		{
-			if (registry.motions.has(mwc_entity))
+			if (registry().motions.has(mwc_entity))
 			{
-				Motion &mwc_motion = registry.motions.get(mwc_entity);
+				Motion &mwc_motion = registry().motions.get(mwc_entity);
 
 				// Calculate dash velocity based on direction and speed
 				vec2 dash_velocity = dash_direction * PLAYER_DASH_SPEED_MULTIPLIER;
@@ -1161,7 +1264,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	}
 
 	// Player movement sound
-	if (!WorldSystem::game_is_over)
+	if (!world().game_is_over)
 	{
 
 		if ((action == GLFW_PRESS || action == GLFW_REPEAT) &&
@@ -1195,11 +1298,11 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	if (action == GLFW_PRESS && key == GLFW_KEY_H)
 	{
 		// Get player entity
-		Entity player = registry.players.entities[0];
+		Entity player = registry().players.entities[0];
 		// Set player health to a very high value
-		registry.players.get(player).health = 999999999;
+		registry().players.get(player).health = 999999999;
 		// Also set health bar to 100%
-		registry.screenStates.get(registry.screenStates.entities[0]).hp_percentage = 1.0;
+		registry().screenStates.get(registry().screenStates.entities[0]).hp_percentage = 1.0;
 		std::cout << "CHEAT ACTIVATED: Player health set to 999999999" << std::endl;
 	}
 
@@ -1207,7 +1310,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	if (action == GLFW_PRESS && key == GLFW_KEY_B)
 	{
 		// Debug key to start challenge
-		current_day = 5;
+		world().current_day = 5;
 	}
 
 	if (action == GLFW_PRESS)
@@ -1220,34 +1323,34 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 
 	if (action == GLFW_PRESS && key == GLFW_KEY_9)
 	{
-		if (registry.screenStates.size() != 0)
+		if (registry().screenStates.size() != 0)
 		{
-			if (registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage >= 1.0)
+			if (registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage >= 1.0)
 			{
 				// come back later!
-				if (registry.inventorys.components[0].seedCount[current_seed] == 0)
+				if (registry().inventorys.components[0].seedCount[current_seed] == 0)
 				{
 					createSeedInventory(vec2(motion.position.x + (current_seed - 4) * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2, motion.position.y + CAMERA_VIEW_HEIGHT * 0.45), motion.velocity, current_seed, 0);
 				}
-				registry.inventorys.components[0].seedCount[current_seed]++; // increment the seed count
-				registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage = 0.0;
+				registry().inventorys.components[0].seedCount[current_seed]++; // increment the seed count
+				registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage = 0.0;
 				level++;
 
 				// Get player entity and size
-				Entity player = registry.players.entities[0];
-				vec2 player_pos = registry.motions.get(player).position;
-				vec2 player_size = registry.motions.get(player).scale;
+				Entity player = registry().players.entities[0];
+				vec2 player_pos = registry().motions.get(player).position;
+				vec2 player_size = registry().motions.get(player).scale;
 				ParticleSystem::createLevelUpEffect(player_pos, player_size);
 				if (level == 2)
 				{
-					registry.screenStates.components[0].cutscene = 3;
-					registry.screenStates.components[0].cg_index = 0;
+					registry().screenStates.components[0].cutscene = 3;
+					registry().screenStates.components[0].cg_index = 0;
 					return start_cg(renderer);
 				}
 			}
 			else
 			{
-				registry.screenStates.get(registry.screenStates.entities[0]).exp_percentage += 0.1;
+				registry().screenStates.get(registry().screenStates.entities[0]).exp_percentage += 0.1;
 			}
 		}
 	}
@@ -1255,49 +1358,49 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 	{
 		// Debug key to start challenge
 		current_seed = 0;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x - 4 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x - 4 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_2)
 	{
 		// Debug key to start challenge
 		current_seed = 1;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x - 3 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x - 3 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_3)
 	{
 		// Debug key to start challenge
 		current_seed = 2;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x - 2 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x - 2 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_4)
 	{
 		// Debug key to start challenge
 		current_seed = 3;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x - 1 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x - 1 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_5)
 	{
 		// Debug key to start challenge
 		current_seed = 4;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x - 0 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x - 0 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_6)
 	{
 		// Debug key to start challenge
 		current_seed = 5;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x + 1 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x + 1 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_7)
 	{
 		// Debug key to start challenge
 		current_seed = 6;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x + 2 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x + 2 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 	if (action == GLFW_PRESS && key == GLFW_KEY_8)
 	{
 		// Debug key to start challenge
 		current_seed = 7;
-		registry.motions.get(registry.toolbars.entities[1]).position.x = registry.motions.get(registry.toolbars.entities[0]).position.x + 3 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
+		registry().motions.modify(registry().toolbars.entities[1]).position.x = registry().motions.get(registry().toolbars.entities[0]).position.x + 3 * TOOLBAR_WIDTH / 8 + TOOLBAR_HEIGHT / 2;
 	}
 }
 
@@ -1307,55 +1410,55 @@ void WorldSystem::on_mouse_move(vec2 mouse_position)
 	mouse_pos_x = mouse_position.x;
 	mouse_pos_y = mouse_position.y;
 
-	if (game_screen == GAME_SCREEN_ID::SPLASH || game_screen == GAME_SCREEN_ID::CG)
+	if (world().game_screen == GAME_SCREEN_ID::SPLASH || world().game_screen == GAME_SCREEN_ID::CG)
 	{
 		return;
 	}
 
-	if (game_is_over)
+	if (world().game_is_over)
 		return;
 
 	// change player facing direction
-	Entity player = registry.players.entities[0];
-	Motion &motion = registry.motions.get(player);
+	Entity player = registry().players.entities[0];
+	Motion &motion = registry().motions.get(player);
 
 	// face left
 	if (mouse_pos_x < WINDOW_WIDTH_PX / 2 && motion.scale.x > 0)
 	{
 		motion.scale.x = -motion.scale.x;
+		registry().motions.mark_changed(player);
 	}
 
 	// face right
 	if (mouse_pos_x > WINDOW_WIDTH_PX / 2 && motion.scale.x < 0)
 	{
 		motion.scale.x = -motion.scale.x;
+		registry().motions.mark_changed(player);
 	}
 }
 
 void WorldSystem::clearButtons()
 {
-	for (int i = registry.cgs.entities.size() - 1; i >= 0; i--)
+	for (int i = registry().cgs.entities.size() - 1; i >= 0; i--)
 	{
-		Entity e = registry.cgs.entities[i];
-		registry.remove_all_components_of(e);
+		Entity e = registry().cgs.entities[i];
+		registry().remove_all_components_of(e);
 	}
 }
 
 void WorldSystem::levelUpHelper(std::set<int> unique_numbers, bool buttonsCreated)
 {
 	std::cout << "Level up helper called" << std::endl;
-	std::mt19937 rng(time(0));					   // Initialize random number generator with current time
-	std::uniform_int_distribution<int> dist(1, 7); // Distribution between 1 and 8
 	clearButtons();
-	Entity &player = registry.players.entities[0];
-	vec2 player_pos = registry.motions.get(player).position;
+	Entity &player = registry().players.entities[0];
+	vec2 player_pos = registry().motions.get(player).position;
 	createPausePanel(renderer, vec2(player_pos.x, player_pos.y));
 	buttonsCreated = true;
 
 	// Generate unique random numbers
 	while (unique_numbers.size() < 4)
 	{
-		int num = dist(rng);		// Generate a random number
+		int num = 1 + rng(RandomStream::LEVEL_UP).below(7); // Generate a random number between 1 and 7
 		unique_numbers.insert(num); // Insert into set (duplicates are automatically handled)
 	}
 	std::vector<int> unique_numbers_vec(unique_numbers.begin(), unique_numbers.end());
@@ -1371,23 +1474,23 @@ void WorldSystem::levelUpHelper(std::set<int> unique_numbers, bool buttonsCreate
 	for (int i = 0; i < unique_numbers.size(); i++)
 	{
 		// 	int what;
-		// 			Entity mwc_entity = registry.moveWithCameras.entities[0];
+		// 			Entity mwc_entity = registry().moveWithCameras.entities[0];
 		// {
-		// 	if (registry.motions.has(mwc_entity))
-		// 	what =  405;//registry.motions.get(mwc_entity).position.y;
+		// 	if (registry().motions.has(mwc_entity))
+		// 	what =  405;//registry().motions.get(mwc_entity).position.y;
 		// }
-		// vec2 player_pos = registry.cameras.components[0].position;
+		// vec2 player_pos = registry().cameras.components[0].position;
 		// std::cout << "what" << what << std::endl;
 		int x_pos = player_pos.x - WINDOW_WIDTH_PX / 4 +  offset ;
 		int y_pos = player_pos.y + 100;
 		// if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		// 	int y_pos = player_pos.y +100 - registry.motions.get(player).velocity.y;
+		// 	int y_pos = player_pos.y +100 - registry().motions.get(player).velocity.y;
 		// if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		// 	int y_pos = player_pos.y +100 + registry.motions.get(player).velocity.y;
+		// 	int y_pos = player_pos.y +100 + registry().motions.get(player).velocity.y;
 		// if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		// 	int y_pos = player_pos.y +100 + registry.motions.get(player).velocity.y;
+		// 	int y_pos = player_pos.y +100 + registry().motions.get(player).velocity.y;
 		// if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		// 	int y_pos = player_pos.y +100 + registry.motions.get(player).velocity.y;
+		// 	int y_pos = player_pos.y +100 + registry().motions.get(player).velocity.y;
 		switch (unique_numbers_vec[i])
 		{
 		case 1:
@@ -1424,16 +1527,16 @@ void WorldSystem::levelUpHelper(std::set<int> unique_numbers, bool buttonsCreate
 
 bool WorldSystem::detectButtons()
 {
-	if (game_screen == GAME_SCREEN_ID::LEVEL_UP)
+	if (world().game_screen == GAME_SCREEN_ID::LEVEL_UP)
 	{
 		//  std::set<int> unique_numbers;
 		//  bool buttonsCreated = false;
 		// levelUpHelper(renderer, unique_numbers, buttonsCreated);
 		// if (buttonsCreated) {
-		// 	game_screen = GAME_SCREEN_ID::LEVEL_UP;
+		// 	world().game_screen = GAME_SCREEN_ID::LEVEL_UP;
 		// 	return true;
 		// } else {
-		for (auto &b : registry.buttons.components)
+		for (auto &b : registry().buttons.components)
 		{
 			std::cout << "x " << b.position.x - 40 << " " << b.position.x + 40 << std::endl;
 			std::cout << "y " << b.position.y - 40 << " " << b.position.y + 40 << std::endl;
@@ -1443,57 +1546,57 @@ bool WorldSystem::detectButtons()
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED1)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[0]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[0]++;
 					std::cout << "Seed 1 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED2)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[1]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[1]++;
 					std::cout << "Seed 2 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED3)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[2]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[2]++;
 					std::cout << "Seed 3 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED4)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[3]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[3]++;
 					std::cout << "Seed 4 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED5)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[4]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[4]++;
 					std::cout << "Seed 5 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED6)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[5]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[5]++;
 					std::cout << "Seed 6 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED7)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[6]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[6]++;
 					std::cout << "Seed 7 selected" << std::endl;
 				}
 				if (b.type == BUTTON_ID::LEVEL_UP_SEED8)
 				{
 					clearButtons();
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					registry.inventorys.components[0].seedCount[7]++;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					registry().inventorys.components[0].seedCount[7]++;
 					std::cout << "Seed 8 selected" << std::endl;
 				}
 				return true;
@@ -1502,7 +1605,7 @@ bool WorldSystem::detectButtons()
 		return true;
 	}
 	// return to splash screen
-	if (game_screen == GAME_SCREEN_ID::TUTORIAL)
+	if (world().game_screen == GAME_SCREEN_ID::TUTORIAL)
 	{
 		if (mouse_pos_x >= 0 && mouse_pos_x <= 60 && mouse_pos_y >= 0 && mouse_pos_y <= 60)
 		{
@@ -1510,19 +1613,19 @@ bool WorldSystem::detectButtons()
 			return true;
 		}
 	}
-	for (auto &b : registry.buttons.components)
+	for (auto &b : registry().buttons.components)
 	{
-		if (game_screen == GAME_SCREEN_ID::PLAYING)
+		if (world().game_screen == GAME_SCREEN_ID::PLAYING)
 		{
 
 			if (mouse_pos_x >= b.position.x - 30 && mouse_pos_x <= b.position.x + 30 &&
 				mouse_pos_y >= b.position.y - 30 && mouse_pos_y <= b.position.y + 30)
 			{
-				if (game_screen == GAME_SCREEN_ID::PLAYING && b.type == BUTTON_ID::PAUSE)
+				if (world().game_screen == GAME_SCREEN_ID::PLAYING && b.type == BUTTON_ID::PAUSE)
 				{
-					game_screen = GAME_SCREEN_ID::PAUSE;
-					Entity &player = registry.players.entities[0];
-					vec2 player_pos = registry.motions.get(player).position;
+					world().game_screen = GAME_SCREEN_ID::PAUSE;
+					Entity &player = registry().players.entities[0];
+					vec2 player_pos = registry().motions.get(player).position;
 					createPausePanel(renderer, vec2(player_pos.x, player_pos.y));
 					createButton(renderer, BUTTON_ID::RESUME, vec2(player_pos.x, player_pos.y - WINDOW_HEIGHT_PX / 4 + 100 * OS_RES), vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2 - WINDOW_HEIGHT_PX / 4 + 100 * OS_RES - BUTTON_SPLASH_HEIGHT * OS_RES / 2), 0.8);
 					createButton(renderer, BUTTON_ID::LOAD, vec2(player_pos.x, player_pos.y - WINDOW_HEIGHT_PX / 4 + 200 * OS_RES), vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2 - WINDOW_HEIGHT_PX / 4 + 200 * OS_RES), 0.8);
@@ -1530,11 +1633,11 @@ bool WorldSystem::detectButtons()
 					createButton(renderer, BUTTON_ID::QUIT, vec2(player_pos.x, player_pos.y - WINDOW_HEIGHT_PX / 4 + 400 * OS_RES), vec2(WINDOW_WIDTH_PX / 2, WINDOW_HEIGHT_PX / 2 - WINDOW_HEIGHT_PX / 4 + 400 * OS_RES), 0.8);
 					return true;
 				}
-				else if (game_screen == GAME_SCREEN_ID::PAUSE && b.type == BUTTON_ID::PAUSE)
+				else if (world().game_screen == GAME_SCREEN_ID::PAUSE && b.type == BUTTON_ID::PAUSE)
 				{
-					game_screen = GAME_SCREEN_ID::PLAYING;
-					Entity &player_entity = registry.players.entities[0];
-					vec2 player_pos = registry.motions.get(player_entity).position;
+					world().game_screen = GAME_SCREEN_ID::PLAYING;
+					Entity &player_entity = registry().players.entities[0];
+					vec2 player_pos = registry().motions.get(player_entity).position;
 					clearButtons();
 					createPause(vec2(player_pos.x - CAMERA_VIEW_WIDTH / 2 + 30, player_pos.y - CAMERA_VIEW_HEIGHT / 2 + 30), BUTTON_ID::PAUSE);
 					return true;
@@ -1546,14 +1649,14 @@ bool WorldSystem::detectButtons()
 		{
 			if (b.type == BUTTON_ID::START)
 			{
-				registry.screenStates.components[0].cutscene = 1;
-				registry.screenStates.components[0].cg_index = 0;
+				registry().screenStates.components[0].cutscene = 1;
+				registry().screenStates.components[0].cg_index = 0;
 				start_cg(renderer);
 			}
 			if (b.type == BUTTON_ID::LOAD)
 			{
 				loadGame();
-				game_screen = GAME_SCREEN_ID::PLAYING;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
 			}
 			else if (b.type == BUTTON_ID::TUTORIAL)
 			{
@@ -1563,28 +1666,28 @@ bool WorldSystem::detectButtons()
 			else if (b.type == BUTTON_ID::QUIT)
 			{
 
-				if (game_screen == GAME_SCREEN_ID::SPLASH)
+				if (world().game_screen == GAME_SCREEN_ID::SPLASH)
 				{
 					close_window();
 				}
 				else
 				{
-					game_screen = GAME_SCREEN_ID::SPLASH;
+					world().game_screen = GAME_SCREEN_ID::SPLASH;
 					restart_splash_screen();
 				}
 			}
 			else if (b.type == BUTTON_ID::SAVE)
 			{
-				game_screen == GAME_SCREEN_ID::PLAYING;
+				world().game_screen == GAME_SCREEN_ID::PLAYING;
 				clearButtons();
 				saveGame();
 				createPause(vec2(30, 30), BUTTON_ID::PAUSE);
 			}
 			else if (b.type == BUTTON_ID::RESUME)
 			{
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				Entity &player_entity = registry.players.entities[0];
-				vec2 player_pos = registry.motions.get(player_entity).position;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				Entity &player_entity = registry().players.entities[0];
+				vec2 player_pos = registry().motions.get(player_entity).position;
 				clearButtons();
 				createPause(vec2(player_pos.x - CAMERA_VIEW_WIDTH / 2 + 30, player_pos.y - CAMERA_VIEW_HEIGHT / 2 + 30), BUTTON_ID::PAUSE);
 			}
@@ -1596,57 +1699,57 @@ bool WorldSystem::detectButtons()
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED1)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[0]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[0]++;
 				std::cout << "Seed 1 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED2)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[1]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[1]++;
 				std::cout << "Seed 2 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED3)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[2]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[2]++;
 				std::cout << "Seed 3 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED4)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[3]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[3]++;
 				std::cout << "Seed 4 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED5)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[4]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[4]++;
 				std::cout << "Seed 5 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED6)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[5]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[5]++;
 				std::cout << "Seed 6 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED7)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[6]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[6]++;
 				std::cout << "Seed 7 selected" << std::endl;
 			}
 			if (b.type == BUTTON_ID::LEVEL_UP_SEED8)
 			{
 				clearButtons();
-				game_screen = GAME_SCREEN_ID::PLAYING;
-				registry.inventorys.components[0].seedCount[7]++;
+				world().game_screen = GAME_SCREEN_ID::PLAYING;
+				registry().inventorys.components[0].seedCount[7]++;
 				std::cout << "Seed 8 selected" << std::endl;
 			}
 			return true;
@@ -1657,7 +1760,7 @@ bool WorldSystem::detectButtons()
 
 void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 {
-	if (game_screen == GAME_SCREEN_ID::SPLASH || game_screen == GAME_SCREEN_ID::PAUSE || game_screen == GAME_SCREEN_ID::LEVEL_UP || game_screen == GAME_SCREEN_ID::GAME_OVER)
+	if (world().game_screen == GAME_SCREEN_ID::SPLASH || world().game_screen == GAME_SCREEN_ID::PAUSE || world().game_screen == GAME_SCREEN_ID::LEVEL_UP || world().game_screen == GAME_SCREEN_ID::GAME_OVER)
 	{
 		if (action == GLFW_RELEASE && action == GLFW_MOUSE_BUTTON_LEFT)
 		{
@@ -1667,16 +1770,16 @@ void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 		}
 	}
 
-	else if (game_screen == GAME_SCREEN_ID::CG)
+	else if (world().game_screen == GAME_SCREEN_ID::CG)
 	{
 		if (action == GLFW_RELEASE && action == GLFW_MOUSE_BUTTON_LEFT)
 		{
-			int cg_index = registry.screenStates.components[0].cg_index++;
-			int cutscene = registry.screenStates.components[0].cutscene;
+			int cg_index = registry().screenStates.components[0].cg_index++;
+			int cutscene = registry().screenStates.components[0].cutscene;
 			if (cutscene == 1 && cg_index == 6)
 			{
-				for (int i = registry.cgs.entities.size() - 1; i >= 0; i--)
-					registry.remove_all_components_of(registry.cgs.entities[i]);
+				for (int i = registry().cgs.entities.size() - 1; i >= 0; i--)
+					registry().remove_all_components_of(registry().cgs.entities[i]);
 				createScreen(TEXTURE_ASSET_ID::DAY_BG);
 				createCharacter(renderer, vec2(WINDOW_WIDTH_PX - 300, WINDOW_HEIGHT_PX - 250), vec2(-500, 500), TEXTURE_ASSET_ID::ORC_WALK2);
 				createCharacter(renderer, vec2(200, WINDOW_HEIGHT_PX - 250), vec2(500, 500), TEXTURE_ASSET_ID::PLAYER_IDLE1);
@@ -1691,8 +1794,8 @@ void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 			}
 			else if (cutscene == 2 && cg_index == 6)
 			{
-				for (int i = registry.cgs.entities.size() - 1; i >= 0; i--)
-					registry.remove_all_components_of(registry.cgs.entities[i]);
+				for (int i = registry().cgs.entities.size() - 1; i >= 0; i--)
+					registry().remove_all_components_of(registry().cgs.entities[i]);
 				set_game_screen(GAME_SCREEN_ID::PLAYING);
 			}
 			else if (cutscene == 3 && cg_index == 0)
@@ -1702,8 +1805,8 @@ void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 			}
 			else if (cutscene == 3 && cg_index == 5)
 			{
-				for (int i = registry.cgs.entities.size() - 1; i >= 0; i--)
-					registry.remove_all_components_of(registry.cgs.entities[i]);
+				for (int i = registry().cgs.entities.size() - 1; i >= 0; i--)
+					registry().remove_all_components_of(registry().cgs.entities[i]);
 				set_game_screen(GAME_SCREEN_ID::PLAYING);
 			}
 		}
@@ -1711,7 +1814,7 @@ void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 		return;
 	}
 
-	else if (!WorldSystem::game_is_over)
+	else if (!world().game_is_over)
 	{
 		// on button press
 		if (action == GLFW_PRESS)
@@ -1738,16 +1841,16 @@ void WorldSystem::on_mouse_button_pressed(int button, int action, int mods)
 
 void WorldSystem::game_over()
 {
-	game_screen = GAME_SCREEN_ID::GAME_OVER;
+	world().game_screen = GAME_SCREEN_ID::GAME_OVER;
 
-	registry.texts.clear();
+	registry().texts.clear();
 	createText("Enemies Killed: " + std::to_string(points), vec2(WINDOW_WIDTH_PX * 0.4, WINDOW_HEIGHT_PX * 0.725), 0.5f, glm::vec3(0.0f, 0.0f, 0.0f));
 	createText("Final level: " + std::to_string(level), vec2(WINDOW_WIDTH_PX * 0.4, WINDOW_HEIGHT_PX * 0.65), 0.5f, glm::vec3(0.0f, 0.0f, 0.0f));
-	createText("Days survived: " + std::to_string(current_day), vec2(WINDOW_WIDTH_PX * 0.4, WINDOW_HEIGHT_PX * 0.575), 0.5f, glm::vec3(0.0f, 0.0f, 0.0f));
+	createText("Days survived: " + std::to_string(world().current_day), vec2(WINDOW_WIDTH_PX * 0.4, WINDOW_HEIGHT_PX * 0.575), 0.5f, glm::vec3(0.0f, 0.0f, 0.0f));
 
 	std::cout << "Game Over!" << std::endl;
-	game_is_over = true;
-	registry.screenStates.get(registry.screenStates.entities[0]).game_over = true;
+	world().game_is_over = true;
+	registry().screenStates.get(registry().screenStates.entities[0]).game_over = true;
 	Mix_HaltMusic();
 	Mix_PlayChannel(0, WorldSystem::game_over_sound, 0);
 	createGameOver();
@@ -1767,10 +1870,10 @@ void WorldSystem::update_movement_sound(float elapsed_ms)
 
 		// If timer expired and player is still moving, restart sound
 		if (movement_sound_timer <= 0 &&
-			!registry.players.entities.empty())
+			!registry().players.entities.empty())
 		{
-			Entity player = registry.players.entities[0];
-			Motion &motion = registry.motions.get(player);
+			Entity player = registry().players.entities[0];
+			Motion &motion = registry().motions.get(player);
 
 			if (motion.velocity.x != 0 || motion.velocity.y != 0)
 			{
@@ -1784,14 +1887,14 @@ void WorldSystem::update_movement_sound(float elapsed_ms)
 void WorldSystem::update_camera()
 {
 	// Update camera position to follow player
-	// std::cout<<registry.players.size()<<" "<<registry.cameras.size()<<std::endl;
-	if (!registry.players.entities.empty() && !registry.cameras.entities.empty())
+	// std::cout<<registry().players.size()<<" "<<registry().cameras.size()<<std::endl;
+	if (!registry().players.entities.empty() && !registry().cameras.entities.empty())
 	{
-		Entity player = registry.players.entities[0];
-		Entity camera = registry.cameras.entities[0];
+		Entity player = registry().players.entities[0];
+		Entity camera = registry().cameras.entities[0];
 
-		Motion &player_motion = registry.motions.get(player);
-		Camera &cam = registry.cameras.get(camera);
+		Motion &player_motion = registry().motions.get(player);
+		Camera &cam = registry().cameras.get(camera);
 
 		// move camera to player position
 		cam.position = player_motion.position;
@@ -1800,14 +1903,15 @@ void WorldSystem::update_camera()
 
 void WorldSystem::advance_to_next_day()
 {
-	current_day++;
-	spawn_manager.set_day(current_day);
-	std::cout << "===== ADVANCING TO DAY " << current_day << " =====" << std::endl;
+	world().current_day++;
+	spawn_manager.set_day(world().current_day);
+	std::cout << "===== ADVANCING TO DAY " << world().current_day << " =====" << std::endl;
 
 	// Calculate number of enemies for the new day with a reasonable progression curve
-	enemies_to_spawn_today = calculate_enemies_for_day(current_day);
+	enemies_to_spawn_today = calculate_enemies_for_day(world().current_day);
 
 	// Reset day stats
+	world().stats.day_ms = 0.f;
 	enemies_spawned_today = 0;
 	day_in_progress = true;
 	enemy_spawn_timer_ms = 0.f;
@@ -1817,7 +1921,7 @@ void WorldSystem::advance_to_next_day()
 
 	// Show day number as text overlay
 	// Could create a temporary text entity here to display day number
-	std::cout << "Day " << current_day << " will have " << enemies_to_spawn_today << " enemies" << std::endl;
+	std::cout << "Day " << world().current_day << " will have " << enemies_to_spawn_today << " enemies" << std::endl;
 }
 
 // Helper function to calculate number of enemies per day
@@ -1851,6 +1955,10 @@ int WorldSystem::calculate_enemies_for_day(int day)
 
 void WorldSystem::updateDayInProgress(float elapsed_ms_since_last_update)
 {
+	GameStats &stats = world().stats;
+	if (day_in_progress || registry().enemies.size() != 0)
+		stats.day_ms += elapsed_ms_since_last_update;
+
 	if (day_in_progress)
 	{
 		// We're still spawning enemies for current day
@@ -1871,19 +1979,21 @@ void WorldSystem::updateDayInProgress(float elapsed_ms_since_last_update)
 			// All enemies for this day have been spawned
 			day_in_progress = false;
 		}
-		if (registry.screenStates.components[0].darken_screen_factor > 0)
-			registry.screenStates.components[0].darken_screen_factor -= elapsed_ms_since_last_update / 3000;
+		if (registry().screenStates.components[0].darken_screen_factor > 0)
+			registry().screenStates.components[0].darken_screen_factor -= elapsed_ms_since_last_update / 3000;
 	}
-	else if (registry.enemies.size() == 0)
+	else if (registry().enemies.size() == 0)
 	{
 		// All enemies are defeated, time for rest period
+		if (rest_timer_ms == 0.f)
+			stats.clear_day(world().current_day);
 		rest_timer_ms += elapsed_ms_since_last_update;
 
 		// Display rest time remaining
 		if (rest_timer_ms < DAY_DELAY_MS)
 		{
-			if (registry.screenStates.components[0].darken_screen_factor < 0.6)
-				registry.screenStates.components[0].darken_screen_factor += elapsed_ms_since_last_update / 3000;
+			if (registry().screenStates.components[0].darken_screen_factor < 0.6)
+				registry().screenStates.components[0].darken_screen_factor += elapsed_ms_since_last_update / 3000;
 			// Optional: Display countdown text
 			float remaining = (DAY_DELAY_MS - rest_timer_ms) / 1000.f;
 			std::cout << "Next day in: " << (int)remaining << " seconds\r" << std::flush;
@@ -1900,20 +2010,20 @@ void WorldSystem::updateDayInProgress(float elapsed_ms_since_last_update)
 
 void WorldSystem::loadGame()
 {
-	registry.clear_all_components();
-	game_screen = GAME_SCREEN_ID::PLAYING;
+	registry().clear_all_components();
+	world().game_screen = GAME_SCREEN_ID::PLAYING;
 	json jsonFile;
 	std::ifstream file(PROJECT_SOURCE_DIR + std::string("data/reload/game_0.json"));
 	file >> jsonFile;
-	game_is_over = jsonFile["game_is_over"];
-	game_screen = jsonFile["game_screen"];
-	current_day = jsonFile["current_day"];
+	world().game_is_over = jsonFile["game_is_over"];
+	world().game_screen = jsonFile["game_screen"];
+	world().current_day = jsonFile["current_day"];
 	current_seed = jsonFile["current_seed"];
 	level = jsonFile["level"];
-	Entity::overrideIDCount((int)jsonFile["id_count"]);
+	registry().entities.overrideIDCount((int)jsonFile["id_count"]);
 
 	json ss_json = jsonFile["0"][0];
-	ScreenState &ss = registry.screenStates.components[0];
+	ScreenState &ss = registry().screenStates.components[0];
 	ss.darken_screen_factor = ss_json["darken_screen_factor"];
 	ss.exp_percentage = ss_json["exp_percentage"];
 	ss.game_over = ss_json["game_over"];
@@ -1934,7 +2044,7 @@ void WorldSystem::loadGame()
 	{
 		json attack_json = attack_arr[i];
 		Entity e = Entity(attack_json["entity"]);
-		Attack &attack = registry.attacks.emplace(e);
+		Attack &attack = registry().attacks.emplace(e);
 		attack.range = attack_json["range"];
 		attack.damage = attack_json["damage"];
 	}
@@ -1944,7 +2054,7 @@ void WorldSystem::loadGame()
 	{
 		json motion = motion_arr[i];
 		Entity e = Entity(motion["entity"]);
-		Motion &m = registry.motions.emplace_with_duplicates(e);
+		Motion &m = registry().motions.emplace_with_duplicates(e);
 		m.position = vec2(motion["position"][0], motion["position"][1]);
 		m.angle = motion["angle"];
 		m.velocity = vec2(0.0, 0.0);
@@ -1957,7 +2067,7 @@ void WorldSystem::loadGame()
 		json collision = collisions_arr[i];
 		Entity e = Entity(collision["entity"].get<int>());
 		Entity other = Entity(collision["other"].get<int>());
-		registry.collisions.emplace(e, other);
+		registry().collisions.emplace_with_duplicates(e, other);
 	}
 
 	// didnt add meshPtrs, maybe add constraints when chicken summoned cannot save lol
@@ -1967,7 +2077,7 @@ void WorldSystem::loadGame()
 	{
 		json dimension_json = dimension_arr[i];
 		Entity e = Entity(dimension_json["entity"]);
-		Dimension &dimension = registry.dimensions.emplace(e);
+		Dimension &dimension = registry().dimensions.emplace(e);
 		dimension.height = dimension_json["height"];
 		dimension.width = dimension_json["width"];
 	}
@@ -1977,7 +2087,7 @@ void WorldSystem::loadGame()
 	{
 		json rr_json = renderRequests_arr[i];
 		Entity e = Entity(rr_json["entity"]);
-		RenderRequest &rr = registry.renderRequests.emplace(e);
+		RenderRequest &rr = registry().renderRequests.emplace(e);
 		rr.used_texture = (TEXTURE_ASSET_ID)rr_json["used_texture"];
 		rr.used_effect = (EFFECT_ASSET_ID)rr_json["used_effect"];
 		rr.used_geometry = (GEOMETRY_BUFFER_ID)rr_json["used_geometry"];
@@ -1988,7 +2098,7 @@ void WorldSystem::loadGame()
 	{
 		json tower_json = tower_arr[i];
 		Entity e = Entity(tower_json["entity"]);
-		Tower &tower = registry.towers.emplace(e);
+		Tower &tower = registry().towers.emplace(e);
 		tower.health = tower_json["health"];
 		tower.damage = tower_json["damage"];
 		tower.range = tower_json["range"];
@@ -2002,8 +2112,7 @@ void WorldSystem::loadGame()
 	{
 		json zombie_json = zombie_arr[i];
 		Entity e = Entity(zombie_json["entity"]);
-		Zombie &zombie = registry.zombies.emplace(e);
-		zombie.health = zombie_json["health"];
+		registry().zombies.emplace(e);
 	}
 
 	json zombieSpawn_arr = jsonFile["11"];
@@ -2011,7 +2120,7 @@ void WorldSystem::loadGame()
 	{
 		json zombieSpawn_json = zombieSpawn_arr[i];
 		Entity e = Entity(zombieSpawn_json["entity"]);
-		ZombieSpawn &zombieSpawn = registry.zombieSpawns.emplace(e);
+		ZombieSpawn &zombieSpawn = registry().zombieSpawns.emplace(e);
 	}
 
 	json player_arr = jsonFile["12"];
@@ -2019,7 +2128,7 @@ void WorldSystem::loadGame()
 	{
 		json player_json = player_arr[i];
 		Entity e = Entity(player_json["entity"]);
-		Player &player = registry.players.emplace(e);
+		Player &player = registry().players.emplace(e);
 		player.health = player_json["health"];
 		player.health_max = player_json["health_max"];
 	}
@@ -2029,7 +2138,7 @@ void WorldSystem::loadGame()
 	{
 		json sc_json = sc_arr[i];
 		Entity e = Entity(sc_json["entity"]);
-		StatusComponent &sc = registry.statuses.emplace(e);
+		StatusComponent &sc = registry().statuses.emplace(e);
 		for (const auto &s : sc_json["active_statuses"])
 		{
 			Status status;
@@ -2045,7 +2154,7 @@ void WorldSystem::loadGame()
 	{
 		json state_json = states_arr[i];
 		Entity e = Entity(state_json["entity"]);
-		State &state = registry.states.emplace(e);
+		State &state = registry().states.emplace(e);
 		state.state = (STATE)state_json["state"];
 	}
 
@@ -2054,7 +2163,7 @@ void WorldSystem::loadGame()
 	{
 		json animation_json = animation_arr[i];
 		Entity e = Entity(animation_json["entity"]);
-		Animation &animation = registry.animations.emplace(e);
+		Animation &animation = registry().animations.emplace(e);
 		animation.runtime_ms = animation_json["runtime_ms"];
 		animation.timer_ms = animation_json["timer_ms"];
 		animation.pose = animation_json["pose"];
@@ -2071,7 +2180,7 @@ void WorldSystem::loadGame()
 	{
 		json death_json = death_arr[i];
 		Entity e = Entity(death_json["entity"]);
-		Death &death = registry.deaths.emplace(e);
+		Death &death = registry().deaths.emplace(e);
 	}
 
 	json cooldown_arr = jsonFile["17"];
@@ -2079,7 +2188,7 @@ void WorldSystem::loadGame()
 	{
 		json cooldown_json = cooldown_arr[i];
 		Entity e = Entity(cooldown_json["entity"]);
-		Cooldown &cooldown = registry.cooldowns.emplace(e);
+		Cooldown &cooldown = registry().cooldowns.emplace(e);
 		cooldown.timer_ms = cooldown_json["timer_ms"];
 	}
 
@@ -2088,7 +2197,7 @@ void WorldSystem::loadGame()
 	{
 		json da_json = da_arr[i];
 		Entity e = Entity(da_json["entity"]);
-		DeathAnimation &da = registry.deathAnimations.emplace(e);
+		DeathAnimation &da = registry().deathAnimations.emplace(e);
 		da.slide_direction = vec2(da_json["slide_direction"][0], da_json["slide_direction"][1]);
 		da.alpha = da_json["alpha"];
 		da.duration_ms = da_json["duration_ms"];
@@ -2099,7 +2208,7 @@ void WorldSystem::loadGame()
 	{
 		json he_json = he_arr[i];
 		Entity e = Entity(he_json["entity"]);
-		HitEffect &he = registry.hitEffects.emplace_with_duplicates(e);
+		HitEffect &he = registry().hitEffects.emplace_with_duplicates(e);
 		he.duration_ms = he_json["duration_ms"];
 		he.is_white = he_json["is_white"];
 	}
@@ -2110,7 +2219,7 @@ void WorldSystem::loadGame()
 		json projectile_json = projectile_arr[i];
 		Entity e = Entity(projectile_json["entity"]);
 		Entity source = Entity(projectile_json["source"]);
-		Projectile &p = registry.projectiles.emplace(e);
+		Projectile &p = registry().projectiles.emplace(e);
 		p.source = source;
 		p.damage = projectile_json["damage"];
 		p.speed = projectile_json["speed"];
@@ -2124,7 +2233,7 @@ void WorldSystem::loadGame()
 	{
 		json camera_json = camera_arr[i];
 		Entity e = Entity(camera_json["entity"]);
-		Camera &camera = registry.cameras.emplace(e);
+		Camera &camera = registry().cameras.emplace(e);
 		camera.position = vec2(camera_json["position"][0], camera_json["position"][1]);
 		camera.camera_width = camera_json["camera_width"];
 		camera.camera_height = camera_json["camera_height"];
@@ -2137,7 +2246,7 @@ void WorldSystem::loadGame()
 		json skeleton_json = skeleton_arr[i];
 		Entity e = Entity(skeleton_json["entity"]);
 		Entity target = Entity(skeleton_json["target"]);
-		Skeleton &skeleton = registry.skeletons.emplace(e);
+		Skeleton &skeleton = registry().skeletons.emplace(e);
 		skeleton.attack_range = skeleton_json["attack_range"];
 		skeleton.stop_distance = skeleton_json["stop_distance"];
 		skeleton.attack_cooldown_ms = skeleton_json["attack_cooldown_ms"];
@@ -2156,7 +2265,7 @@ void WorldSystem::loadGame()
 		json arrow_json = arrow_arr[i];
 		Entity e = Entity(arrow_json["entity"]);
 		Entity source = Entity(arrow_json["source"]);
-		Arrow &a = registry.arrows.emplace(e);
+		Arrow &a = registry().arrows.emplace(e);
 		a.source = source;
 		a.damage = arrow_json["damage"];
 		a.speed = arrow_json["speed"];
@@ -2169,7 +2278,7 @@ void WorldSystem::loadGame()
 	{
 		json visualScale_json = visualScale_arr[i];
 		Entity e = Entity(visualScale_json["entity"]);
-		VisualScale &vs = registry.visualScales.emplace(e);
+		VisualScale &vs = registry().visualScales.emplace(e);
 		vs.scale = vec2(visualScale_json["scale"][0], visualScale_json["scale"][1]);
 	}
 
@@ -2178,7 +2287,7 @@ void WorldSystem::loadGame()
 	{
 		json enemies_json = enemies_arr[i];
 		Entity e = Entity(enemies_json["entity"]);
-		Enemy &enemy = registry.enemies.emplace(e);
+		Enemy &enemy = registry().enemies.emplace(e);
 		enemy.health = enemies_json["health"];
 		enemy.speed = enemies_json["speed"];
 	}
@@ -2188,7 +2297,7 @@ void WorldSystem::loadGame()
 	{
 		json inventory_json = inventory_arr[i];
 		Entity e = Entity(inventory_json["entity"]);
-		Inventory &in = registry.inventorys.emplace(e);
+		Inventory &in = registry().inventorys.emplace(e);
 		json seed_arr = inventory_json["seedCount"];
 		json seed_position_arr = inventory_json["seedPosition"];
 		json seed_at_toolbar_arr = inventory_json["seedAtToolbar"];
@@ -2205,7 +2314,7 @@ void WorldSystem::loadGame()
 	{
 		json seed_json = seed_arr[i];
 		Entity e = Entity(seed_json["entity"]);
-		Seed &seed = registry.seeds.emplace(e);
+		Seed &seed = registry().seeds.emplace(e);
 		seed.type = seed_json["type"];
 		seed.timer = seed_json["timer"];
 	}
@@ -2215,7 +2324,7 @@ void WorldSystem::loadGame()
 	{
 		json mvc_json = mvc_arr[i];
 		Entity e = Entity(mvc_json["entity"]);
-		registry.moveWithCameras.emplace(e);
+		registry().moveWithCameras.emplace(e);
 	}
 
 	json mt_arr = jsonFile["29"];
@@ -2223,7 +2332,7 @@ void WorldSystem::loadGame()
 	{
 		json mt_json = mt_arr[i];
 		Entity e = Entity(mt_json["entity"]);
-		registry.mapTiles.emplace(e);
+		registry().mapTiles.emplace(e);
 	}
 
 	json plant_animation_arr = jsonFile["35"];
@@ -2231,7 +2340,7 @@ void WorldSystem::loadGame()
 	{
 		json plant_animation_json = plant_animation_arr[i];
 		Entity e = Entity(plant_animation_json["entity"]);
-		PlantAnimation &plant_animation = registry.plantAnimations.emplace(e);
+		PlantAnimation &plant_animation = registry().plantAnimations.emplace(e);
 		plant_animation.id = plant_animation_json["id"];
 	}
 
@@ -2240,7 +2349,7 @@ void WorldSystem::loadGame()
 	{
 		json orc_rider_json = orc_rider_arr[i];
 		Entity e = Entity(orc_rider_json["entity"]);
-		OrcRider &orc_rider = registry.orcRiders.emplace(e);
+		OrcRider &orc_rider = registry().orcRiders.emplace(e);
 		orc_rider.current_state = orc_rider_json["current_state"];
 		orc_rider.target = Entity(orc_rider_json["target"]);
 		orc_rider.detection_range = orc_rider_json["detection_range"];
@@ -2262,7 +2371,7 @@ void WorldSystem::loadGame()
 	{
 		json squad_json = squad_arr[i];
 		Entity e = Entity(squad_json["entity"]);
-		Squad &squad = registry.squads.emplace(e);
+		Squad &squad = registry().squads.emplace(e);
 		squad.squad_id = squad_json["squad_id"];
 		squad.formation_center = vec2(squad_json["formation_center"][0], squad_json["formation_center"][1]);
 		squad.last_player_pos = vec2(squad_json["last_player_pos"][0], squad_json["last_player_pos"][1]);
@@ -2281,7 +2390,7 @@ void WorldSystem::loadGame()
 	{
 		json slow_effect_json = slow_effect_arr[i];
 		Entity e = Entity(slow_effect_json["entity"]);
-		Slow &slow = registry.slowEffects.emplace(e);
+		Slow &slow = registry().slowEffects.emplace(e);
 		slow.value = slow_effect_json["value"];
 		slow.timer_ms = slow_effect_json["timer_ms"];
 	}
@@ -2291,14 +2400,14 @@ void WorldSystem::loadGame()
 	{
 		json electricity_json = electricity_arr[i];
 		Entity e = Entity(electricity_json["entity"]);
-		ElectricityData &electricity = registry.customData.emplace(e);
+		ElectricityData &electricity = registry().customData.emplace(e);
 		electricity.noise_seed = electricity_json["noise_seed"];
 		electricity.curve_ctrl1 = vec2(electricity_json["curve_ctrl1"][0], electricity_json["curve_ctrl1"][1]);
 		electricity.curve_ctrl2 = vec2(electricity_json["curve_ctrl2"][0], electricity_json["curve_ctrl2"][1]);
 	}
 
-	Entity &player_entity = registry.players.entities[0];
-	vec2 player_pos = registry.motions.get(player_entity).position;
+	Entity &player_entity = registry().players.entities[0];
+	vec2 player_pos = registry().motions.get(player_entity).position;
 	clearButtons();
 	createPause(vec2(player_pos.x - CAMERA_VIEW_WIDTH / 2 + 30, player_pos.y - CAMERA_VIEW_HEIGHT / 2 + 30), BUTTON_ID::PAUSE);
 
@@ -2308,30 +2417,30 @@ void WorldSystem::loadGame()
 void WorldSystem::saveGame()
 {
 	clearButtons();
-	game_screen = GAME_SCREEN_ID::PLAYING;
+	world().game_screen = GAME_SCREEN_ID::PLAYING;
 
-	if (registry.meshPtrs.size() > 0)
+	if (registry().meshPtrs.size() > 0)
 	{
 		std::cout << "Chicken summoned, cannot save, please give it some time to fly." << std::endl;
 		return;
 	}
-	if (game_screen == GAME_SCREEN_ID::CG)
+	if (world().game_screen == GAME_SCREEN_ID::CG)
 	{
 		std::cout << "Finish the cutscene before trying to save." << std::endl;
 		return;
 	}
 	json jsonFile;
-	jsonFile["game_is_over"] = game_is_over;
-	jsonFile["game_screen"] = game_screen;
-	jsonFile["current_day"] = current_day;
+	jsonFile["game_is_over"] = world().game_is_over;
+	jsonFile["game_screen"] = world().game_screen;
+	jsonFile["current_day"] = world().current_day;
 	jsonFile["current_seed"] = current_seed;
 	jsonFile["level"] = level;
-	jsonFile["id_count"] = Entity::get_id_count();
+	jsonFile["id_count"] = registry().entities.get_id_count();
 
-	for (int i = 0; i < registry.registry_list.size(); i++)
+	registry().for_each_container([&](auto &container, size_t i)
 	{
-		jsonFile[std::to_string(i)] = registry.registry_list[i]->toJSON();
-	}
+		jsonFile[std::to_string(i)] = container.toJSON();
+	});
 
 	std::ofstream outFile(PROJECT_SOURCE_DIR + std::string("data/reload/game_0.json"));
 	if (outFile.is_open())
@@ -2349,8 +2458,8 @@ void WorldSystem::saveGame()
 void WorldSystem::plant_seed()
 {
 	// Get player's motion component
-	Entity player = registry.players.entities[0];
-	Motion &motion = registry.motions.get(player);
+	Entity player = registry().players.entities[0];
+	Motion &motion = registry().motions.get(player);
 
 	// Calculate player's current cell for proximity checking
 	int cell_x = static_cast<int>((motion.position.x + GRID_CELL_WIDTH_PX / 2) / GRID_CELL_WIDTH_PX);
@@ -2361,14 +2470,14 @@ void WorldSystem::plant_seed()
 	Entity closest_farmland = NULL;
 	float closest_distance = GRID_CELL_WIDTH_PX; // Max distance to consider
 
-	for (Entity tile : registry.mapTiles.entities)
+	for (Entity tile : registry().mapTiles.entities)
 	{
 		// Check if tile is farmland
-		if (registry.motions.has(tile) &&
-			registry.renderRequests.has(tile) &&
-			registry.renderRequests.get(tile).used_texture == DECORATION_LIST[6])
+		if (registry().motions.has(tile) &&
+			registry().renderRequests.has(tile) &&
+			registry().renderRequests.get(tile).used_texture == DECORATION_LIST[6])
 		{
-			vec2 farmland_pos = registry.motions.get(tile).position;
+			vec2 farmland_pos = registry().motions.get(tile).position;
 			float distance = length(farmland_pos - grid_center);
 
 			// Check if this is closer than previous matches
@@ -2376,10 +2485,10 @@ void WorldSystem::plant_seed()
 			{
 				// Check if tile is already occupied by a seed or tower
 				bool is_occupied = false;
-				for (Entity entity : registry.motions.entities)
+				for (Entity entity : registry().motions.entities)
 				{
-					if ((registry.seeds.has(entity) || registry.towers.has(entity)) &&
-						length(registry.motions.get(entity).position - farmland_pos) < 10.0f)
+					if ((registry().seeds.has(entity) || registry().towers.has(entity)) &&
+						length(registry().motions.get(entity).position - farmland_pos) < 10.0f)
 					{
 						is_occupied = true;
 						break;
@@ -2398,30 +2507,30 @@ void WorldSystem::plant_seed()
 	// If we found valid farmland, plant a seed
 	if (closest_farmland != NULL)
 	{
-		vec2 farmland_pos = registry.motions.get(closest_farmland).position;
+		vec2 farmland_pos = registry().motions.get(closest_farmland).position;
 
 		// Check if player has seeds available
-		if (registry.inventorys.components[0].seedCount[current_seed] > 0)
+		if (registry().inventorys.components[0].seedCount[current_seed] > 0)
 		{
 			// Plant the seed at the exact farmland position
 			Entity seed = createSeed(farmland_pos, current_seed);
-			registry.inventorys.components[0].seedCount[current_seed]--;
+			registry().inventorys.components[0].seedCount[current_seed]--;
 
 			// If that was the last seed of this type, remove it from toolbar
-			if (registry.inventorys.components[0].seedCount[current_seed] == 0)
+			if (registry().inventorys.components[0].seedCount[current_seed] == 0)
 			{
-				for (Entity seed_entity : registry.seeds.entities)
+				for (Entity seed_entity : registry().seeds.entities)
 				{
-					if (registry.moveWithCameras.has(seed_entity) &&
-						registry.seeds.get(seed_entity).type == current_seed)
+					if (registry().moveWithCameras.has(seed_entity) &&
+						registry().seeds.get(seed_entity).type == current_seed)
 					{
-						registry.remove_all_components_of(seed_entity);
+						registry().remove_all_components_of(seed_entity);
 						break;
 					}
 				}
 			}
 
-			std::cout << "Planted seed. Remaining: " << registry.inventorys.components[0].seedCount[current_seed] << std::endl;
+			std::cout << "Planted seed. Remaining: " << registry().inventorys.components[0].seedCount[current_seed] << std::endl;
 		}
 		else
 		{
@@ -2437,33 +2546,33 @@ void WorldSystem::plant_seed()
 
 void WorldSystem::update_dash(float elapsed_ms_since_last_update)
 {
-	if (player_is_dashing)
+	if (world().player_is_dashing)
 	{
 		dash_timer_ms -= elapsed_ms_since_last_update;
 
 		if (dash_timer_ms <= 0)
 		{
 			// End the dash
-			player_is_dashing = false;
+			world().player_is_dashing = false;
 			dash_timer_ms = 0.0f;
 			dash_cooldown_ms = PLAYER_DASH_COOLDOWN_MS;
 
 			// Reset velocities to zero
-			for (Entity mwc_entity : registry.moveWithCameras.entities)
+			for (Entity mwc_entity : registry().moveWithCameras.entities)
 			{
-				if (registry.motions.has(mwc_entity))
+				if (registry().motions.has(mwc_entity))
 				{
-					Motion &mwc_motion = registry.motions.get(mwc_entity);
+					Motion &mwc_motion = registry().motions.get(mwc_entity);
 					mwc_motion.velocity = vec2(0.0f, 0.0f);
 
 					// Re-apply velocity for any keys that are still being pressed
-					if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+					if (is_key_down(GLFW_KEY_W))
 						mwc_motion.velocity.y += PLAYER_MOVE_UP_SPEED;
-					if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+					if (is_key_down(GLFW_KEY_S))
 						mwc_motion.velocity.y += PLAYER_MOVE_DOWN_SPEED;
-					if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+					if (is_key_down(GLFW_KEY_A))
 						mwc_motion.velocity.x += PLAYER_MOVE_LEFT_SPEED;
-					if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+					if (is_key_down(GLFW_KEY_D))
 						mwc_motion.velocity.x += PLAYER_MOVE_RIGHT_SPEED;
 				}
 			}
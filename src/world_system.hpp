@@ -2,9 +2,11 @@
 
 	// internal
 	#include "common.hpp"
+	#include "motion_kernels.hpp"
 	#include "spawn_manager.hpp"
 
 	// stlib
+	#include <functional>
 	#include <vector>
 	#include <random>
 
@@ -13,6 +15,8 @@
 	#include <SDL_mixer.h>
 
 	#include "render_system.hpp"
+	#include "replay.hpp"
+	#include "world.hpp"
 
 	// Container for all our entities and game logic.
 	// Individual rendering / updates are deferred to the update() methods.
@@ -38,19 +42,22 @@
 	// starts the game
 	void init(RenderSystem *renderer);
 	void restart_splash_screen();
+	// Starts a new game on day, as the end of the intro does but without the splash screen and the
+	// intro, for runs with no player at the controls (see wave_sim/)
+	void start_game(int day = 1);
 
 	// releases all associated resources
 	~WorldSystem();
 
-	// Returns the game_screen (inspired by Assignment #2)
+	// Returns the game_screen of the current world (inspired by Assignment #2)
 	static GAME_SCREEN_ID get_game_screen()
 	{
-		return game_screen;
+		return world().game_screen;
 	}
 
 	static void set_game_screen(GAME_SCREEN_ID gs)
 	{
-		game_screen = gs;
+		world().game_screen = gs;
 	}
 
 	// steps the game ahead by ms milliseconds
@@ -60,7 +67,6 @@
 	bool is_over() const;
 
 	void game_over();
-	static bool game_is_over;
 	unsigned int current_seed; // current type of seed the player has selected
 	// Current experience level of the player
 	unsigned int level;
@@ -71,15 +77,19 @@
 	static void increase_exp();
 	void increase_level();
 
-	static int get_current_day() { return current_day; }
-
-	static bool player_is_dashing;
+	static int get_current_day() { return world().current_day; }
 
 	void increment_points();
 
-private:
-	static int current_day;
+	// Applies one input event: updates the held keys, then calls the input callback it is for.
+	// Events from the window come through here, and so do replayed ones
+	void handle_input(const InputEvent &event);
+	// Sees each event from the window before it is handled and may change it; returning false drops it
+	std::function<bool(InputEvent &)> input_filter;
+	// Whether key is held down, going by the events handled so far
+	bool is_key_down(int key) const;
 
+private:
 	float mouse_pos_x = 0.0f;
 	float mouse_pos_y = 0.0f;
 
@@ -91,6 +101,10 @@ private:
 	void player_movement(int key, int action, Motion &player_motion);
 	void player_movement_tutorial(int key, int action, Motion &player_motion);
 
+	// keys held down, by GLFW key code
+	bool keys_down[GLFW_KEY_LAST + 1] = {};
+	void on_window_input(InputEvent event);
+
 	// input callback functions
 	void on_key(int key, int, int action, int mod);
 	void on_mouse_move(vec2 pos);
@@ -107,9 +121,6 @@ private:
 	// OpenGL window handle
 	GLFWwindow *window;
 
-	// game_screen (inspired by Assignment #2)
-	static GAME_SCREEN_ID game_screen;
-
 	// Game state
 	RenderSystem *renderer;
 	float current_speed;
@@ -117,6 +128,12 @@ private:
 	// grid
 	std::vector<Entity> grid_lines;
 
+	// enemies the sword may hit, reused every attack
+	std::vector<Entity> attack_targets;
+	std::vector<OrderKey> attack_order;
+	CircleBatch attack_batch;		  // their bounding circles
+	std::vector<uint64_t> weapon_hits; // which of them the weapon hit
+
 	// music references
 	Mix_Music *current_bgm; // handle switching soundtrack
 	Mix_Music *night_bgm;